@@ -35,10 +35,16 @@ class fhel(ConanFile):
   exports_sources = "src/*", "include/*", "test/*", "CMakeLists.txt"
   options = {
     "ci": [True, False],
+    "lto": [True, False],
+    "native_arch": [True, False],
+    "bundled": [True, False],
   }
 
   default_options = {
     "ci": False,
+    "lto": False,
+    "native_arch": False,
+    "bundled": False,
   }
 
   def set_version(self):
@@ -57,6 +63,9 @@ class fhel(ConanFile):
   def generate(self):
     "Generate the cmake toolchain file"
     tc = CMakeToolchain(self)
+    tc.cache_variables["FHEL_ENABLE_LTO"] = bool(self.options.lto)
+    tc.cache_variables["FHEL_NATIVE_ARCH"] = bool(self.options.native_arch)
+    tc.cache_variables["FHEL_BUNDLED"] = bool(self.options.bundled)
     tc.generate()
 
   def seal_negative_args(self) -> list[str]:
@@ -0,0 +1,36 @@
+// Measures Ciphertext serialization throughput across the FFI boundary.
+//
+// Usage: dart run benchmark/serialization.dart
+import 'package:fhel/afhe.dart' show Ciphertext;
+import 'package:fhel/seal.dart' show Seal;
+
+const iterations = 50;
+
+/// Returns the throughput of [op] in MB/s, for [bytes] processed per call.
+double throughput(int bytes, void Function() op) {
+  op(); // warm up
+  final watch = Stopwatch()..start();
+  for (var i = 0; i < iterations; i++) {
+    op();
+  }
+  watch.stop();
+  final seconds = watch.elapsedMicroseconds / 1e6;
+  return bytes * iterations / seconds / (1024 * 1024);
+}
+
+void main() {
+  for (final degree in [4096, 8192, 16384]) {
+    final fhe = Seal('bfv');
+    fhe.genContext({'polyModDegree': degree, 'ptModBit': 20, 'secLevel': 128});
+    fhe.genKeys();
+
+    final ct = fhe.encrypt(fhe.encodeVecInt([1, 2, 3, 4]));
+    final bytes = ct.toBytes();
+
+    final save = throughput(bytes.length, () => ct.toBytes());
+    final load = throughput(bytes.length, () => Ciphertext.fromBytes(fhe, bytes));
+    print('n=$degree size=${bytes.length} B '
+        'save=${save.toStringAsFixed(1)} MB/s '
+        'load=${load.toStringAsFixed(1)} MB/s');
+  }
+}
@@ -5,7 +5,9 @@
 ///
 library afhe;
 
+import 'dart:async'; // For Completer
 import 'dart:ffi';
+import 'dart:isolate'; // For FhePool
 import 'dart:typed_data'; // For Uint8List
 import 'package:ffi/ffi.dart'; // for Utf8
 import 'dart:io' show Directory, Platform;
@@ -22,6 +24,10 @@ part 'afhe/crypto.dart';
 part 'afhe/codec.dart';
 part 'afhe/errors.dart';
 part 'afhe/key.dart';
+part 'afhe/packing.dart';
+part 'afhe/matrix.dart';
+part 'afhe/key_cache.dart';
+part 'afhe/pool.dart';
 
 /// Abstract Fully Homomorphic Encryption
 ///
@@ -60,8 +66,25 @@ class Afhe {
     scheme = Scheme();
   }
 
+  /// Shares an existing native backend, by the [address] of its [library].
+  ///
+  /// The context and keys are not copied, so the backend is set up once and
+  /// used from several isolates, see [FhePool]. The original [Afhe] owns the backend.
+  Afhe.fromAddress(String backendName, String schemeName, int address) {
+    backend = Backend.set(backendName);
+    scheme = schemeName.isEmpty ? Scheme() : Scheme.set(schemeName);
+    library = Pointer.fromAddress(address);
+  }
+
   /// Generates a context for the Brakerski-Fan-Vercauteren (BFV) scheme.
+  ///
+  /// The optional `qSizes` selects a custom coefficient modulus chain,
+  /// otherwise the default chain for the security level is used.
   String _contextBFV(Map context) {
+    if (context['qSizes'] != null && context['qSizes'] is! List<int>) {
+      throw ArgumentError('qSizes must be a list of integers');
+    }
+    List<int> primeSizes = context['qSizes'] ?? <int>[];
     final ptr = _c_gen_context(
         library,
         scheme.value,
@@ -69,8 +92,8 @@ class Afhe {
         context['ptModBit'] ?? 0, // Only used when batching
         context['ptMod'] ?? 0, // Not used when batching
         context['secLevel'],
-        nullptr,
-        0);
+        primeSizes.isEmpty ? nullptr : intListToUint64Array(primeSizes),
+        primeSizes.length);
     raiseForStatus();
     return ptr.toDartString();
   }
@@ -110,6 +133,7 @@ class Afhe {
   ///
   /// The [context] is a map of parameters used to generate the encryption context for the [Scheme].
   String genContext(Map context) {
+    if (context['prng'] != null) setPrng(context['prng']);
     return switch (scheme.name) {
       "bfv" => _contextBFV(context),
       "bgv" => _contextBGV(context),
@@ -122,15 +146,56 @@ class Afhe {
   ///
   /// Used for generating a shared session.
   String genContextFromParameters(Map parameters) {
+    if (parameters['prng'] != null) setPrng(parameters['prng']);
     final ptr = _c_gen_context_from_str(
         library, parameters['header'], parameters['size']);
     raiseForStatus();
     return ptr.toDartString();
   }
 
+  /// Selects the pseudo-random number generator used by encryption and key generation.
+  ///
+  /// One of "default", "blake2xb" or "shake256"; applies to contexts generated
+  /// afterwards. Also set by the optional `prng` entry of the [genContext] map.
+  void setPrng(String name) {
+    final str = name.toNativeUtf8();
+    final prng = _c_string_to_prng_type(str);
+    calloc.free(str);
+    raiseForStatus();
+    _c_set_prng(library, prng);
+    raiseForStatus();
+  }
+
   /// Returns the number of slots based on parameters.
   int get slotCount => _c_slot_count(library);
 
+  /// Sets the number of released ciphertexts and plaintexts each kept for reuse.
+  ///
+  /// Zero deletes every released object.
+  set poolCapacity(int capacity) {
+    _c_set_pool_capacity(library, capacity);
+    raiseForStatus();
+  }
+
+  /// Releases the [Ciphertext], recycled for the results of later operations.
+  ///
+  /// Results of the same shape are then written without reallocating;
+  /// the [ciphertext] must not be used afterwards.
+  void release(Ciphertext ciphertext) {
+    _c_delete_ciphertext(library, ciphertext.obj);
+    ciphertext.obj = nullptr;
+    raiseForStatus();
+  }
+
+  /// Releases the [Plaintext], cleared and recycled for the results of later operations.
+  ///
+  /// The [plaintext] must not be used afterwards.
+  void releasePlaintext(Plaintext plaintext) {
+    _c_delete_plaintext(library, plaintext.obj);
+    plaintext.obj = nullptr;
+    raiseForStatus();
+  }
+
   /// Returns the string representation of FHE parameters.
   ///
   /// Useful for saving to disk or sending over the network.
@@ -160,6 +225,18 @@ class Afhe {
     raiseForStatus();
   }
 
+  /// Generates the Galois keys used to rotate a [Ciphertext].
+  ///
+  /// Keys are generated for each of the rotation [steps]; when empty,
+  /// for every power of two, from which any rotation is composed.
+  /// Requires the secret key to be generated first via genKeys().
+  void genGaloisKeys([List<int> steps = const []]) {
+    final ptr = intListToArray(steps);
+    _c_gen_galois_keys(library, ptr, steps.length);
+    calloc.free(ptr);
+    raiseForStatus();
+  }
+
   /// Fetch the public key.
   Key get publicKey => Key("public", _c_get_public_key(library));
 
@@ -169,6 +246,18 @@ class Afhe {
   /// Fetch the relinearization keys.
   Key get relinKeys => Key("relin", _c_get_relin_keys(library));
 
+  /// Fetch the Galois keys.
+  Key get galoisKeys => Key("galois", _c_get_galois_keys(library));
+
+  /// Installs a loaded [Key], e.g. evaluation keys received from a client.
+  ///
+  /// The contents of the native key are moved into the backend, without copying;
+  /// the [key] is left empty.
+  void setKey(Key key) {
+    _c_set_key(key.type, library, key.obj);
+    raiseForStatus();
+  }
+
   /// Encrypts the plaintext message.
   Ciphertext encrypt(Plaintext plaintext) {
     final ptr = _c_encrypt(library, plaintext.obj);
@@ -176,6 +265,28 @@ class Afhe {
     return Ciphertext.fromPointer(backend, ptr);
   }
 
+  /// Encrypts every [Plaintext] in [plaintexts], in a single native call.
+  ///
+  /// Returns one [Ciphertext] per plaintext, encrypted concurrently.
+  List<Ciphertext> encryptMany(List<Plaintext> plaintexts) {
+    final arr = calloc<Pointer>(plaintexts.length);
+    final out = calloc<Pointer>(plaintexts.length);
+    try {
+      for (var i = 0; i < plaintexts.length; i++) {
+        arr[i] = plaintexts[i].obj;
+      }
+      final status = _c_encrypt_many(library, arr, plaintexts.length, out);
+      if (status != 0) raiseForStatus();
+      return [
+        for (var i = 0; i < plaintexts.length; i++)
+          Ciphertext.fromPointer(backend, out[i])
+      ];
+    } finally {
+      calloc.free(arr);
+      calloc.free(out);
+    }
+  }
+
   /// Decrypts the ciphertext message.
   Plaintext decrypt(Ciphertext ciphertext) {
     Pointer ptr = _c_decrypt(library, ciphertext.obj);
@@ -188,6 +299,52 @@ class Afhe {
     return Plaintext.fromPointer(backend, ptr);
   }
 
+  /// Encodes and encrypts a list of integers in a single native call.
+  Ciphertext encryptVecInt(List<int> vec) {
+    final arr = intListToUint64Array(vec);
+    final ptr = _c_encrypt_ints(library, arr, vec.length);
+    calloc.free(arr);
+    raiseForStatus();
+    return Ciphertext.fromPointer(backend, ptr);
+  }
+
+  /// Encodes and encrypts a list of doubles in a single native call.
+  Ciphertext encryptVecDouble(List<double> vec) {
+    final arr = doubleListToArray(vec);
+    final ptr = _c_encrypt_doubles(library, arr, vec.length);
+    calloc.free(arr);
+    raiseForStatus();
+    return Ciphertext.fromPointer(backend, ptr);
+  }
+
+  /// Decrypts and decodes the [Ciphertext] into a list of integers.
+  ///
+  /// The list is a view over native memory, owned by the list.
+  List<int> decryptVecInt(Ciphertext ciphertext, int arrayLength) {
+    final ptr = malloc<Uint64>(arrayLength);
+    final written =
+        _c_decrypt_ints_into(library, ciphertext.obj, ptr, arrayLength);
+    if (written < 0) {
+      malloc.free(ptr);
+      raiseForStatus();
+    }
+    return ptr.asTypedList(written, finalizer: malloc.nativeFree);
+  }
+
+  /// Decrypts and decodes the [Ciphertext] into a list of doubles.
+  ///
+  /// The list is a view over native memory, owned by the list.
+  List<double> decryptVecDouble(Ciphertext ciphertext, int arrayLength) {
+    final ptr = malloc<Double>(arrayLength);
+    final written =
+        _c_decrypt_doubles_into(library, ciphertext.obj, ptr, arrayLength);
+    if (written < 0) {
+      malloc.free(ptr);
+      raiseForStatus();
+    }
+    return ptr.asTypedList(written, finalizer: malloc.nativeFree);
+  }
+
   /// Returns the invariant noise budget of the [Ciphertext].
   int invariantNoiseBudget(Ciphertext ciphertext) {
     int n = _c_invariant_noise_budget(library, ciphertext.obj);
@@ -195,6 +352,19 @@ class Afhe {
     return n;
   }
 
+  /// Estimates the noise budget of the [Ciphertext], without the secret key.
+  ///
+  /// Tracked through every operation from the encryption parameters alone;
+  /// a conservative estimate of invariantNoiseBudget for BFV/BGV [Scheme],
+  /// and the bits of precision left for CKKS [Scheme].
+  /// Returns -1 for a [Ciphertext] not tracked since its encryption,
+  /// e.g. a loaded one or a result computed from it.
+  int estimateNoiseBudget(Ciphertext ciphertext) {
+    int n = _c_estimate_noise_budget(library, ciphertext.obj);
+    raiseForStatus();
+    return n;
+  }
+
   /// Loads a [Ciphertext] from a non-human-readable format.
   ///
   /// Useful for loading from disk or receiving over the network.
@@ -208,17 +378,18 @@ class Afhe {
 
   /// Encodes a list of integers into a [Plaintext].
   Plaintext encodeVecInt(List<int> vec) {
-    Pointer ptr =
-        _c_encode_vector_int(library, intListToUint64Array(vec), vec.length);
+    final arr = intListToUint64Array(vec);
+    Pointer ptr = _c_encode_vector_int(library, arr, vec.length);
+    calloc.free(arr);
     raiseForStatus();
     return Plaintext.fromPointer(backend, ptr);
   }
 
   /// Decodes a [Plaintext] into a list of integers.
+  ///
+  /// The list is a view over native memory, decoded without intermediate copies.
   List<int> decodeVecInt(Plaintext plaintext, int arrayLength) {
-    Pointer<Uint64> ptr = _c_decode_vector_int(library, plaintext.obj);
-    raiseForStatus();
-    return uint64ArrayToIntList(ptr, arrayLength);
+    return decodeIntView(library, plaintext.obj, arrayLength);
   }
 
   /// Encodes a double into a [Plaintext].
@@ -231,8 +402,9 @@ class Afhe {
 
   /// Encodes a list of doubles into a [Plaintext].
   Plaintext encodeVecDouble(List<double> vec) {
-    Pointer ptr =
-        _c_encode_vector_double(library, doubleListToArray(vec), vec.length);
+    final arr = doubleListToArray(vec);
+    Pointer ptr = _c_encode_vector_double(library, arr, vec.length);
+    calloc.free(arr);
     raiseForStatus();
     // String cannot be extracted from C object for CKKS
     return Plaintext.fromPointer(backend, ptr, extractStr: false);
@@ -240,16 +412,46 @@ class Afhe {
 
   /// Decodes a [Plaintext] into a double.
   double decodeDouble(Plaintext plaintext) {
-    Pointer<Double> ptr = _c_decode_vector_double(library, plaintext.obj);
-    raiseForStatus();
-    return ptr[0];
+    return decodeDoubleView(library, plaintext.obj, 1)[0];
   }
 
   /// Decodes a [Plaintext] into a list of doubles.
+  ///
+  /// The list is a view over native memory, decoded without intermediate copies.
   List<double> decodeVecDouble(Plaintext plaintext, int arrayLength) {
-    Pointer<Double> ptr = _c_decode_vector_double(library, plaintext.obj);
+    return decodeDoubleView(library, plaintext.obj, arrayLength);
+  }
+
+  /// Encodes complex numbers into a [Plaintext].
+  ///
+  /// The [interleaved] list holds (real, imaginary) pairs, so its length is
+  /// twice the number of complex numbers. Two real vectors can share one
+  /// plaintext by using one as the real parts and the other as the imaginary parts.
+  Plaintext encodeVecComplex(Float64List interleaved) {
+    if (interleaved.length.isOdd) {
+      throw ArgumentError('Interleaved complex list must have an even length');
+    }
+    final arr = malloc<Double>(interleaved.length);
+    arr.asTypedList(interleaved.length).setAll(0, interleaved);
+    Pointer ptr =
+        _c_encode_complex(library, arr, interleaved.length ~/ 2);
+    malloc.free(arr);
     raiseForStatus();
-    return arrayToDoubleList(ptr, arrayLength);
+    // String cannot be extracted from C object for CKKS
+    return Plaintext.fromPointer(backend, ptr, extractStr: false);
+  }
+
+  /// Decodes a [Plaintext] into [length] complex numbers.
+  ///
+  /// Returns interleaved (real, imaginary) pairs, as a view over native memory.
+  Float64List decodeVecComplex(Plaintext plaintext, int length) {
+    final ptr = malloc<Double>(2 * length);
+    final written = _c_decode_complex_into(library, plaintext.obj, ptr, length);
+    if (written < 0) {
+      malloc.free(ptr);
+      raiseForStatus();
+    }
+    return ptr.asTypedList(2 * written, finalizer: malloc.nativeFree);
   }
 
   /// Relinearizes the [Ciphertext].
@@ -269,6 +471,75 @@ class Afhe {
     return ciphertext;
   }
 
+  /// Modulus switches the [Ciphertext] down to [level], see [level].
+  ///
+  /// Operations at lower levels are cheaper, see [levelCosts].
+  Ciphertext modSwitchToLevel(Ciphertext ciphertext, int level) {
+    final status = _c_mod_switch_to_level(library, ciphertext.obj, level);
+    if (status != 0) raiseForStatus();
+    return ciphertext;
+  }
+
+  /// Rescales the [Ciphertext] to the next lower level.
+  ///
+  /// Only supported for CKKS [Scheme]; divides the scale by the dropped prime.
+  Ciphertext rescaleToNext(Ciphertext ciphertext) {
+    _c_rescale_next(library, ciphertext.obj);
+    raiseForStatus();
+    return ciphertext;
+  }
+
+  /// Returns the level of the [Ciphertext], the number of levels dropped since encryption.
+  int level(Ciphertext ciphertext) {
+    final level = _c_get_ciphertext_level(library, ciphertext.obj);
+    if (level < 0) raiseForStatus();
+    return level;
+  }
+
+  /// Returns the index of the [Ciphertext]'s parameters in the modulus chain,
+  /// the number of levels left to drop.
+  int chainIndex(Ciphertext ciphertext) {
+    final index = _c_get_chain_index(library, ciphertext.obj);
+    if (index < 0) raiseForStatus();
+    return index;
+  }
+
+  /// Returns the number of primes in the [Ciphertext]'s coefficient modulus.
+  int coeffModulusCount(Ciphertext ciphertext) {
+    final count = _c_get_coeff_modulus_count(library, ciphertext.obj);
+    if (count < 0) raiseForStatus();
+    return count;
+  }
+
+  /// Returns the size and relative cost of operations at each level, indexed by [level].
+  List<LevelCost> get levelCosts {
+    final count = _c_get_level_count(library);
+    if (count < 0) raiseForStatus();
+    final ptr = calloc<Double>(4 * count);
+    try {
+      final written = _c_get_level_costs(library, ptr, 4 * count);
+      if (written < 0) raiseForStatus();
+      return [
+        for (var i = 0; i < written; i++)
+          LevelCost(ptr[4 * i].toInt(), ptr[4 * i + 1], ptr[4 * i + 2], ptr[4 * i + 3])
+      ];
+    } finally {
+      calloc.free(ptr);
+    }
+  }
+
+  /// Modulus switches the [Ciphertext] to the lowest level that still decrypts correctly.
+  ///
+  /// Shrinks the serialized size, for ciphertexts sent back without further computation.
+  /// Keeps [minBudget] bits of estimated noise budget, see estimateNoiseBudget().
+  /// Throws for a BFV/BGV [Ciphertext] whose noise is unknown, e.g. a loaded one.
+  /// Returns the number of levels dropped.
+  int compactForTransfer(Ciphertext ciphertext, {int minBudget = 1}) {
+    int levels = _c_compact_for_transfer(library, ciphertext.obj, minBudget);
+    raiseForStatus();
+    return levels;
+  }
+
   /// Adds two [Ciphertext]s.
   Ciphertext add(Ciphertext a, Ciphertext b) {
     Pointer ptr = _c_add(library, a.obj, b.obj);
@@ -276,6 +547,11 @@ class Afhe {
     return Ciphertext.fromPointer(backend, ptr);
   }
 
+  /// Adds every [Ciphertext] in [ctxts], in a single native call.
+  Ciphertext addMany(List<Ciphertext> ctxts) {
+    return _reduceMany(_c_add_many, ctxts);
+  }
+
   /// Adds value of [Plaintext] to the value of [Ciphertext].
   Ciphertext addPlain(Ciphertext a, Plaintext b) {
     Pointer ptr = _c_add_plain(library, a.obj, b.obj);
@@ -308,6 +584,26 @@ class Afhe {
     return Ciphertext.fromPointer(backend, ptr);
   }
 
+  /// Multiplies every [Ciphertext] in [ctxts], in a single native call.
+  ///
+  /// Products are paired in a balanced tree, consuming log2(ctxts.length) levels.
+  /// Each product is relinearized, and rescaled for CKKS [Scheme].
+  /// Requires the relinearization keys, see genRelinKeys().
+  Ciphertext multiplyMany(List<Ciphertext> ctxts) {
+    return _reduceMany(_c_multiply_many, ctxts);
+  }
+
+  Ciphertext _reduceMany(_ReduceMany reduce, List<Ciphertext> ctxts) {
+    final arr = calloc<Pointer>(ctxts.length);
+    for (var i = 0; i < ctxts.length; i++) {
+      arr[i] = ctxts[i].obj;
+    }
+    Pointer ptr = reduce(library, arr, ctxts.length);
+    calloc.free(arr);
+    raiseForStatus();
+    return Ciphertext.fromPointer(backend, ptr);
+  }
+
   /// Multiplies a [Ciphertext] by a [Plaintext].
   Ciphertext multiplyPlain(Ciphertext a, Plaintext b) {
     Pointer ptr = _c_multiply_plain(library, a.obj, b.obj);
@@ -332,4 +628,50 @@ class Afhe {
     raiseForStatus();
     return Ciphertext.fromPointer(backend, ptr);
   }
+
+  /// Evaluates the polynomial with coefficients [coeffs] on the [Ciphertext].
+  ///
+  /// Only supported for CKKS [Scheme].
+  /// The [coeffs] are in ascending order of degree: c0 + c1 x + c2 x^2 + ...
+  /// Uses about 2 * sqrt(degree) ciphertext multiplications, each relinearized
+  /// and rescaled, and consumes about log2(degree) + 1 levels.
+  Ciphertext evalPolynomial(Ciphertext a, List<double> coeffs) {
+    final arr = doubleListToArray(coeffs);
+    Pointer ptr = _c_eval_polynomial(library, a.obj, arr, coeffs.length);
+    calloc.free(arr);
+    raiseForStatus();
+    return Ciphertext.fromPointer(backend, ptr);
+  }
+
+  /// Rotates the slots of the [Ciphertext] by [steps].
+  ///
+  /// Positive [steps] rotate left, negative [steps] rotate right.
+  /// For BFV/BGV [Scheme], each row of slotCount / 2 slots rotates independently.
+  /// Requires the Galois keys, see genGaloisKeys().
+  Ciphertext rotate(Ciphertext a, int steps) {
+    Pointer ptr = _c_rotate(library, a.obj, steps);
+    raiseForStatus();
+    return Ciphertext.fromPointer(backend, ptr);
+  }
+
+  /// Rotates the [Ciphertext] by each of the [steps], in a single native call.
+  ///
+  /// Returns one [Ciphertext] per step, each an independent rotation run in parallel;
+  /// the total work is that of one rotate() per step.
+  List<Ciphertext> rotateBatch(Ciphertext a, List<int> steps) {
+    final stepsPtr = intListToArray(steps);
+    final out = calloc<Pointer>(steps.length);
+    try {
+      final status =
+          _c_rotate_batch(library, a.obj, stepsPtr, steps.length, out);
+      if (status != 0) raiseForStatus();
+      return [
+        for (var i = 0; i < steps.length; i++)
+          Ciphertext.fromPointer(backend, out[i])
+      ];
+    } finally {
+      calloc.free(stepsPtr);
+      calloc.free(out);
+    }
+  }
 }
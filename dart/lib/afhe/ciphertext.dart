@@ -9,6 +9,13 @@ final _InitCiphertext _c_init_ciphertext = dylib
     .lookup<NativeFunction<_InitCiphertextC>>('init_ciphertext')
     .asFunction();
 
+typedef _DeleteCiphertextC = Void Function(Pointer library, Pointer ciphertext);
+typedef _DeleteCiphertext = void Function(Pointer library, Pointer ciphertext);
+
+final _DeleteCiphertext _c_delete_ciphertext = dylib
+    .lookup<NativeFunction<_DeleteCiphertextC>>('delete_ciphertext')
+    .asFunction();
+
 typedef _GetCiphertextSizeC = Int32 Function(Pointer ciphertext);
 typedef _GetCiphertextSize = int Function(Pointer ciphertext);
 
@@ -16,6 +23,20 @@ final _GetCiphertextSize _c_get_ciphertext_size = dylib
     .lookup<NativeFunction<_GetCiphertextSizeC>>('get_ciphertext_size')
     .asFunction();
 
+typedef _GetCiphertextScaleC = Double Function(Pointer ciphertext);
+typedef _GetCiphertextScale = double Function(Pointer ciphertext);
+
+final _GetCiphertextScale _c_get_ciphertext_scale = dylib
+    .lookup<NativeFunction<_GetCiphertextScaleC>>('get_ciphertext_scale')
+    .asFunction();
+
+typedef _SetCiphertextScaleC = Void Function(Pointer ciphertext, Double scale);
+typedef _SetCiphertextScale = void Function(Pointer ciphertext, double scale);
+
+final _SetCiphertextScale _c_set_ciphertext_scale = dylib
+    .lookup<NativeFunction<_SetCiphertextScaleC>>('set_ciphertext_scale')
+    .asFunction();
+
 typedef _SaveCiphertextC = Pointer<Uint8> Function(Pointer ciphertext);
 typedef _SaveCiphertext = Pointer<Uint8> Function(Pointer ciphertext);
 
@@ -30,6 +51,13 @@ final _SaveCipherSize _c_get_ciphertext_save_size = dylib
     .lookup<NativeFunction<_SaveCipherSizeC>>('save_ciphertext_size')
     .asFunction();
 
+typedef _SaveCiphertextInplaceC = Int Function(Pointer ciphertext, Pointer<Uint8> out, Int size);
+typedef _SaveCiphertextInplace = int Function(Pointer ciphertext, Pointer<Uint8> out, int size);
+
+final _SaveCiphertextInplace _c_save_ciphertext_inplace = dylib
+    .lookup<NativeFunction<_SaveCiphertextInplaceC>>('save_ciphertext_inplace')
+    .asFunction();
+
 typedef _LoadCiphertextC = Pointer Function(Pointer library, Pointer<Uint8> data, Int size);
 typedef _LoadCiphertext = Pointer Function(Pointer library, Pointer<Uint8> data, int size);
 
@@ -62,23 +90,52 @@ class Ciphertext {
   /// Returns the number of bytes of the ciphertext.
   int get size => _c_get_ciphertext_size(obj);
 
+  /// The scale of the encoded values, used by the CKKS [Scheme].
+  double get scale => _c_get_ciphertext_scale(obj);
+
+  /// Sets the scale, e.g. to align ciphertexts whose scales differ by rounding.
+  set scale(double value) => _c_set_ciphertext_scale(obj, value);
+
   /// Calculates the number of bytes of the serialized ciphertext.
   int get saveSize => _c_get_ciphertext_save_size(obj);
 
   /// Saves the [Ciphertext] to a non-human-readable format.
   /// Useful for saving to disk or sending over the network.
-  Pointer<Uint8> save() => _c_save_ciphertext(obj);
+  ///
+  /// The returned buffer is owned by the caller, prefer [toBytes].
+  Pointer<Uint8> save() {
+    final ptr = _c_save_ciphertext(obj);
+    raiseForStatus();
+    return ptr;
+  }
 
   /// Converts a [Ciphertext] into a serialized binary format.
-  Uint8List toBytes() => save().asTypedList(saveSize);
+  ///
+  /// Serialized once, directly into a native buffer backing the returned list;
+  /// the buffer is freed when the list is garbage collected.
+  Uint8List toBytes() {
+    final size = saveSize;
+    final Pointer<Uint8> pointer = malloc.allocate<Uint8>(size);
+    final written = _c_save_ciphertext_inplace(obj, pointer, size);
+    if (written < 0) {
+      malloc.free(pointer);
+      raiseForStatus();
+    }
+    return pointer.asTypedList(written, finalizer: malloc.nativeFree);
+  }
 
   /// Loads a [Ciphertext] from a serialized binary format.
-  Ciphertext.fromBytes(Afhe fhe, Uint8List bytes) {
+  ///
+  /// The bytes are copied once into a native buffer, freed after loading.
+  Ciphertext.fromBytes(Afhe fhe, Uint8List bytes) : backend = fhe.backend {
     final Pointer<Uint8> pointer = malloc.allocate<Uint8>(bytes.length);
-    // Copy the bytes to the allocated memory
-    final Uint8List pointerContent = pointer.asTypedList(bytes.length);
-    pointerContent.setAll(0, bytes);
-    obj = _c_load_ciphertext(fhe.library, pointer, bytes.length);
+    try {
+      pointer.asTypedList(bytes.length).setAll(0, bytes);
+      obj = _c_load_ciphertext(fhe.library, pointer, bytes.length);
+      raiseForStatus();
+    } finally {
+      malloc.free(pointer);
+    }
   }
 }
 
@@ -92,6 +149,11 @@ final _InvariantNoiseBudget _c_invariant_noise_budget = dylib
     .lookup<NativeFunction<_InvariantNoiseBudgetC>>('invariant_noise_budget')
     .asFunction();
 
+/// Returns the estimated noise budget of the ciphertext, without the secret key.
+final _InvariantNoiseBudget _c_estimate_noise_budget = dylib
+    .lookup<NativeFunction<_InvariantNoiseBudgetC>>('estimate_noise_budget')
+    .asFunction();
+
 typedef _ModSwitchNextC = Void Function(Pointer library, Pointer ciphertext);
 typedef _ModSwitchNext = void Function(Pointer library, Pointer ciphertext);
 
@@ -99,3 +161,76 @@ typedef _ModSwitchNext = void Function(Pointer library, Pointer ciphertext);
 final _ModSwitchNext _c_mod_switch_next = dylib
     .lookup<NativeFunction<_ModSwitchNextC>>('mod_switch_to_next')
     .asFunction();
+
+typedef _CompactForTransferC = Int Function(Pointer library, Pointer ciphertext, Int minBudget);
+typedef _CompactForTransfer = int Function(Pointer library, Pointer ciphertext, int minBudget);
+
+/// Switches the ciphertext to the lowest level that still decrypts correctly.
+final _CompactForTransfer _c_compact_for_transfer = dylib
+    .lookup<NativeFunction<_CompactForTransferC>>('compact_for_transfer')
+    .asFunction();
+
+typedef _RescaleNextC = Void Function(Pointer library, Pointer ciphertext);
+typedef _RescaleNext = void Function(Pointer library, Pointer ciphertext);
+
+/// Rescales the ciphertext to the next level.
+final _RescaleNext _c_rescale_next = dylib
+    .lookup<NativeFunction<_RescaleNextC>>('rescale_to_next')
+    .asFunction();
+
+// --- levels ---
+
+typedef _CiphertextLevelC = Int Function(Pointer library, Pointer ciphertext);
+typedef _CiphertextLevel = int Function(Pointer library, Pointer ciphertext);
+
+final _CiphertextLevel _c_get_chain_index = dylib
+    .lookup<NativeFunction<_CiphertextLevelC>>('get_chain_index')
+    .asFunction();
+
+final _CiphertextLevel _c_get_ciphertext_level = dylib
+    .lookup<NativeFunction<_CiphertextLevelC>>('get_ciphertext_level')
+    .asFunction();
+
+final _CiphertextLevel _c_get_coeff_modulus_count = dylib
+    .lookup<NativeFunction<_CiphertextLevelC>>('get_coeff_modulus_count')
+    .asFunction();
+
+typedef _ModSwitchToLevelC = Int Function(Pointer library, Pointer ciphertext, Int level);
+typedef _ModSwitchToLevel = int Function(Pointer library, Pointer ciphertext, int level);
+
+final _ModSwitchToLevel _c_mod_switch_to_level = dylib
+    .lookup<NativeFunction<_ModSwitchToLevelC>>('mod_switch_to_level')
+    .asFunction();
+
+typedef _GetLevelCountC = Int Function(Pointer library);
+typedef _GetLevelCount = int Function(Pointer library);
+
+final _GetLevelCount _c_get_level_count = dylib
+    .lookup<NativeFunction<_GetLevelCountC>>('get_level_count')
+    .asFunction();
+
+typedef _GetLevelCostsC = Int Function(Pointer library, Pointer<Double> out, Size cap);
+typedef _GetLevelCosts = int Function(Pointer library, Pointer<Double> out, int cap);
+
+final _GetLevelCosts _c_get_level_costs = dylib
+    .lookup<NativeFunction<_GetLevelCostsC>>('get_level_costs')
+    .asFunction();
+
+/// Size and relative cost of operations at one level of the modulus chain.
+///
+/// Costs are relative to fresh ciphertexts, at level 0.
+class LevelCost {
+  /// The number of primes in the coefficient modulus.
+  final int primes;
+
+  /// The bits of the coefficient modulus.
+  final double log2Modulus;
+
+  /// The cost of a product.
+  final double multiply;
+
+  /// The cost of key switching, by relinearization or rotation.
+  final double keySwitch;
+
+  LevelCost(this.primes, this.log2Modulus, this.multiply, this.keySwitch);
+}
@@ -15,9 +15,7 @@ final _EncodeVectorInt _c_encode_vector_int = dylib
 Pointer<Uint64> intListToUint64Array(List<int> list) {
   final length = list.length;
   final pointer = calloc<Uint64>(length + 1); // +1 if null-terminated.
-  for (int index = 0; index < length; index++) {
-    pointer[index] = list[index];
-  }
+  pointer.asTypedList(length).setAll(0, list);
   return pointer;
 }
 
@@ -49,9 +47,7 @@ final _EncodeVectorDouble _c_encode_vector_double = dylib
 Pointer<Double> doubleListToArray(List<double> list) {
   final length = list.length;
   final pointer = calloc<Double>(length + 1); // +1 if null-terminated.
-  for (int index = 0; index < length; index++) {
-    pointer[index] = list[index];
-  }
+  pointer.asTypedList(length).setAll(0, list);
   return pointer;
 }
 
@@ -65,13 +61,18 @@ final _DecodeVectorIntC _c_decode_vector_int = dylib
 
 /// Convert C uint64 array to Dart int list.
 List<int> uint64ArrayToIntList(Pointer<Uint64> ptr, int length) {
-  final list = <int>[];
-  for (var i = 0; i < length; i++) {
-    list.add(ptr[i].toInt());
-  }
-  return list;
+  return ptr.asTypedList(length).toList();
 }
 
+typedef _DecodeIntIntoC = Int Function(
+    Pointer library, Pointer plaintext, Pointer<Uint64> out, Size cap);
+typedef _DecodeIntInto = int Function(
+    Pointer library, Pointer plaintext, Pointer<Uint64> out, int cap);
+
+/// Decodes a [Plaintext] into a caller-provided array of integers.
+final _DecodeIntInto _c_decode_int_into = dylib
+    .lookupFunction<_DecodeIntIntoC, _DecodeIntInto>('decode_int_into');
+
 typedef _DecodeVectorDoubleC = Pointer<Double> Function(Pointer library, Pointer plaintext);
 
 /// Decodes a [Plaintext] into a list of doubles.
@@ -80,9 +81,62 @@ final _DecodeVectorDoubleC _c_decode_vector_double = dylib
 
 /// Convert C double array to Dart double list.
 List<double> arrayToDoubleList(Pointer<Double> ptr, int length) {
-  final list = <double>[];
-  for (var i = 0; i < length; i++) {
-    list.add(ptr[i].toDouble());
+  return ptr.asTypedList(length).toList();
+}
+
+typedef _DecodeDoubleIntoC = Int Function(
+    Pointer library, Pointer plaintext, Pointer<Double> out, Size cap);
+typedef _DecodeDoubleInto = int Function(
+    Pointer library, Pointer plaintext, Pointer<Double> out, int cap);
+
+/// Decodes a [Plaintext] into a caller-provided array of doubles.
+final _DecodeDoubleInto _c_decode_double_into = dylib
+    .lookupFunction<_DecodeDoubleIntoC, _DecodeDoubleInto>('decode_double_into');
+
+/// Decode a [Plaintext] into native memory, viewed as a typed list.
+///
+/// The native buffer is owned by the returned list and freed by its finalizer.
+Uint64List decodeIntView(Pointer library, Pointer plaintext, int length) {
+  final ptr = malloc<Uint64>(length);
+  final written = _c_decode_int_into(library, plaintext, ptr, length);
+  if (written < 0) {
+    malloc.free(ptr);
+    raiseForStatus();
   }
-  return list;
+  return ptr.asTypedList(written, finalizer: malloc.nativeFree);
 }
+
+/// Decode a [Plaintext] into native memory, viewed as a typed list.
+///
+/// The native buffer is owned by the returned list and freed by its finalizer.
+Float64List decodeDoubleView(Pointer library, Pointer plaintext, int length) {
+  final ptr = malloc<Double>(length);
+  final written = _c_decode_double_into(library, plaintext, ptr, length);
+  if (written < 0) {
+    malloc.free(ptr);
+    raiseForStatus();
+  }
+  return ptr.asTypedList(written, finalizer: malloc.nativeFree);
+}
+
+// --- complex ---
+
+typedef _EncodeComplexC = Pointer Function(
+    Pointer library, Pointer<Double> interleaved, Int size);
+typedef _EncodeComplex = Pointer Function(
+    Pointer library, Pointer<Double> interleaved, int size);
+
+/// Encodes interleaved (real, imaginary) doubles into a [Plaintext].
+final _EncodeComplex _c_encode_complex = dylib
+    .lookupFunction<_EncodeComplexC, _EncodeComplex>('encode_complex');
+
+typedef _DecodeComplexIntoC = Int Function(
+    Pointer library, Pointer plaintext, Pointer<Double> out, Size cap);
+typedef _DecodeComplexInto = int Function(
+    Pointer library, Pointer plaintext, Pointer<Double> out, int cap);
+
+/// Decodes a [Plaintext] into interleaved (real, imaginary) doubles.
+final _DecodeComplexInto _c_decode_complex_into = dylib
+    .lookupFunction<_DecodeComplexIntoC, _DecodeComplexInto>(
+        'decode_complex_into');
+
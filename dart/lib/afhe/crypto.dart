@@ -50,6 +50,24 @@ final _GenContextFromStr _c_gen_context_from_str = dylib
     .lookup<NativeFunction<_GenContextFromStrC>>('generate_context_from_str')
     .asFunction();
 
+// --- prng ---
+
+typedef _StringToPrngTypeC = Int32 Function(Pointer<Utf8> prng);
+typedef _StringToPrngType = int Function(Pointer<Utf8> prng);
+final _StringToPrngType _c_string_to_prng_type = dylib
+    .lookup<NativeFunction<_StringToPrngTypeC>>('prng_t_from_string')
+    .asFunction();
+
+typedef _SetPrngC = Int32 Function(Pointer library, Int32 prng);
+typedef _SetPrng = int Function(Pointer library, int prng);
+final _SetPrng _c_set_prng =
+    dylib.lookup<NativeFunction<_SetPrngC>>('set_prng').asFunction();
+
+typedef _SetPoolCapacityC = Int32 Function(Pointer library, Int32 capacity);
+typedef _SetPoolCapacity = int Function(Pointer library, int capacity);
+final _SetPoolCapacity _c_set_pool_capacity =
+    dylib.lookup<NativeFunction<_SetPoolCapacityC>>('set_pool_capacity').asFunction();
+
 // --- slot count ---
 
 typedef _SlotCountC = Int32 Function(Pointer library);
@@ -70,9 +88,55 @@ typedef _EncryptC = Pointer Function(Pointer library, Pointer plaintext);
 final _EncryptC _c_encrypt = dylib
     .lookup<NativeFunction<_EncryptC>>('encrypt').asFunction();
 
+typedef _EncryptManyC = Int Function(
+    Pointer library, Pointer<Pointer> plaintexts, Int count, Pointer<Pointer> out);
+typedef _EncryptMany = int Function(
+    Pointer library, Pointer<Pointer> plaintexts, int count, Pointer<Pointer> out);
+
+final _EncryptMany _c_encrypt_many = dylib
+    .lookup<NativeFunction<_EncryptManyC>>('encrypt_many').asFunction();
+
 // --- decrypt ---
 
 typedef _DecryptC = Pointer Function(Pointer library, Pointer plaintext);
 
 final _DecryptC _c_decrypt = dylib
     .lookup<NativeFunction<_DecryptC>>('decrypt').asFunction();
+
+// --- fused encode and encrypt ---
+
+typedef _EncryptIntsC = Pointer Function(
+    Pointer library, Pointer<Uint64> data, Int size);
+typedef _EncryptInts = Pointer Function(
+    Pointer library, Pointer<Uint64> data, int size);
+
+final _EncryptInts _c_encrypt_ints = dylib
+    .lookup<NativeFunction<_EncryptIntsC>>('encrypt_ints').asFunction();
+
+typedef _EncryptDoublesC = Pointer Function(
+    Pointer library, Pointer<Double> data, Int size);
+typedef _EncryptDoubles = Pointer Function(
+    Pointer library, Pointer<Double> data, int size);
+
+final _EncryptDoubles _c_encrypt_doubles = dylib
+    .lookup<NativeFunction<_EncryptDoublesC>>('encrypt_doubles').asFunction();
+
+// --- fused decrypt and decode ---
+
+typedef _DecryptIntsIntoC = Int Function(
+    Pointer library, Pointer ciphertext, Pointer<Uint64> out, Size cap);
+typedef _DecryptIntsInto = int Function(
+    Pointer library, Pointer ciphertext, Pointer<Uint64> out, int cap);
+
+final _DecryptIntsInto _c_decrypt_ints_into = dylib
+    .lookup<NativeFunction<_DecryptIntsIntoC>>('decrypt_ints_into')
+    .asFunction();
+
+typedef _DecryptDoublesIntoC = Int Function(
+    Pointer library, Pointer ciphertext, Pointer<Double> out, Size cap);
+typedef _DecryptDoublesInto = int Function(
+    Pointer library, Pointer ciphertext, Pointer<Double> out, int cap);
+
+final _DecryptDoublesInto _c_decrypt_doubles_into = dylib
+    .lookup<NativeFunction<_DecryptDoublesIntoC>>('decrypt_doubles_into')
+    .asFunction();
@@ -23,6 +23,16 @@ typedef _GenRelinKeys = void Function(Pointer library);
 final _GenRelinKeys _c_gen_relin_keys = dylib
     .lookup<NativeFunction<_GenRelinKeysC>>('generate_relin_keys').asFunction();
 
+// --- galois keys ---
+
+typedef _GenGaloisKeysC = Void Function(
+    Pointer library, Pointer<Int> steps, Int count);
+typedef _GenGaloisKeys = void Function(
+    Pointer library, Pointer<Int> steps, int count);
+final _GenGaloisKeys _c_gen_galois_keys = dylib
+    .lookup<NativeFunction<_GenGaloisKeysC>>('generate_galois_keys')
+    .asFunction();
+
 // --- save keys ---
 
 typedef _SaveKeys = Pointer<Uint8> Function(Pointer key);
@@ -47,6 +57,9 @@ final _GetKey _c_get_secret_key = dylib
 final _GetKey _c_get_relin_keys = dylib
     .lookup<NativeFunction<_GetKey>>('get_relin_keys').asFunction();
 
+final _GetKey _c_get_galois_keys = dylib
+    .lookup<NativeFunction<_GetKey>>('get_galois_keys').asFunction();
+
 // --- key data ---
 
 typedef _GetKeyData = Pointer<Uint64> Function(Pointer key);
@@ -58,6 +71,11 @@ typedef _GetKeyDataSize = int Function(Pointer key);
 final _GetKeyDataSize _c_get_key_data_size = dylib
     .lookup<NativeFunction<_GetKeyDataSizeC>>('get_key_data_size').asFunction();
 
+typedef _GetKeyFingerprintC = Uint64 Function(Pointer key);
+typedef _GetKeyFingerprint = int Function(Pointer key);
+final _GetKeyFingerprint _c_get_key_fingerprint = dylib
+    .lookup<NativeFunction<_GetKeyFingerprintC>>('get_key_fingerprint').asFunction();
+
 
 // --- load keys ---
 
@@ -67,6 +85,17 @@ typedef _LoadKey = Pointer Function(int keyType, Pointer library, Pointer<Uint8>
 final _LoadKey _c_load_key = dylib
     .lookup<NativeFunction<_LoadKeyC>>('load_key').asFunction();
 
+final _LoadKey _c_load_key_trusted = dylib
+    .lookup<NativeFunction<_LoadKeyC>>('load_key_trusted').asFunction();
+
+// --- set keys ---
+
+typedef _SetKeyC = Void Function(KeyType keyType, Pointer library, Pointer key);
+typedef _SetKey = void Function(int keyType, Pointer library, Pointer key);
+
+final _SetKey _c_set_key = dylib
+    .lookup<NativeFunction<_SetKeyC>>('set_key').asFunction();
+
 /// Represents an underlying key object in memory
 /// 
 /// A key is used to encrypt and decrypt data. Typically, keys are generated
@@ -109,8 +138,10 @@ class Key {
   /// 
   /// [serialized] is the byte array containing the key of [size]
   /// validates new key with [library] during creation.
-  load(Pointer fhe, Pointer<Uint8> serialData, int serialSize) {
-    obj = _c_load_key(type, fhe, serialData, serialSize);
+  /// When [trusted], validation is skipped; only for keys from a trusted source.
+  load(Pointer fhe, Pointer<Uint8> serialData, int serialSize, {bool trusted = false}) {
+    final loader = trusted ? _c_load_key_trusted : _c_load_key;
+    obj = loader(type, fhe, serialData, serialSize);
     raiseForStatus();
   }
 
@@ -142,6 +173,21 @@ class Key {
     return keyData;
   }
 
+  /// Returns a 64-bit fingerprint of the key material
+  ///
+  /// Equal keys have equal fingerprints, regardless of serialization;
+  /// used to deduplicate and route keys. Computed once per key.
+  /// Differs from the cache id of [KeyCache.load], a hash of the serialization.
+  int get fingerprint {
+    if (obj == nullptr)
+    {
+      throw Exception("Cannot get key fingerprint, as obj is not set");
+    }
+    int fp = _c_get_key_fingerprint(obj);
+    raiseForStatus();
+    return fp;
+  }
+
   /// Returns [data] as a List<Hexadecimal>
   List<String> get hexData {
     return data.map((e) => e.toRadixString(16)).toList();
@@ -0,0 +1,106 @@
+/// This file contains the `KeyCache` class and its associated FFI bindings.
+part of '../afhe.dart';
+// ignore_for_file: non_constant_identifier_names
+
+typedef _InitKeyCacheC = Pointer Function(Uint64 budget, Pointer<Utf8> spillDir);
+typedef _InitKeyCache = Pointer Function(int budget, Pointer<Utf8> spillDir);
+
+final _InitKeyCache _c_init_key_cache = dylib
+    .lookup<NativeFunction<_InitKeyCacheC>>('init_key_cache')
+    .asFunction();
+
+typedef _DeleteKeyCacheC = Void Function(Pointer cache);
+typedef _DeleteKeyCache = void Function(Pointer cache);
+
+final _DeleteKeyCache _c_delete_key_cache = dylib
+    .lookup<NativeFunction<_DeleteKeyCacheC>>('delete_key_cache')
+    .asFunction();
+
+typedef _KeyCacheLoadC = Uint64 Function(Pointer cache, KeyType keyType,
+    Pointer library, Pointer<Uint8> data, Int size, Int trusted);
+typedef _KeyCacheLoad = int Function(Pointer cache, int keyType,
+    Pointer library, Pointer<Uint8> data, int size, int trusted);
+
+final _KeyCacheLoad _c_key_cache_load = dylib
+    .lookup<NativeFunction<_KeyCacheLoadC>>('key_cache_load')
+    .asFunction();
+
+typedef _KeyCacheAttachC = Int Function(Pointer cache, Pointer library, Uint64 cacheId);
+typedef _KeyCacheAttach = int Function(Pointer cache, Pointer library, int cacheId);
+
+final _KeyCacheAttach _c_key_cache_attach = dylib
+    .lookup<NativeFunction<_KeyCacheAttachC>>('key_cache_attach')
+    .asFunction();
+
+typedef _KeyCacheMemorySizeC = Uint64 Function(Pointer cache);
+typedef _KeyCacheMemorySize = int Function(Pointer cache);
+
+final _KeyCacheMemorySize _c_key_cache_memory_size = dylib
+    .lookup<NativeFunction<_KeyCacheMemorySizeC>>('key_cache_memory_size')
+    .asFunction();
+
+typedef _KeyCacheCountC = Int Function(Pointer cache);
+typedef _KeyCacheCount = int Function(Pointer cache);
+
+final _KeyCacheCount _c_key_cache_count = dylib
+    .lookup<NativeFunction<_KeyCacheCountC>>('key_cache_count')
+    .asFunction();
+
+/// Caches deserialized keys, shared by the [Afhe] handles of a multi-tenant server.
+///
+/// Keys are identified by a cache id, a hash of their serialization. Up to
+/// [budget] bytes are held in memory; past the budget, the least recently
+/// used keys are dropped, or written to [spillDir] and mapped back when needed.
+/// Attached keys are shared without copying, with handles of the same parameters.
+///
+class KeyCache {
+  /// A pointer to the memory address of the underlying C++ object.
+  Pointer obj = nullptr;
+
+  /// Creates a cache holding up to [budget] bytes of serialized keys.
+  KeyCache(int budget, {String spillDir = ""}) {
+    final dir = spillDir.toNativeUtf8();
+    obj = _c_init_key_cache(budget, dir);
+    calloc.free(dir);
+    raiseForStatus();
+  }
+
+  /// Attaches the serialized key of type [keyName] to [fhe].
+  ///
+  /// Only public, relinearization and galois keys are cached;
+  /// secret keys are rejected, as evicted keys are written to disk.
+  ///
+  /// The key is deserialized only on a cache miss; when [trusted], without validation.
+  /// Returns the cache id of the key, used by [attach]; unlike
+  /// [Key.fingerprint], it hashes the serialization, not the key material.
+  int load(Afhe fhe, String keyName, Pointer<Uint8> data, int size,
+      {bool trusted = false}) {
+    final keyType = _c_string_to_key_type(keyName.toNativeUtf8());
+    raiseForStatus();
+    final cacheId =
+        _c_key_cache_load(obj, keyType, fhe.library, data, size, trusted ? 1 : 0);
+    raiseForStatus();
+    return cacheId;
+  }
+
+  /// Attaches a cached key to [fhe], by the [cacheId] returned by [load].
+  ///
+  /// Returns false when the key is no longer cached, and must be loaded again.
+  bool attach(Afhe fhe, int cacheId) {
+    final status = _c_key_cache_attach(obj, fhe.library, cacheId);
+    if (status < 0) raiseForStatus();
+    return status == 1;
+  }
+
+  /// The number of bytes held in memory.
+  int get memorySize => _c_key_cache_memory_size(obj);
+
+  /// The number of cached keys, in memory or spilled.
+  int get count => _c_key_cache_count(obj);
+
+  /// Deletes the cache; keys attached to an [Afhe] remain valid.
+  void dispose() {
+    _c_delete_key_cache(obj);
+    obj = nullptr;
+  }
+}
@@ -0,0 +1,139 @@
+/// This file contains the `PlainMatrix` class and its associated FFI bindings.
+part of '../afhe.dart';
+// ignore_for_file: non_constant_identifier_names
+
+typedef _EncodeMatrixIntC = Pointer Function(
+    Pointer library, Pointer<Uint64> data, Int rows, Int cols);
+typedef _EncodeMatrixInt = Pointer Function(
+    Pointer library, Pointer<Uint64> data, int rows, int cols);
+
+final _EncodeMatrixInt _c_encode_matrix_int = dylib
+    .lookup<NativeFunction<_EncodeMatrixIntC>>('encode_matrix_int')
+    .asFunction();
+
+typedef _EncodeMatrixDoubleC = Pointer Function(
+    Pointer library, Pointer<Double> data, Int rows, Int cols);
+typedef _EncodeMatrixDouble = Pointer Function(
+    Pointer library, Pointer<Double> data, int rows, int cols);
+
+final _EncodeMatrixDouble _c_encode_matrix_double = dylib
+    .lookup<NativeFunction<_EncodeMatrixDoubleC>>('encode_matrix_double')
+    .asFunction();
+
+typedef _DeletePlainMatrixC = Void Function(Pointer matrix);
+typedef _DeletePlainMatrix = void Function(Pointer matrix);
+
+final _DeletePlainMatrix _c_delete_plain_matrix = dylib
+    .lookup<NativeFunction<_DeletePlainMatrixC>>('delete_plain_matrix')
+    .asFunction();
+
+typedef _MatrixDimC = Int Function(Pointer matrix);
+typedef _MatrixDim = int Function(Pointer matrix);
+
+final _MatrixDim _c_matrix_dim = dylib
+    .lookup<NativeFunction<_MatrixDimC>>('get_matrix_dim')
+    .asFunction();
+
+typedef _MatrixStepsC = Int Function(Pointer matrix, Pointer<Int> out, Int cap);
+typedef _MatrixSteps = int Function(Pointer matrix, Pointer<Int> out, int cap);
+
+final _MatrixSteps _c_matrix_rotation_steps = dylib
+    .lookup<NativeFunction<_MatrixStepsC>>('get_matrix_rotation_steps')
+    .asFunction();
+
+typedef _MatvecPlainC = Pointer Function(
+    Pointer library, Pointer matrix, Pointer ciphertext);
+
+final _MatvecPlainC _c_matvec_plain = dylib
+    .lookup<NativeFunction<_MatvecPlainC>>('matvec_plain')
+    .asFunction();
+
+/// A plaintext matrix, encoded once for products with encrypted vectors.
+///
+/// The matrix is padded to a square of dimension [dim], a power of two.
+/// Its diagonals are encoded when constructed, such that each product
+/// with an encrypted vector is a single native call.
+class PlainMatrix {
+  /// The [Afhe] used to encode and evaluate.
+  final Afhe fhe;
+
+  /// The number of rows of the matrix.
+  final int rows;
+
+  /// The number of columns of the matrix.
+  final int cols;
+
+  /// A pointer to the memory address of the underlying C++ object.
+  Pointer obj = nullptr;
+
+  /// Flatten [matrix] row by row, validating its shape.
+  static List<T> _flatten<T>(List<List<T>> matrix) {
+    final cols = matrix.isEmpty ? 0 : matrix[0].length;
+    for (var r = 0; r < matrix.length; r++) {
+      if (matrix[r].length != cols) {
+        throw ArgumentError('Row $r must contain $cols values');
+      }
+    }
+    return [for (final row in matrix) ...row];
+  }
+
+  /// Encodes an integer [matrix], given as a list of rows.
+  ///
+  /// Only supported for BFV/BGV [Scheme].
+  PlainMatrix.fromInt(this.fhe, List<List<int>> matrix)
+      : rows = matrix.length,
+        cols = matrix.isEmpty ? 0 : matrix[0].length {
+    final ptr = intListToUint64Array(_flatten(matrix));
+    obj = _c_encode_matrix_int(fhe.library, ptr, rows, cols);
+    calloc.free(ptr);
+    raiseForStatus();
+  }
+
+  /// Encodes a floating point [matrix], given as a list of rows.
+  ///
+  /// Only supported for CKKS [Scheme].
+  PlainMatrix.fromDouble(this.fhe, List<List<double>> matrix)
+      : rows = matrix.length,
+        cols = matrix.isEmpty ? 0 : matrix[0].length {
+    final ptr = doubleListToArray(_flatten(matrix));
+    obj = _c_encode_matrix_double(fhe.library, ptr, rows, cols);
+    calloc.free(ptr);
+    raiseForStatus();
+  }
+
+  /// The dimension of the padded square matrix.
+  ///
+  /// Vectors are replicated with this period across the slots,
+  /// see [Packing] with a record size of [dim].
+  int get dim => _c_matrix_dim(obj);
+
+  /// The rotation steps used by a product, for [Afhe.genGaloisKeys].
+  List<int> get rotationSteps {
+    final count = _c_matrix_rotation_steps(obj, nullptr, 0);
+    raiseForStatus();
+    final ptr = calloc<Int>(count);
+    try {
+      _c_matrix_rotation_steps(obj, ptr, count);
+      return [for (var i = 0; i < count; i++) ptr[i]];
+    } finally {
+      calloc.free(ptr);
+    }
+  }
+
+  /// Multiplies the matrix by an encrypted [vector].
+  ///
+  /// The [vector] is replicated with period [dim], and so is the product:
+  /// entry i is held in every slot congruent to i modulo [dim].
+  /// For CKKS [Scheme], the product is rescaled.
+  Ciphertext multiply(Ciphertext vector) {
+    final ptr = _c_matvec_plain(fhe.library, obj, vector.obj);
+    raiseForStatus();
+    return Ciphertext.fromPointer(fhe.backend, ptr);
+  }
+
+  /// Deletes the encoded diagonals; products remain valid.
+  void dispose() {
+    _c_delete_plain_matrix(obj);
+    obj = nullptr;
+  }
+}
@@ -8,6 +8,13 @@ typedef _AddC = Pointer Function(Pointer library, Pointer a, Pointer b);
 final _AddC _c_add = dylib.lookup<NativeFunction<_AddC>>('add').asFunction();
 final _AddC _c_add_plain = dylib.lookup<NativeFunction<_AddC>>('add_plain').asFunction();
 
+// --- add_many / multiply_many ---
+
+typedef _ReduceManyC = Pointer Function(Pointer library, Pointer<Pointer> ctxts, Int count);
+typedef _ReduceMany = Pointer Function(Pointer library, Pointer<Pointer> ctxts, int count);
+final _ReduceMany _c_add_many = dylib.lookup<NativeFunction<_ReduceManyC>>('add_many').asFunction();
+final _ReduceMany _c_multiply_many = dylib.lookup<NativeFunction<_ReduceManyC>>('multiply_many').asFunction();
+
 // --- subtract ---
 
 typedef _SubC = Pointer Function(Pointer library, Pointer a, Pointer b);
@@ -29,3 +36,23 @@ final _SquareC _c_square = dylib.lookup<NativeFunction<_SquareC>>('square').asFu
 typedef _PowerC = Pointer Function(Pointer library, Pointer a, Int power);
 typedef _Power = Pointer Function(Pointer library, Pointer a, int power);
 final _Power _c_power = dylib.lookup<NativeFunction<_PowerC>>('power').asFunction();
+
+// --- eval_polynomial ---
+typedef _EvalPolynomialC = Pointer Function(
+    Pointer library, Pointer a, Pointer<Double> coeffs, Int count);
+typedef _EvalPolynomial = Pointer Function(
+    Pointer library, Pointer a, Pointer<Double> coeffs, int count);
+final _EvalPolynomial _c_eval_polynomial = dylib
+    .lookup<NativeFunction<_EvalPolynomialC>>('eval_polynomial')
+    .asFunction();
+
+// --- rotate ---
+typedef _RotateC = Pointer Function(Pointer library, Pointer a, Int steps);
+typedef _Rotate = Pointer Function(Pointer library, Pointer a, int steps);
+final _Rotate _c_rotate = dylib.lookup<NativeFunction<_RotateC>>('rotate').asFunction();
+typedef _RotateBatchC = Int Function(Pointer library, Pointer a,
+    Pointer<Int> steps, Int count, Pointer<Pointer> out);
+typedef _RotateBatch = int Function(Pointer library, Pointer a,
+    Pointer<Int> steps, int count, Pointer<Pointer> out);
+final _RotateBatch _c_rotate_batch =
+    dylib.lookup<NativeFunction<_RotateBatchC>>('rotate_batch').asFunction();
@@ -0,0 +1,208 @@
+/// This file contains the `Packing` class and its associated FFI bindings.
+part of '../afhe.dart';
+// ignore_for_file: non_constant_identifier_names
+
+typedef _InitPackingC = Pointer Function(Pointer library, Int recordSize);
+typedef _InitPacking = Pointer Function(Pointer library, int recordSize);
+
+final _InitPacking _c_init_packing = dylib
+    .lookup<NativeFunction<_InitPackingC>>('init_packing')
+    .asFunction();
+
+typedef _DeletePackingC = Void Function(Pointer packing);
+typedef _DeletePacking = void Function(Pointer packing);
+
+final _DeletePacking _c_delete_packing = dylib
+    .lookup<NativeFunction<_DeletePackingC>>('delete_packing')
+    .asFunction();
+
+typedef _PackingCapacityC = Int Function(Pointer packing);
+typedef _PackingCapacity = int Function(Pointer packing);
+
+final _PackingCapacity _c_packing_capacity = dylib
+    .lookup<NativeFunction<_PackingCapacityC>>('get_packing_capacity')
+    .asFunction();
+
+typedef _PackIntC = Pointer Function(
+    Pointer library, Pointer packing, Pointer<Uint64> records, Int count);
+typedef _PackInt = Pointer Function(
+    Pointer library, Pointer packing, Pointer<Uint64> records, int count);
+
+final _PackInt _c_pack_int =
+    dylib.lookup<NativeFunction<_PackIntC>>('pack_int').asFunction();
+
+typedef _UnpackIntC = Int Function(Pointer library, Pointer packing,
+    Pointer plaintext, Pointer<Uint64> records, Int count);
+typedef _UnpackInt = int Function(Pointer library, Pointer packing,
+    Pointer plaintext, Pointer<Uint64> records, int count);
+
+final _UnpackInt _c_unpack_int =
+    dylib.lookup<NativeFunction<_UnpackIntC>>('unpack_int').asFunction();
+
+typedef _PackReplicatedIntC = Pointer Function(
+    Pointer library, Pointer packing, Pointer<Uint64> record);
+
+final _PackReplicatedIntC _c_pack_replicated_int = dylib
+    .lookup<NativeFunction<_PackReplicatedIntC>>('pack_replicated_int')
+    .asFunction();
+
+typedef _PackDoubleC = Pointer Function(
+    Pointer library, Pointer packing, Pointer<Double> records, Int count);
+typedef _PackDouble = Pointer Function(
+    Pointer library, Pointer packing, Pointer<Double> records, int count);
+
+final _PackDouble _c_pack_double =
+    dylib.lookup<NativeFunction<_PackDoubleC>>('pack_double').asFunction();
+
+typedef _UnpackDoubleC = Int Function(Pointer library, Pointer packing,
+    Pointer plaintext, Pointer<Double> records, Int count);
+typedef _UnpackDouble = int Function(Pointer library, Pointer packing,
+    Pointer plaintext, Pointer<Double> records, int count);
+
+final _UnpackDouble _c_unpack_double =
+    dylib.lookup<NativeFunction<_UnpackDoubleC>>('unpack_double').asFunction();
+
+typedef _PackReplicatedDoubleC = Pointer Function(
+    Pointer library, Pointer packing, Pointer<Double> record);
+
+final _PackReplicatedDoubleC _c_pack_replicated_double = dylib
+    .lookup<NativeFunction<_PackReplicatedDoubleC>>('pack_replicated_double')
+    .asFunction();
+
+typedef _SelectRecordC = Pointer Function(
+    Pointer library, Pointer packing, Pointer ciphertext, Int record);
+typedef _SelectRecord = Pointer Function(
+    Pointer library, Pointer packing, Pointer ciphertext, int record);
+
+final _SelectRecord _c_select_record =
+    dylib.lookup<NativeFunction<_SelectRecordC>>('select_record').asFunction();
+
+/// Packs many small records into the slots of a single [Plaintext].
+///
+/// Each record is placed at a fixed slot offset, such that element-wise
+/// operations on a packed [Ciphertext] apply independently to every record.
+/// Up to [capacity] records share the cost of a single ciphertext operation.
+class Packing {
+  /// The [Afhe] used to encode and decode records.
+  final Afhe fhe;
+
+  /// The number of values in each record.
+  final int recordSize;
+
+  /// A pointer to the memory address of the underlying C++ object.
+  Pointer obj = nullptr;
+
+  /// Initializes a packing layout for records of [recordSize] values.
+  ///
+  /// Requires the context of [fhe] to be generated.
+  Packing(this.fhe, this.recordSize) {
+    obj = _c_init_packing(fhe.library, recordSize);
+    raiseForStatus();
+  }
+
+  /// The maximum number of records packed into one [Plaintext].
+  int get capacity => _c_packing_capacity(obj);
+
+  /// Flatten [records] into a contiguous C array.
+  Pointer<T> _flatten<T extends NativeType>(
+      List<List<num>> records, Pointer<T> Function(int) allocate,
+      void Function(Pointer<T>, int, num) assign) {
+    final ptr = allocate(records.length * recordSize);
+    for (var r = 0; r < records.length; r++) {
+      if (records[r].length != recordSize) {
+        throw ArgumentError('Record $r must contain $recordSize values');
+      }
+      for (var i = 0; i < recordSize; i++) {
+        assign(ptr, r * recordSize + i, records[r][i]);
+      }
+    }
+    return ptr;
+  }
+
+  /// Encodes integer [records] into a single [Plaintext].
+  Plaintext packInt(List<List<int>> records) {
+    final ptr = _flatten<Uint64>(records, (n) => calloc<Uint64>(n),
+        (p, i, v) => p[i] = v.toInt());
+    final pt = _c_pack_int(fhe.library, obj, ptr, records.length);
+    calloc.free(ptr);
+    raiseForStatus();
+    return Plaintext.fromPointer(fhe.backend, pt, extractStr: false);
+  }
+
+  /// Decodes [count] integer records from a packed [Plaintext].
+  List<List<int>> unpackInt(Plaintext plaintext, int count) {
+    final ptr = calloc<Uint64>(count * recordSize);
+    _c_unpack_int(fhe.library, obj, plaintext.obj, ptr, count);
+    try {
+      raiseForStatus();
+      final flat = ptr.asTypedList(count * recordSize);
+      return List.generate(count,
+          (r) => flat.sublist(r * recordSize, (r + 1) * recordSize).toList());
+    } finally {
+      calloc.free(ptr);
+    }
+  }
+
+  /// Encodes one integer [record] into every record position.
+  ///
+  /// Adding or multiplying a packed [Ciphertext] by the result applies
+  /// the same operand to every record.
+  Plaintext packReplicatedInt(List<int> record) {
+    final ptr = _flatten<Uint64>([record], (n) => calloc<Uint64>(n),
+        (p, i, v) => p[i] = v.toInt());
+    final pt = _c_pack_replicated_int(fhe.library, obj, ptr);
+    calloc.free(ptr);
+    raiseForStatus();
+    return Plaintext.fromPointer(fhe.backend, pt, extractStr: false);
+  }
+
+  /// Encodes floating point [records] into a single [Plaintext].
+  Plaintext packDouble(List<List<double>> records) {
+    final ptr = _flatten<Double>(records, (n) => calloc<Double>(n),
+        (p, i, v) => p[i] = v.toDouble());
+    final pt = _c_pack_double(fhe.library, obj, ptr, records.length);
+    calloc.free(ptr);
+    raiseForStatus();
+    return Plaintext.fromPointer(fhe.backend, pt, extractStr: false);
+  }
+
+  /// Decodes [count] floating point records from a packed [Plaintext].
+  List<List<double>> unpackDouble(Plaintext plaintext, int count) {
+    final ptr = calloc<Double>(count * recordSize);
+    _c_unpack_double(fhe.library, obj, plaintext.obj, ptr, count);
+    try {
+      raiseForStatus();
+      final flat = ptr.asTypedList(count * recordSize);
+      return List.generate(count,
+          (r) => flat.sublist(r * recordSize, (r + 1) * recordSize).toList());
+    } finally {
+      calloc.free(ptr);
+    }
+  }
+
+  /// Encodes one floating point [record] into every record position.
+  Plaintext packReplicatedDouble(List<double> record) {
+    final ptr = _flatten<Double>([record], (n) => calloc<Double>(n),
+        (p, i, v) => p[i] = v.toDouble());
+    final pt = _c_pack_replicated_double(fhe.library, obj, ptr);
+    calloc.free(ptr);
+    raiseForStatus();
+    return Plaintext.fromPointer(fhe.backend, pt, extractStr: false);
+  }
+
+  /// Isolates a single [record] of a packed [Ciphertext].
+  ///
+  /// All other slots of the result are zero.
+  /// For CKKS [Scheme], the result is rescaled to the next level.
+  Ciphertext select(Ciphertext ciphertext, int record) {
+    final ptr = _c_select_record(fhe.library, obj, ciphertext.obj, record);
+    raiseForStatus();
+    return Ciphertext.fromPointer(fhe.backend, ptr);
+  }
+
+  /// Deletes the layout; plaintexts and ciphertexts remain valid.
+  void dispose() {
+    _c_delete_packing(obj);
+    obj = nullptr;
+  }
+}
@@ -15,6 +15,13 @@ final _InitPlaintextValue _c_init_plaintext_value = dylib
     .lookup<NativeFunction<_InitPlaintextValueC>>('init_plaintext_value')
     .asFunction();
 
+typedef _DeletePlaintextC = Void Function(Pointer library, Pointer plaintext);
+typedef _DeletePlaintext = void Function(Pointer library, Pointer plaintext);
+
+final _DeletePlaintext _c_delete_plaintext = dylib
+    .lookup<NativeFunction<_DeletePlaintextC>>('delete_plaintext')
+    .asFunction();
+
 typedef _PlaintextC = Pointer<Utf8> Function(Pointer plaintext);
 
 final _PlaintextC _c_get_plaintext = dylib
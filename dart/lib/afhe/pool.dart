@@ -0,0 +1,251 @@
+/// This file contains the `FhePool` class, running operations on worker isolates.
+part of '../afhe.dart';
+
+/// An operation applied by [FhePool.map] to a [Ciphertext], on a worker isolate.
+///
+/// The [fhe] shares the native backend of the pool, with its context and keys.
+typedef PoolMapOp = Ciphertext Function(Afhe fhe, Ciphertext a);
+
+/// An operation combining two [Ciphertext]s, used by [FhePool.reduce].
+typedef PoolReduceOp = Ciphertext Function(Afhe fhe, Ciphertext a, Ciphertext b);
+
+/// Sent to a worker isolate when it is spawned.
+class _PoolStart {
+  final SendPort reply;
+  final String backend;
+  final String scheme;
+  final int library;
+
+  _PoolStart(this.reply, this.backend, this.scheme, this.library);
+}
+
+/// A batch of ciphertexts, by address, and the operation applied to them.
+class _PoolTask {
+  final int id;
+  final List<int> ctxts;
+  final PoolMapOp? map;
+  final PoolReduceOp? reduce;
+
+  /// Addresses of the caller's ciphertexts, never released by a reduction.
+  final Set<int> keep;
+
+  _PoolTask(this.id, this.ctxts, {this.map, this.reduce, this.keep = const {}});
+}
+
+/// The addresses of the resulting ciphertexts, or the error raised by the task.
+class _PoolResult {
+  final int id;
+  final List<int> ctxts;
+  final Object? error;
+
+  _PoolResult(this.id, this.ctxts, this.error);
+}
+
+/// Entry point of a worker isolate.
+void _poolWorker(_PoolStart start) {
+  final fhe = Afhe.fromAddress(start.backend, start.scheme, start.library);
+  final tasks = ReceivePort();
+  start.reply.send(tasks.sendPort);
+
+  tasks.listen((message) {
+    final task = message as _PoolTask;
+    try {
+      final ctxts = [
+        for (final address in task.ctxts)
+          Ciphertext.fromPointer(fhe.backend, Pointer.fromAddress(address))
+      ];
+      final results = task.map != null
+          ? [for (final ctxt in ctxts) task.map!(fhe, ctxt)]
+          : [_reduceChunk(fhe, ctxts, task.reduce!, task.keep)];
+      start.reply.send(
+          _PoolResult(task.id, [for (final res in results) res.obj.address], null));
+    } catch (e) {
+      start.reply.send(_PoolResult(task.id, const [], e));
+    }
+  });
+}
+
+/// Reduces [ctxts] with [op], releasing every operand once consumed,
+/// except the caller's ciphertexts in [keep] and the result.
+Ciphertext _reduceChunk(
+    Afhe fhe, List<Ciphertext> ctxts, PoolReduceOp op, Set<int> keep) {
+  final released = <int>{};
+  void consume(Ciphertext ctxt, [Ciphertext? result]) {
+    final address = ctxt.obj.address;
+    if (keep.contains(address) || address == result?.obj.address) return;
+    // The same intermediate may be returned for several operands
+    if (released.add(address)) fhe.release(ctxt);
+  }
+
+  var acc = ctxts.first;
+  var i = 1;
+  try {
+    for (; i < ctxts.length; i++) {
+      final next = op(fhe, acc, ctxts[i]);
+      consume(acc, next);
+      consume(ctxts[i], next);
+      acc = next;
+    }
+    return acc;
+  } catch (e) {
+    consume(acc);
+    for (; i < ctxts.length; i++) {
+      consume(ctxts[i]);
+    }
+    rethrow;
+  }
+}
+
+/// A pool of worker isolates sharing a single native backend.
+///
+/// Each worker holds an [Afhe] over the same native object, so the context
+/// and keys are set up once, then shared by every worker. Ciphertexts move
+/// between isolates by the address of their native object, without serialization.
+///
+/// Only evaluation operations (add, multiply, rotate, ...) may run concurrently;
+/// keys and context must not change while the pool is running. Operations are
+/// sent to the workers, so they must not capture native objects: use the [Afhe]
+/// and [Ciphertext]s they receive.
+///
+class FhePool {
+  /// The backend shared by every worker.
+  final Afhe fhe;
+
+  final ReceivePort _results = ReceivePort();
+  final List<Isolate> _isolates = [];
+  final List<SendPort> _workers = [];
+  final Map<int, Completer<List<int>>> _pending = {};
+  int _nextTask = 0;
+
+  FhePool._(this.fhe);
+
+  /// Spawns [size] worker isolates sharing the native backend of [fhe].
+  ///
+  /// Defaults to one worker per processor.
+  static Future<FhePool> spawn(Afhe fhe, {int? size}) async {
+    final count = size ?? Platform.numberOfProcessors;
+    if (count < 1) {
+      throw ArgumentError('FhePool requires at least one worker');
+    }
+    final pool = FhePool._(fhe);
+    final ready = Completer<void>();
+    pool._results.listen((message) {
+      if (message is SendPort) {
+        pool._workers.add(message);
+        if (pool._workers.length == count) ready.complete();
+      } else if (message is _PoolResult) {
+        final task = pool._pending.remove(message.id)!;
+        if (message.error != null) {
+          task.completeError(message.error!);
+        } else {
+          task.complete(message.ctxts);
+        }
+      } else if (message is List && !ready.isCompleted) {
+        // Uncaught error while starting a worker: [error, stackTrace]
+        ready.completeError(Exception(message[0]));
+      }
+    });
+    for (var i = 0; i < count; i++) {
+      pool._isolates.add(await Isolate.spawn(
+          _poolWorker,
+          _PoolStart(pool._results.sendPort, fhe.backend.name, fhe.scheme.name,
+              fhe.library.address),
+          onError: pool._results.sendPort));
+    }
+    await ready.future;
+    return pool;
+  }
+
+  /// The number of worker isolates.
+  int get size => _workers.length;
+
+  /// Applies [op] to every [Ciphertext] in [ctxts], across the workers.
+  ///
+  /// Returns the results in the order of [ctxts].
+  Future<List<Ciphertext>> map(List<Ciphertext> ctxts, PoolMapOp op) async {
+    final chunks = _split(ctxts, 1);
+    final results = await Future.wait(
+        [for (var w = 0; w < chunks.length; w++) _run(w, chunks[w], map: op)]);
+    return [
+      for (final chunk in results)
+        for (final address in chunk) _fromAddress(address)
+    ];
+  }
+
+  /// Combines every [Ciphertext] in [ctxts] with [op], across the workers.
+  ///
+  /// Each worker reduces a contiguous chunk, then partial results are reduced
+  /// again until one remains, so [op] should be associative.
+  /// Intermediate results are released once consumed; [ctxts] are left to the caller.
+  Future<Ciphertext> reduce(List<Ciphertext> ctxts, PoolReduceOp op) async {
+    if (ctxts.isEmpty) {
+      throw ArgumentError('reduce requires at least one ciphertext');
+    }
+    final inputs = {for (final ctxt in ctxts) ctxt.obj.address};
+    var partial = ctxts;
+    while (partial.length > 1) {
+      final chunks = _split(partial, 2);
+      final results = await Future.wait([
+        for (var w = 0; w < chunks.length; w++)
+          _run(w, chunks[w], reduce: op, keep: {
+            for (final ctxt in chunks[w])
+              if (inputs.contains(ctxt.obj.address)) ctxt.obj.address
+          })
+      ], cleanUp: (List<int> chunk) {
+        // Partial results of the other workers, when one of them fails
+        if (!inputs.contains(chunk.single)) fhe.release(_fromAddress(chunk.single));
+      });
+      partial = [for (final chunk in results) _fromAddress(chunk.single)];
+    }
+    return partial.single;
+  }
+
+  /// Stops every worker isolate.
+  ///
+  /// The shared backend is owned by [fhe], and remains usable.
+  void close() {
+    for (final isolate in _isolates) {
+      isolate.kill(priority: Isolate.immediate);
+    }
+    _results.close();
+    for (final task in _pending.values) {
+      task.completeError(StateError('FhePool is closed'));
+    }
+    _pending.clear();
+    _isolates.clear();
+    _workers.clear();
+  }
+
+  /// Splits [ctxts] into one contiguous chunk per worker, of at least [minChunk].
+  List<List<Ciphertext>> _split(List<Ciphertext> ctxts, int minChunk) {
+    if (_workers.isEmpty) {
+      throw StateError('FhePool is closed');
+    }
+    var chunk = (ctxts.length / _workers.length).ceil();
+    if (chunk < minChunk) chunk = minChunk;
+    return [
+      for (var i = 0; i < ctxts.length; i += chunk)
+        ctxts.sublist(i, i + chunk < ctxts.length ? i + chunk : ctxts.length)
+    ];
+  }
+
+  Future<List<int>> _run(int worker, List<Ciphertext> ctxts,
+      {PoolMapOp? map, PoolReduceOp? reduce, Set<int> keep = const {}}) {
+    final id = _nextTask++;
+    final done = Completer<List<int>>();
+    _pending[id] = done;
+    try {
+      _workers[worker].send(_PoolTask(
+          id, [for (final ctxt in ctxts) ctxt.obj.address],
+          map: map, reduce: reduce, keep: keep));
+    } catch (e) {
+      // Operations capturing native objects cannot be sent
+      _pending.remove(id);
+      rethrow;
+    }
+    return done.future;
+  }
+
+  Ciphertext _fromAddress(int address) =>
+      Ciphertext.fromPointer(fhe.backend, Pointer.fromAddress(address));
+}
@@ -83,9 +83,9 @@ class SealKey extends Key {
   /// The [fhe] library is used to validate the serialized data
   /// The [serialData] is the serialized data of [serialSize] bytes
   @override
-  void load(Pointer fhe, Pointer<Uint8> serialData, int serialSize) {
+  void load(Pointer fhe, Pointer<Uint8> serialData, int serialSize, {bool trusted = false}) {
     sealMagicNumber(serialData, serialSize);
-    super.load(fhe, serialData, serialSize);
+    super.load(fhe, serialData, serialSize, trusted: trusted);
   }
 
   /// Save the key to a serialized data
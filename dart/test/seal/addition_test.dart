@@ -5,6 +5,7 @@ import 'package:test/test.dart';
 import 'package:fhel/seal.dart' show Seal;
 import 'test_utils.dart';
 import 'dart:math';
+import 'dart:typed_data';
 
 
 const schemes = ['bgv', 'bfv'];
@@ -158,4 +159,28 @@ void main() {
       near(actual_cipher[i], expected[i], eps: 1e-7);
     }
   });
+
+  test("Complex Addition", () {
+    final fhe = Seal('ckks');
+    Map ctx = {
+      'polyModDegree': 8192,
+      'encodeScalar': pow(2, 40),
+      'qSizes': [60, 40, 40, 60]
+    };
+    fhe.genContext(ctx);
+    fhe.genKeys();
+
+    // Two real vectors packed as interleaved (real, imaginary) pairs
+    final x = Float64List.fromList([1.0, -1.0, 2.0, -2.0, 3.0, -3.0]);
+    final ct_x = fhe.encrypt(fhe.encodeVecComplex(x));
+
+    final add = Float64List.fromList([0.5, 0.25, 0.5, 0.25, 0.5, 0.25]);
+    final ct_res = fhe.addPlain(ct_x, fhe.encodeVecComplex(add));
+    final actual = fhe.decodeVecComplex(fhe.decrypt(ct_res), 3);
+
+    expect(actual.length, 6);
+    for (int i = 0; i < actual.length; i++) {
+      near(actual[i], x[i] + add[i], eps: 1e-7);
+    }
+  });
 }
@@ -69,6 +69,57 @@ void main() {
             e.message == 'qSizes must be a list of integers')));
   });
 
+  test('Custom Coefficient Modulus', () {
+    for (var sch in schemes) {
+      final fhe = Seal(sch);
+      final context = fhe.genContext({
+        'polyModDegree': 8192,
+        'ptModBit': 20,
+        'secLevel': 128,
+        'qSizes': [50, 50, 50]
+      });
+      expect(context, "success: valid");
+    }
+  });
+
+  test('Insecure Coefficient Modulus', () {
+    for (var sch in schemes) {
+      final fhe = Seal(sch);
+      final context = fhe.genContext({
+        'polyModDegree': 4096,
+        'ptModBit': 20,
+        'secLevel': 128,
+        'qSizes': [60, 60]
+      });
+      expect(
+          context,
+          "invalid_argument: coeff_modulus bit count (120) "
+          "exceeds the maximum (109) for the security level");
+    }
+  });
+
+  test('PRNG Selection', () {
+    for (var prng in ['default', 'blake2xb', 'shake256']) {
+      final fhe = Seal('bfv');
+      final context = fhe.genContext({
+        'polyModDegree': 8192,
+        'ptModBit': 20,
+        'secLevel': 128,
+        'prng': prng
+      });
+      expect(context, "success: valid");
+      fhe.genKeys();
+
+      final ctx = fhe.encryptVecInt([1, 2, 3]);
+      expect(fhe.decryptVecInt(ctx, 3), [1, 2, 3]);
+    }
+
+    final fhe = Seal('bfv');
+    expect(() => fhe.setPrng('md5'),
+        throwsA(predicate((e) => e is Exception &&
+            e.toString() == 'Exception: Unsupported PRNG: md5')));
+  });
+
   /* TODO: Security level is not checked during parameter validation */
   // However, there are only 3 options: 128, 192, 256 in SEAL
   // test('Invalid Security Level', () {
@@ -24,6 +24,11 @@ void main() {
       // Check invariant noise budget
       expect(fhe.invariantNoiseBudget(ciphertext), lessThanOrEqualTo(53));
 
+      // Estimated without the secret key, never above the measured budget
+      final estimate = fhe.estimateNoiseBudget(ciphertext);
+      expect(estimate, greaterThan(0));
+      expect(estimate, lessThanOrEqualTo(fhe.invariantNoiseBudget(ciphertext)));
+
       // Validate that hexidecimal are equal
       expect(decrypted.text.toLowerCase(), pt.toLowerCase());
 
@@ -60,4 +65,52 @@ void main() {
       }
     }
   });
+
+  test('Fused Encrypt List<int>', () {
+    for (var sch in schemes) {
+      final fhe = Seal(sch);
+      final context = fhe.genContext(
+        {'polyModDegree': 8192, 'ptModBit': 20, 'ptMod': 0, 'secLevel': 128});
+      expect(context, "success: valid");
+      fhe.genKeys();
+
+      List<int> vec = [1, 2, 3, 4];
+
+      // Encode + Encrypt, Decrypt + Decode in a single call each
+      final ctx = fhe.encryptVecInt(vec);
+      final res = fhe.decryptVecInt(ctx, 4);
+
+      expect(res.length, 4);
+      for (int i = 0; i < res.length; i++) {
+        expect(res[i], vec[i]);
+      }
+    }
+  });
+
+  test('Encrypt Many List<int>', () {
+    for (var sch in schemes) {
+      final fhe = Seal(sch);
+      final context = fhe.genContext(
+        {'polyModDegree': 8192, 'ptModBit': 20, 'ptMod': 0, 'secLevel': 128});
+      expect(context, "success: valid");
+
+      // Requires the public key
+      expect(() => fhe.encryptMany([fhe.encodeVecInt([1])]),
+          throwsA(predicate((e) => e is Exception &&
+              e.toString() == 'Exception: PublicKey must be set to encrypt')));
+
+      fhe.genKeys();
+      final ptxts = [
+        for (var i = 0; i < 8; i++) fhe.encodeVecInt([i, i + 1, i + 2])
+      ];
+
+      // Results keep the order of the plaintexts
+      final ctxts = fhe.encryptMany(ptxts);
+      expect(ctxts.length, ptxts.length);
+      for (var i = 0; i < ctxts.length; i++) {
+        expect(fhe.decryptVecInt(ctxts[i], 3), [i, i + 1, i + 2]);
+      }
+      expect(fhe.encryptMany([]), isEmpty);
+    }
+  });
 }
@@ -2,7 +2,7 @@
 
 import 'dart:math';
 import 'package:test/test.dart';
-import 'package:fhel/seal.dart' show Seal;
+import 'package:fhel/seal.dart' show Seal, SealKey;
 import 'package:fhel/afhe.dart' show Plaintext, Ciphertext;
 import 'dart:ffi' show Pointer, Uint8;
 import 'test_utils.dart' show near;
@@ -190,4 +190,49 @@ void main() {
       near(vec_res[i], dec_vec_h_d[i]);
     }
   });
+
+  test("Compact Ciphertext", () {
+    final fhe = Seal('bfv');
+    String ctx = fhe.genContext(
+        {'polyModDegree': 8192, 'ptModBit': 20, 'secLevel': 128});
+    expect(ctx, 'success: valid');
+    fhe.genKeys();
+
+    final ct = fhe.encrypt(fhe.encodeVecInt([1, 2, 3, 4]));
+    int fullSize = ct.saveSize;
+
+    // Fewer primes left, fewer bytes to send
+    expect(fhe.compactForTransfer(ct), greaterThan(0));
+    expect(ct.saveSize, lessThan(fullSize));
+    expect(fhe.decodeVecInt(fhe.decrypt(ct), 4), [1, 2, 3, 4]);
+  });
+
+  test("Evaluation Keys", () {
+    for (var sch in ['bgv', 'bfv']) {
+      final host = Seal(sch);
+      String h_ctx = host.genContext(
+          {'polyModDegree': 8192, 'ptModBit': 20, 'secLevel': 128});
+      expect(h_ctx, 'success: valid');
+      host.genKeys();
+      host.genRelinKeys();
+
+      // Host shares parameters, relinearization keys and a ciphertext
+      Map h_param = host.saveParameters();
+      SealKey rk = host.relinKeys;
+      rk.save();
+      final ct = host.encrypt(host.encodeVecInt([1, 2, 3, 4]));
+
+      // Guest installs the stored keys, without generating any
+      final guest = Seal.noScheme();
+      expect(guest.genContextFromParameters(h_param), 'success: valid');
+      SealKey rkLoad = SealKey.ofType(rk);
+      rkLoad.load(guest.library, rk.serialized, rk.size, trusted: true);
+      guest.setKey(rkLoad);
+
+      final ct_g = guest.loadCiphertext(ct.save(), ct.saveSize);
+      final ct_sq = guest.relinearize(guest.multiply(ct_g, ct_g));
+      expect(ct_sq.size, 2);
+      expect(host.decodeVecInt(host.decrypt(ct_sq), 4), [1, 4, 9, 16]);
+    }
+  });
 }
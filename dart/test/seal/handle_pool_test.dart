@@ -0,0 +1,37 @@
+import 'package:test/test.dart';
+import 'package:fhel/seal.dart' show Seal;
+
+void main() {
+  test('Release Ciphertext and Plaintext', () {
+    final fhe = Seal('bfv');
+    String status = fhe.genContext({
+      'polyModDegree': 4096,
+      'ptModBit': 20,
+      'secLevel': 128
+    });
+    expect(status, 'success: valid');
+    fhe.genKeys();
+
+    final ct = fhe.encrypt(fhe.encodeVecInt([1, 2]));
+    final sum = fhe.add(ct, ct);
+    final address = sum.obj.address;
+
+    // The released ciphertext is recycled by the next result
+    fhe.release(sum);
+    expect(sum.obj.address, 0);
+    final again = fhe.add(ct, ct);
+    expect(again.obj.address, address);
+
+    final pt = fhe.decrypt(again);
+    expect(fhe.decodeVecInt(pt, 2), [2, 4]);
+    fhe.releasePlaintext(pt);
+
+    fhe.poolCapacity = 0;
+    expect(() => fhe.poolCapacity = -1,
+        throwsA(predicate((e) => e is Exception &&
+            e.toString() == 'Exception: Pool capacity must not be negative')));
+
+    fhe.release(again);
+    fhe.release(ct);
+  });
+}
@@ -2,6 +2,7 @@ import 'dart:ffi';
 import 'dart:math';
 import 'package:test/test.dart';
 import 'package:fhel/seal.dart' show Seal, SealKey;
+import 'package:fhel/afhe.dart' show KeyCache;
 
 // Scheme Parameters
 
@@ -102,6 +103,13 @@ void main() {
       // Load Relin Key
       rkLoad.load(fhe.library, rk.serialized, rk.size);
       expect(rk.data, rkLoad.data);
+
+      // Loaded keys have the same fingerprint
+      expect(pkLoad.fingerprint, pk.fingerprint);
+      expect(skLoad.fingerprint, sk.fingerprint);
+      expect(rkLoad.fingerprint, rk.fingerprint);
+      expect(pk.fingerprint, isNot(sk.fingerprint));
+      expect(rk.fingerprint, isNot(pk.fingerprint));
     });
   });
 
@@ -166,4 +174,38 @@ void main() {
       expect(rkHostData, isNot(rkGuestData));
     });
   });
+
+  test("Key Cache", () {
+    final host = Seal('bfv');
+    host.genContext(bv);
+    host.genKeys();
+    host.genRelinKeys();
+    Map params = host.saveParameters();
+    SealKey rk = host.relinKeys;
+    rk.save();
+
+    final cache = KeyCache(64 << 20);
+
+    // Each request attaches the tenant's keys to its own handle
+    final first = Seal.noScheme();
+    first.genContextFromParameters(params);
+    int cacheId = cache.load(first, 'relin', rk.serialized, rk.size);
+
+    final second = Seal.noScheme();
+    second.genContextFromParameters(params);
+    expect(cache.load(second, 'relin', rk.serialized, rk.size), cacheId);
+    expect(cache.count, 1);
+    expect(cache.memorySize, rk.size);
+
+    final third = Seal.noScheme();
+    third.genContextFromParameters(params);
+    expect(cache.attach(third, cacheId), true);
+    expect(cache.attach(third, cacheId + 1), false);
+
+    final ct = host.encrypt(host.encodeVecInt([1, 2, 3]));
+    final ct_sq = third.relinearize(third.multiply(ct, ct));
+    expect(host.decodeVecInt(host.decrypt(ct_sq), 3), [1, 4, 9]);
+
+    cache.dispose();
+  });
 }
@@ -0,0 +1,85 @@
+import 'dart:math';
+import 'package:test/test.dart';
+import 'package:fhel/afhe.dart' show PlainMatrix;
+import 'package:fhel/seal.dart' show Seal;
+import 'test_utils.dart';
+
+const schemes = ['bgv', 'bfv'];
+
+void main() {
+  test('Rotate', () {
+    final fhe = Seal('bfv');
+    fhe.genContext({'polyModDegree': 8192, 'ptModBit': 20, 'secLevel': 128});
+    fhe.genKeys();
+    fhe.genGaloisKeys([1]);
+
+    final ct = fhe.encryptVecInt([1, 2, 3, 4]);
+    final result = fhe.decryptVecInt(fhe.rotate(ct, 1), 4);
+    expect(result, [2, 3, 4, 0]);
+  });
+
+  test('Integer Matrix', () {
+    for (var sch in schemes) {
+      final fhe = Seal(sch);
+      fhe.genContext({'polyModDegree': 8192, 'ptModBit': 20, 'secLevel': 128});
+      fhe.genKeys();
+
+      final matrix = [
+        [1, 2, 3, 4],
+        [5, 6, 7, 8],
+        [9, 10, 11, 12],
+        [13, 14, 15, 16],
+      ];
+      final mat = PlainMatrix.fromInt(fhe, matrix);
+      expect(mat.dim, 4);
+      fhe.genGaloisKeys(mat.rotationSteps);
+
+      // Vector is replicated with period dim across every slot
+      final vec = [1, 0, 2, 1];
+      final slots = List.generate(fhe.slotCount, (i) => vec[i % mat.dim]);
+      final result = fhe.decryptVecInt(
+          mat.multiply(fhe.encryptVecInt(slots)), mat.dim);
+
+      for (var r = 0; r < matrix.length; r++) {
+        var expected = 0;
+        for (var c = 0; c < vec.length; c++) {
+          expected += matrix[r][c] * vec[c];
+        }
+        expect(result[r], expected);
+      }
+      mat.dispose();
+    }
+  });
+
+  test('Double Matrix', () {
+    final fhe = Seal('ckks');
+    fhe.genContext({
+      'polyModDegree': 8192,
+      'encodeScalar': pow(2, 40),
+      'qSizes': [60, 40, 40, 60]
+    });
+    fhe.genKeys();
+
+    final matrix = [
+      [0.5, -1.0, 0.0],
+      [2.0, 0.25, 1.5],
+    ];
+    final mat = PlainMatrix.fromDouble(fhe, matrix);
+    expect(mat.dim, 4);
+    fhe.genGaloisKeys(mat.rotationSteps);
+
+    final vec = [1.0, 2.0, -0.5, 0.0];
+    final slots = List.generate(fhe.slotCount, (i) => vec[i % mat.dim]);
+    final result = fhe.decryptVecDouble(
+        mat.multiply(fhe.encryptVecDouble(slots)), mat.dim);
+
+    near(result[0], -1.5, eps: 1e-5);
+    near(result[1], 1.75, eps: 1e-5);
+    near(result[2], 0.0, eps: 1e-5);
+    mat.dispose();
+
+    // Integer matrices are not supported by CKKS
+    expect(() => PlainMatrix.fromInt(fhe, [[1, 2], [3, 4]]),
+        throwsA(isA<Exception>()));
+  });
+}
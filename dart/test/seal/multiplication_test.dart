@@ -191,4 +191,96 @@ void main() {
           product[i]);
     }
   });
+
+  test("List<double> Polynomial", () {
+    Map ctx = {
+      'polyModDegree': 16384,
+      'encodeScalar': pow(2, 40),
+      'qSizes': [60, 40, 40, 40, 40, 40, 60]
+    };
+    List<double> x = [-0.75, -0.25, 0.5, 1.0];
+    List<double> coeffs = [0.5, 0.197, 0.0, -0.004, 0.0, 0.0, 0.0, 0.25];
+    int arr_len = x.length;
+
+    final fhe = Seal('ckks');
+    String status = fhe.genContext(ctx);
+    expect(status, 'success: valid');
+    fhe.genKeys();
+    fhe.genRelinKeys();
+
+    final ct_x = fhe.encrypt(fhe.encodeVecDouble(x));
+    final ct_res = fhe.evalPolynomial(ct_x, coeffs);
+    final result = fhe.decodeVecDouble(fhe.decrypt(ct_res), arr_len);
+
+    for (int i = 0; i < arr_len; i++) {
+      double expected = 0.0;
+      for (int j = coeffs.length - 1; j >= 0; j--) {
+        expected = expected * x[i] + coeffs[j];
+      }
+      near(eps: 1e-3, result[i], expected);
+    }
+  });
+
+  test("List<int> Add and Multiply Many", () {
+    Map<String, int> ctx = {
+      'polyModDegree': 8192,
+      'ptModBit': 20,
+      'secLevel': 128
+    };
+
+    for (var sch in schemes) {
+      final fhe = Seal(sch);
+      String status = fhe.genContext(ctx);
+      expect(status, 'success: valid');
+      fhe.genKeys();
+      fhe.genRelinKeys();
+
+      final cts = [
+        for (var i = 1; i <= 5; i++) fhe.encrypt(fhe.encodeVecInt([i, 2]))
+      ];
+      expect(fhe.decodeVecInt(fhe.decrypt(fhe.addMany(cts)), 2), [15, 10]);
+      expect(
+          fhe.decodeVecInt(fhe.decrypt(fhe.multiplyMany(cts)), 2), [120, 32]);
+    }
+  });
+
+  test("List<double> Levels", () {
+    final fhe = Seal('ckks');
+    String status = fhe.genContext({
+      'polyModDegree': 8192,
+      'encodeScalar': pow(2, 40),
+      'qSizes': [60, 40, 40, 60]
+    });
+    expect(status, 'success: valid');
+    fhe.genKeys();
+    fhe.genRelinKeys();
+
+    final costs = fhe.levelCosts;
+    expect(costs.length, 3);
+    expect([for (var c in costs) c.primes], [3, 2, 1]);
+    expect(costs[0].multiply, 1.0);
+    expect(costs[2].keySwitch < costs[1].keySwitch, true);
+
+    final ct = fhe.encrypt(fhe.encodeVecDouble([1.5, -2.0]));
+    expect(fhe.level(ct), 0);
+    expect(fhe.chainIndex(ct), 2);
+    expect(fhe.coeffModulusCount(ct), 3);
+
+    // Rescaling drops a level and divides the scale
+    final sq = fhe.relinearize(fhe.square(ct));
+    final scale = sq.scale;
+    fhe.rescaleToNext(sq);
+    expect(fhe.level(sq), 1);
+    expect(sq.scale < scale, true);
+
+    // Mod switching keeps the scale
+    fhe.modSwitchToLevel(ct, 2);
+    expect(fhe.coeffModulusCount(ct), 1);
+    expect(ct.scale, pow(2, 40));
+    final res = fhe.decodeVecDouble(fhe.decrypt(ct), 2);
+    expect(res[0], closeTo(1.5, 1e-4));
+    expect(res[1], closeTo(-2.0, 1e-4));
+
+    expect(() => fhe.modSwitchToLevel(ct, 1), throwsA(isA<Exception>()));
+  });
 }
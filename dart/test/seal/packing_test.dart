@@ -0,0 +1,110 @@
+import 'dart:math';
+import 'package:test/test.dart';
+import 'package:fhel/afhe.dart' show Packing;
+import 'package:fhel/seal.dart' show Seal;
+import 'test_utils.dart';
+
+const schemes = ['bgv', 'bfv'];
+
+void main() {
+  test('Integer Records', () {
+    for (var sch in schemes) {
+      final fhe = Seal(sch);
+      fhe.genContext({'polyModDegree': 8192, 'ptModBit': 20, 'secLevel': 128});
+      fhe.genKeys();
+
+      final packing = Packing(fhe, 12);
+      expect(packing.capacity, 8192 ~/ 16);
+
+      final records = List.generate(
+          100, (r) => List.generate(12, (i) => (r * 12 + i) % 1000));
+      final ct = fhe.encrypt(packing.packInt(records));
+      final ct_sum = fhe.add(ct, ct);
+
+      final result = packing.unpackInt(fhe.decrypt(ct_sum), records.length);
+      for (var r = 0; r < records.length; r++) {
+        for (var i = 0; i < 12; i++) {
+          expect(result[r][i], records[r][i] * 2);
+        }
+      }
+
+      // Same operand is applied to every record
+      final operand = List.generate(12, (i) => i);
+      final ct_op = fhe.addPlain(ct, packing.packReplicatedInt(operand));
+      final result_op = packing.unpackInt(fhe.decrypt(ct_op), records.length);
+      for (var r = 0; r < records.length; r++) {
+        for (var i = 0; i < 12; i++) {
+          expect(result_op[r][i], records[r][i] + i);
+        }
+      }
+      packing.dispose();
+    }
+  });
+
+  test('Select Record', () {
+    final fhe = Seal('bfv');
+    fhe.genContext({'polyModDegree': 8192, 'ptModBit': 20, 'secLevel': 128});
+    fhe.genKeys();
+
+    final packing = Packing(fhe, 8);
+    final records = List.generate(4, (r) => List.filled(8, r + 1));
+    final ct = fhe.encrypt(packing.packInt(records));
+
+    final result = packing.unpackInt(fhe.decrypt(packing.select(ct, 2)), 4);
+    expect(result[0], List.filled(8, 0));
+    expect(result[2], List.filled(8, 3));
+    packing.dispose();
+  });
+
+  test('Select Double Record', () {
+    final fhe = Seal('ckks');
+    fhe.genContext({
+      'polyModDegree': 8192,
+      'encodeScalar': pow(2, 40),
+      'qSizes': [60, 40, 40, 60]
+    });
+    fhe.genKeys();
+
+    final packing = Packing(fhe, 8);
+    final records = List.generate(4, (r) => List.filled(8, r + 1.5));
+    final ct = fhe.encrypt(packing.packDouble(records));
+
+    // Rescaled, the result decodes at the scale of the input
+    final result = packing.unpackDouble(fhe.decrypt(packing.select(ct, 2)), 4);
+    for (var i = 0; i < 8; i++) {
+      near(result[0][i], 0.0, eps: 1e-3);
+      near(result[2][i], 3.5, eps: 1e-3);
+    }
+    packing.dispose();
+  });
+
+  test('Double Records', () {
+    final fhe = Seal('ckks');
+    fhe.genContext({
+      'polyModDegree': 8192,
+      'encodeScalar': pow(2, 40),
+      'qSizes': [60, 40, 40, 60]
+    });
+    fhe.genKeys();
+
+    final packing = Packing(fhe, 8);
+    final records =
+        List.generate(50, (r) => List.generate(8, (i) => (r * 8 + i) * 0.25));
+    final ct = fhe.encrypt(packing.packDouble(records));
+
+    final result = packing.unpackDouble(fhe.decrypt(ct), records.length);
+    for (var r = 0; r < records.length; r++) {
+      for (var i = 0; i < 8; i++) {
+        near(result[r][i], records[r][i], eps: 1e-5);
+      }
+    }
+  });
+
+  test('Record Size', () {
+    final fhe = Seal('bfv');
+    fhe.genContext({'polyModDegree': 8192, 'ptModBit': 20, 'secLevel': 128});
+    expect(() => Packing(fhe, 8193), throwsA(isA<Exception>()));
+    expect(() => Packing(fhe, 0), throwsA(isA<Exception>()));
+    expect(() => Packing(fhe, -1), throwsA(isA<Exception>()));
+  });
+}
@@ -0,0 +1,57 @@
+import 'package:fhel/afhe.dart';
+import 'package:test/test.dart';
+import 'package:fhel/seal.dart' show Seal;
+
+const schemes = ['bgv', 'bfv'];
+
+Ciphertext square(Afhe fhe, Ciphertext a) => fhe.relinearize(fhe.square(a));
+
+Ciphertext add(Afhe fhe, Ciphertext a, Ciphertext b) => fhe.add(a, b);
+
+Ciphertext rotateMissingKeys(Afhe fhe, Ciphertext a) => fhe.rotate(a, 1);
+
+void main() {
+  test("List<int> Pool Map and Reduce", () async {
+    Map<String, int> ctx = {
+      'polyModDegree': 8192,
+      'ptModBit': 20,
+      'secLevel': 128
+    };
+
+    for (var sch in schemes) {
+      final fhe = Seal(sch);
+      String status = fhe.genContext(ctx);
+      expect(status, 'success: valid');
+      fhe.genKeys();
+      fhe.genRelinKeys();
+
+      final pool = await FhePool.spawn(fhe, size: 3);
+      expect(pool.size, 3);
+
+      final cts = [
+        for (var i = 1; i <= 8; i++) fhe.encrypt(fhe.encodeVecInt([i, 2]))
+      ];
+
+      // Results keep the order of the inputs
+      final squares = await pool.map(cts, square);
+      for (var i = 0; i < cts.length; i++) {
+        expect(fhe.decodeVecInt(fhe.decrypt(squares[i]), 2), [(i + 1) * (i + 1), 4]);
+      }
+
+      final sum = await pool.reduce(cts, add);
+      expect(fhe.decodeVecInt(fhe.decrypt(sum), 2), [36, 16]);
+
+      // Intermediate results are released, the inputs are left intact
+      for (var i = 0; i < cts.length; i++) {
+        expect(fhe.decodeVecInt(fhe.decrypt(cts[i]), 2), [i + 1, 2]);
+      }
+
+      // Errors raised by a worker are forwarded to the caller
+      await expectLater(pool.map(cts, rotateMissingKeys),
+          throwsA(predicate((e) => e is Exception &&
+              e.toString() == 'Exception: GaloisKeys must be set to perform rotation')));
+
+      pool.close();
+    }
+  });
+}
@@ -10,12 +10,17 @@
 #define AFHE_H
 
 #include <string>  /* string class */
+#include <string_view> /* string_view */
 #include <cstdint> /* uint64_t */
 #include <vector>  /* vector */
+#include <complex> /* complex */
+#include <memory>  /* shared_ptr */
+#include <atomic>  /* atomic */
 
 // Forward Declarations
 class ACiphertext; /* Ciphertext */
 class APlaintext;  /* Plaintext */
+class APlainMatrix; /* Encoded Matrix */
 class Afhe;        /* Abstract Class */
 
 using namespace std;
@@ -58,6 +63,42 @@ enum key : int
   galois_keys = 4, /* Galois Keys */
 };
 
+// ------------------ PRNG Type ------------------
+/**
+ * @brief Enum for the pseudo-random number generator used by encryption and key generation.
+ * @return Integer representing the PRNG type.
+ */
+enum prng : int
+{
+  default_prng = 0, /* Backend Default */
+  blake2xb = 1,     /* BLAKE2Xb */
+  shake256 = 2,     /* SHAKE256 (FIPS 202) */
+};
+
+// ------------------ Compression Type ------------------
+/**
+ * @brief Enum for the compression applied when serializing.
+ * @return Integer representing the compression mode.
+ */
+enum compr_mode : int
+{
+  no_compression = 0, /* Uncompressed */
+  zlib = 1,           /* ZLIB, if enabled in the backend */
+  zstd = 2,           /* Zstandard, if enabled in the backend */
+};
+
+// ------------------ Level Cost ------------------
+/**
+ * @brief Size and relative cost of operations at one level of the modulus chain.
+ */
+struct level_cost
+{
+  int primes;          /* Primes in the coefficient modulus */
+  double log2_modulus; /* Bits of the coefficient modulus */
+  double multiply;     /* Cost of a product, relative to the top level */
+  double key_switch;   /* Cost of relinearization or rotation, relative to the top level */
+};
+
 // ------------------ Abstractions ------------------
 /**
  * @brief Abstraction for FHE Context
@@ -73,8 +114,11 @@ public:
  */
 class APlaintext {
 public:
+  explicit APlaintext(backend lib = backend::no_backend) : backend_lib(lib) {}
   virtual ~APlaintext() = default;
 
+  backend backend_lib; /* The backend library owning the plaintext, checked before casting. */
+
   /**
    * @brief Returns a string representation of the plaintext.
   */
@@ -86,8 +130,11 @@ public:
  */
 class ACiphertext{
 public:
+  explicit ACiphertext(backend lib = backend::no_backend) : backend_lib(lib) {}
   virtual ~ACiphertext() = default;
 
+  backend backend_lib; /* The backend library owning the ciphertext, checked before casting. */
+
   /**
    * @brief Returns the size of the ciphertext.
   */
@@ -106,19 +153,35 @@ public:
   /**
    * @brief Saves the ciphertext.
   */
-  virtual string save(string compression_mode="none") = 0;
+  virtual string save(compr_mode compression_mode = compr_mode::no_compression) = 0;
 
   /**
    * @brief Calucate the save size of the ciphertext.
   */
-  virtual int save_size(string compression_mode="none") = 0;
+  virtual int save_size(compr_mode compression_mode = compr_mode::no_compression) = 0;
 
   /**
    * @brief Loads the ciphertext.
    * @param fhe The backend library to be used to validate the ciphertext.
    * @param ctxt The ciphertext to be loaded.
   */
-  virtual void load(Afhe* fhe, string ctxt) = 0;
+  virtual void load(Afhe* fhe, string_view ctxt) = 0;
+
+  /**
+   * @brief Saves the ciphertext into a caller-provided buffer, without an intermediate copy.
+   * @param out The buffer, of at least save_size(compression_mode) bytes.
+   * @param size The size of the buffer.
+   * @return The number of bytes written.
+  */
+  virtual int save_inplace(byte* out, int size, compr_mode compression_mode = compr_mode::no_compression) = 0;
+
+  /**
+   * @brief Loads the ciphertext from a buffer, without an intermediate copy.
+   * @param fhe The backend library to be used to validate the ciphertext.
+   * @param in The serialized ciphertext.
+   * @param size The size of the serialized ciphertext.
+  */
+  virtual void load_inplace(Afhe* fhe, const byte* in, int size) = 0;
 };
 
 /**
@@ -126,8 +189,18 @@ public:
 */
 class AKey {
 public:
+  AKey() = default;
   virtual ~AKey() = default;
 
+  /**
+   * @brief Copies recompute their fingerprint, from their own key material.
+  */
+  AKey(const AKey &) {}
+  AKey& operator=(const AKey &) {
+    reset_fingerprint();
+    return *this;
+  }
+
   /**
    * @brief Saves the key.
    * @return A string representation of the key.
@@ -145,7 +218,17 @@ public:
    * @param fhe The backend library to validate the key.
    * @param key The key to be loaded.
   */
-  virtual void load(Afhe* fhe, string key) = 0;
+  virtual void load(Afhe* fhe, string_view key) = 0;
+
+  /**
+   * @brief Loads a serialized key from memory, without an intermediate string.
+   * @param fhe The backend library to validate the key.
+   * @param in The serialized key.
+   * @param size The number of bytes in the buffer.
+   * @param trusted If true, skips validating the key against the context.
+   *                Only for keys from a trusted source, e.g. stored by this server.
+  */
+  virtual void load_inplace(Afhe* fhe, const byte* in, int size, bool trusted = false) = 0;
 
   /**
    * @brief Returns the data of the key.
@@ -154,6 +237,76 @@ public:
    *       cannot not be used to recreate the key.
   */
   virtual vector<uint64_t> data() = 0;
+
+  /**
+   * @brief Returns the number of values in data(), without extracting them.
+  */
+  virtual size_t data_size() = 0;
+
+  /**
+   * @brief Returns a 64-bit fingerprint of the key material.
+   *
+   * Hashes the raw coefficients of the key, so equal keys have equal fingerprints
+   * however they were serialized. Computed on the first call and cached;
+   * safe to call concurrently, e.g. on a key shared through a KeyCache.
+  */
+  uint64_t fingerprint() {
+    if (!fingerprinted.load(memory_order_acquire)) {
+      // Concurrent first calls compute the same value
+      cached_fingerprint.store(compute_fingerprint(), memory_order_relaxed);
+      fingerprinted.store(true, memory_order_release);
+    }
+    return cached_fingerprint.load(memory_order_relaxed);
+  }
+
+  /**
+   * @brief Discards the cached fingerprint, once the key material changes.
+  */
+  void reset_fingerprint() {
+    fingerprinted.store(false, memory_order_release);
+  }
+
+protected:
+  /**
+   * @brief Hashes the raw coefficients of the key.
+  */
+  virtual uint64_t compute_fingerprint() = 0;
+
+private:
+  atomic<uint64_t> cached_fingerprint{0};
+  atomic<bool> fingerprinted{false};
+};
+
+/**
+ * @brief Abstraction for a plaintext matrix, encoded for matrix-vector products.
+ *
+ * Holds the generalized diagonals of the matrix, encoded once and reused by
+ * every product with an encrypted vector.
+ */
+class APlainMatrix {
+public:
+  virtual ~APlainMatrix() = default;
+
+  /**
+   * @brief Returns the number of rows of the matrix.
+  */
+  virtual size_t rows() = 0;
+
+  /**
+   * @brief Returns the number of columns of the matrix.
+  */
+  virtual size_t cols() = 0;
+
+  /**
+   * @brief Returns the dimension of the padded square matrix, a power of two.
+  */
+  virtual size_t dim() = 0;
+
+  /**
+   * @brief Returns the rotation steps used by a product with this matrix,
+   *        for which Galois keys must be generated.
+  */
+  virtual vector<int> rotation_steps() = 0;
 };
 
 /**
@@ -173,6 +326,44 @@ public:
 
   backend backend_lib; /* The backend library to be used. */
 
+  // ------------------ Handles ------------------
+  /**
+   * @brief Returns a ciphertext to write a result into, recycled from the pool when available.
+   *
+   * Recycled ciphertexts keep their data buffers, so results of the same shape are written
+   * without reallocating; their contents are unspecified until written.
+   * @return A ciphertext owned by the caller, returned with release().
+  */
+  virtual ACiphertext* acquire_ciphertext() = 0;
+
+  /**
+   * @brief Returns a plaintext to write a result into, recycled from the pool when available.
+   * @return A plaintext owned by the caller, returned with release().
+  */
+  virtual APlaintext* acquire_plaintext() = 0;
+
+  /**
+   * @brief Returns a ciphertext to the pool, or deletes it when the pool is full.
+   * @param ctxt A ciphertext of this backend, not used afterwards.
+   * @throws invalid_argument If the ciphertext belongs to another backend.
+  */
+  virtual void release(ACiphertext* ctxt) = 0;
+
+  /**
+   * @brief Returns a plaintext to the pool, or deletes it when the pool is full.
+   *
+   * The data is cleared, as plaintexts may hold decrypted values.
+   * @param ptxt A plaintext of this backend, not used afterwards.
+   * @throws invalid_argument If the plaintext belongs to another backend.
+  */
+  virtual void release(APlaintext* ptxt) = 0;
+
+  /**
+   * @brief Sets the number of idle ciphertexts and plaintexts each kept for reuse.
+   * @param capacity The maximum of each, zero to delete every released object.
+  */
+  virtual void set_pool_capacity(size_t capacity) = 0;
+
   // ------------------ Parameters ------------------
   /**
    * @brief Generates a context for the Fully Homomorphic Encryption (FHE) scheme.
@@ -185,13 +376,14 @@ public:
    * @param plain_modulus The plaintext modulus, which affects the precision of the computations.
    * @param sec_level The security level, which affects the hardness of the cryptographic problem underlying the FHE scheme.
    * @param qi_sizes (optional) A vector of prime bit sizes for each modulus in the modulus chain.
+   *                 Required for CKKS; for BFV/BGV an empty vector selects the default chain.
    *
    * @return A string representing the status of generated context.
    */
   virtual string ContextGen(
     scheme scheme, uint64_t poly_modulus_degree,
     uint64_t plain_modulus_bit_size, uint64_t plain_modulus,
-    int sec_level, vector<int> qi_sizes = {}) = 0;
+    int sec_level, const vector<int> &qi_sizes = {}) = 0;
 
   /**
    * @brief Generates a context for the Fully Homomorphic Encryption (FHE) scheme from a set of parameters.
@@ -202,28 +394,57 @@ public:
    *
    * @return A string representing the status of generated context.
   */
-  virtual string ContextGen(string params) = 0;
+  virtual string ContextGen(string_view params) = 0;
+
+  /**
+   * @brief Generates a context from serialized parameters, read in place.
+   *
+   * @param params The serialized parameters.
+   * @param size The number of bytes in the buffer.
+   *
+   * @return A string representing the status of generated context.
+  */
+  virtual string ContextGen(const byte* params, int size) = 0;
+
+  /**
+   * @brief Selects the pseudo-random number generator for encryption and key generation.
+   *
+   * Applies to contexts generated afterwards, so it is called before ContextGen.
+   *
+   * @param type The PRNG to be used.
+   */
+  virtual void set_prng(prng type) = 0;
+
+  /**
+   * @brief Returns the selected pseudo-random number generator.
+   */
+  virtual prng get_prng() = 0;
 
   /**
    * @brief Returns the context.
    */
   virtual AContext& get_context() = 0;
 
+  /**
+   * @brief Returns the scheme of the current context.
+   */
+  virtual scheme get_scheme() = 0;
+
   /**
    * @brief Returns the parameters, used for re-generating the context.
   */
-  virtual string save_parameters(string compression_mode="none") = 0;
+  virtual string save_parameters(compr_mode compression_mode = compr_mode::no_compression) = 0;
 
   /**
    * @brief Returns the size of the parameters, used for re-generating the context.
   */
-  virtual int save_parameters_size(string compression_mode="none") = 0;
+  virtual int save_parameters_size(compr_mode compression_mode = compr_mode::no_compression) = 0;
 
   /**
    * @brief Saves the parameters, used for re-generating the context.
    * Exposes lower level interface for saving parameters.
   */
-  virtual void save_parameters_inplace(byte* out, int size, string compression_mode="none") = 0;
+  virtual void save_parameters_inplace(byte* out, int size, compr_mode compression_mode = compr_mode::no_compression) = 0;
 
   /**
    * @brief Loads the parameters, used for re-generating the context.
@@ -268,6 +489,51 @@ public:
   */
   virtual AKey& get_relin_keys() = 0;
 
+  /**
+   * @brief Generates Galois keys, used to rotate the slots of a ciphertext.
+   *
+   * @param steps The rotation steps to generate keys for. When empty, keys are
+   *              generated for every power of two, from which any rotation is composed.
+   */
+  virtual void GaloisKeyGen(const vector<int> &steps = {}) = 0;
+
+  /**
+   * @brief Returns the Galois keys.
+  */
+  virtual AKey& get_galois_keys() = 0;
+
+  /**
+   * @brief Installs a public key, e.g. loaded from a stored session.
+   * @param key The key, its contents are moved into the backend and the key is left empty.
+  */
+  virtual void set_public_key(AKey &key) = 0;
+
+  /**
+   * @brief Installs a secret key, used to decrypt and derive evaluation keys.
+   * @param key The key, its contents are moved into the backend and the key is left empty.
+  */
+  virtual void set_secret_key(AKey &key) = 0;
+
+  /**
+   * @brief Installs relinearization keys, without generating them.
+   * @param key The keys, their contents are moved into the backend and the key is left empty.
+  */
+  virtual void set_relin_keys(AKey &key) = 0;
+
+  /**
+   * @brief Installs Galois keys, without generating them.
+   * @param key The keys, their contents are moved into the backend and the key is left empty.
+  */
+  virtual void set_galois_keys(AKey &key) = 0;
+
+  /**
+   * @brief Shares a key with the backend, without copying, e.g. from a KeyCache.
+   * @param type The type of the key.
+   * @param k The key, which remains usable by other backends with the same parameters.
+   * @throws invalid_argument If the key does not match the type.
+  */
+  virtual void share_key(key type, shared_ptr<AKey> k) = 0;
+
   /**
    * @brief Reduces the size of a ciphertext.
    *
@@ -318,6 +584,65 @@ public:
   */
   virtual void rescale_to_next(ACiphertext &ctxt) = 0;
 
+  /**
+   * @brief Switches a ciphertext down to the lowest level that still decrypts correctly.
+   *
+   * The serialized size is proportional to the number of primes left; call before
+   * save when no further computation happens. Levels are chosen from the estimated
+   * noise budget, see estimate_noise_budget().
+   *
+   * @param ctxt The ciphertext to be compacted, inplace.
+   * @param min_budget Bits of estimated noise budget to keep. For CKKS, bits of
+   *                   modulus to keep above the scale, for the magnitude of the values.
+   * @return The number of levels dropped.
+   * @throws invalid_argument For BGV and BFV, if the noise is unknown, see estimate_noise_budget();
+   *                          the caller then picks the level, see mod_switch_to_level().
+  */
+  virtual int compact_for_transfer(ACiphertext &ctxt, int min_budget = 1) = 0;
+
+  /**
+   * @brief Returns the index of a ciphertext's parameters in the modulus chain.
+   *
+   * Decreases by one with each modulus switch or rescale, down to 0 at the last level.
+   *
+   * @param ctxt The ciphertext to be analyzed.
+   * @return The chain index, also the number of levels left to drop.
+  */
+  virtual int chain_index(ACiphertext &ctxt) = 0;
+
+  /**
+   * @brief Returns the level of a ciphertext, the number of levels dropped since encryption.
+   *
+   * Fresh ciphertexts are at level 0; see level_costs() for the cost at each level.
+   *
+   * @param ctxt The ciphertext to be analyzed.
+   * @return The level of the ciphertext.
+  */
+  virtual int level(ACiphertext &ctxt) = 0;
+
+  /**
+   * @brief Returns the number of primes in a ciphertext's coefficient modulus.
+  */
+  virtual int coeff_modulus_count(ACiphertext &ctxt) = 0;
+
+  /**
+   * @brief Modulus switches a ciphertext down to a level, see level().
+   *
+   * Operations at lower levels are cheaper; for CKKS, the scale is unchanged.
+   *
+   * @param ctxt The ciphertext to be mod switched, inplace.
+   * @param level The level to switch to, at least the current level.
+   * @throws invalid_argument If the level is above the ciphertext, or past the end of the chain.
+  */
+  virtual void mod_switch_to_level(ACiphertext &ctxt, int level) = 0;
+
+  /**
+   * @brief Returns the size and relative cost of operations at each level.
+   *
+   * Indexed by level(), from fresh ciphertexts to the last level of the chain.
+  */
+  virtual vector<level_cost> level_costs() = 0;
+
   /**
    * @brief Encrypts a plaintext message into a ciphertext.
    *
@@ -326,6 +651,17 @@ public:
    */
   virtual void encrypt(APlaintext &ptxt, ACiphertext &ctxt) = 0;
 
+  /**
+   * @brief Encrypts `count` plaintexts, spread over the hardware threads.
+   *
+   * Every encryption shares the public key; only the randomness differs.
+   *
+   * @param ptxts The plaintext messages to be encrypted.
+   * @param count The number of plaintexts.
+   * @param ctxts The ciphertexts where each encrypted message will be stored.
+   */
+  virtual void encrypt_many(APlaintext** ptxts, size_t count, ACiphertext** ctxts) = 0;
+
   /**
    * @brief Decrypts a ciphertext into a plaintext message.
    *
@@ -342,6 +678,95 @@ public:
   */
   virtual int invariant_noise_budget(ACiphertext &ctxt) = 0;
 
+  /**
+   * @brief Estimates the noise budget of a ciphertext, without the secret key.
+   *
+   * The noise bound is tracked through every operation, from the encryption
+   * parameters alone. Ciphertexts not tracked since their encryption, e.g.
+   * loaded ones and results computed from them, have no estimate.
+   * For BGV and BFV, a conservative estimate of invariant_noise_budget.
+   * For CKKS, the bits of precision left, for values of magnitude at most one.
+   *
+   * @param ctxt The ciphertext to be analyzed.
+   * @return The estimated noise budget (in bits) of the ciphertext, or -1 when unknown.
+  */
+  virtual int estimate_noise_budget(ACiphertext &ctxt) = 0;
+
+  /**
+   * @brief Encodes and encrypts an array of integers, without exposing
+   *        the intermediate plaintext.
+   *        Used by BGV and BFV schemes.
+   *
+   * @param data Pointer to the integers to be encrypted.
+   * @param len The number of integers, at most slot_count().
+   * @param ctxt The ciphertext where the encrypted message will be stored.
+   */
+  virtual void encrypt_int(const uint64_t* data, size_t len, ACiphertext &ctxt) = 0;
+
+  /**
+   * @brief Encodes and encrypts an array of floats, without exposing
+   *        the intermediate plaintext.
+   *        Used by CKKS scheme.
+   *
+   * @param data Pointer to the floats to be encrypted.
+   * @param len The number of floats, at most slot_count().
+   * @param ctxt The ciphertext where the encrypted message will be stored.
+   */
+  virtual void encrypt_double(const double* data, size_t len, ACiphertext &ctxt) = 0;
+
+  /**
+   * @brief Decrypts and decodes a ciphertext directly into caller-provided memory.
+   *        Used by BGV and BFV schemes.
+   *
+   * @param ctxt The ciphertext to be decrypted.
+   * @param data The destination array of integers.
+   * @param cap The capacity of the destination array.
+   * @return The number of integers written, min(cap, slot_count()).
+   */
+  virtual size_t decrypt_int(ACiphertext &ctxt, uint64_t* data, size_t cap) = 0;
+
+  /**
+   * @brief Decrypts and decodes a ciphertext directly into caller-provided memory.
+   *        Used by CKKS scheme.
+   *
+   * @param ctxt The ciphertext to be decrypted.
+   * @param data The destination array of floats.
+   * @param cap The capacity of the destination array.
+   * @return The number of floats written, min(cap, slot_count()).
+   */
+  virtual size_t decrypt_double(ACiphertext &ctxt, double* data, size_t cap) = 0;
+
+  /**
+   * @brief Encrypts `count` rows of `len` integers, one ciphertext per row.
+   *
+   * @param data Pointer to `count * len` integers, stored row by row.
+   * @param len The number of integers in each row, at most slot_count().
+   * @param count The number of rows.
+   * @param ctxts The ciphertexts where each encrypted row will be stored.
+   */
+  virtual void encrypt_int_batch(const uint64_t* data, size_t len, size_t count, ACiphertext** ctxts) = 0;
+
+  /**
+   * @brief Encrypts `count` rows of `len` floats, one ciphertext per row.
+   */
+  virtual void encrypt_double_batch(const double* data, size_t len, size_t count, ACiphertext** ctxts) = 0;
+
+  /**
+   * @brief Decrypts `count` ciphertexts into rows of `cap` integers.
+   *
+   * @param ctxts The ciphertexts to be decrypted.
+   * @param count The number of ciphertexts.
+   * @param data Pointer to `count * cap` integers, written row by row.
+   * @param cap The number of integers reserved for each row.
+   * @return The number of integers written in each row, min(cap, slot_count()).
+   */
+  virtual size_t decrypt_int_batch(ACiphertext** ctxts, size_t count, uint64_t* data, size_t cap) = 0;
+
+  /**
+   * @brief Decrypts `count` ciphertexts into rows of `cap` floats.
+   */
+  virtual size_t decrypt_double_batch(ACiphertext** ctxts, size_t count, double* data, size_t cap) = 0;
+
   // ------------------ Codec ------------------
 
   /**
@@ -356,7 +781,7 @@ public:
    * @param data The vector of integers to be encoded.
    * @param ptxt The plaintext message where the encoded message will be stored.
    */
-  virtual void encode_int(vector<uint64_t> &data, APlaintext &ptxt) = 0;
+  virtual void encode_int(const vector<uint64_t> &data, APlaintext &ptxt) = 0;
 
   /**
    * @brief Encodes a vector of floats into a plaintext message.
@@ -365,7 +790,7 @@ public:
    * @param data The vector of floats to be encoded.
    * @param ptxt The plaintext message where the encoded message will be stored.
    */
-  virtual void encode_double(vector<double> &data, APlaintext &ptxt) = 0;
+  virtual void encode_double(const vector<double> &data, APlaintext &ptxt) = 0;
 
   /**
    * @brief Encodes a single double into a plaintext message.
@@ -376,6 +801,28 @@ public:
    */
   virtual void encode_double(double data, APlaintext &ptxt) = 0;
 
+  /**
+   * @brief Encodes a contiguous array of integers into a plaintext message,
+   *        without an intermediate copy.
+   *        Used by BGV and BFV schemes.
+   *
+   * @param data Pointer to the integers to be encoded.
+   * @param len The number of integers, at most slot_count().
+   * @param ptxt The plaintext message where the encoded message will be stored.
+   */
+  virtual void encode_int(const uint64_t* data, size_t len, APlaintext &ptxt) = 0;
+
+  /**
+   * @brief Encodes a contiguous array of floats into a plaintext message,
+   *        without an intermediate copy.
+   *        Used by CKKS scheme.
+   *
+   * @param data Pointer to the floats to be encoded.
+   * @param len The number of floats, at most slot_count().
+   * @param ptxt The plaintext message where the encoded message will be stored.
+   */
+  virtual void encode_double(const double* data, size_t len, APlaintext &ptxt) = 0;
+
   /**
    * @brief Encodes a vector of complex numbers into a plaintext message.
    *        Used by CKKS scheme.
@@ -383,7 +830,21 @@ public:
    * @param data The vector of complex numbers to be encoded.
    * @param ptxt The plaintext message where the encoded message will be stored.
    */
-  // virtual void encode_complex(vector<complex<double>> &data, APlainTxt &ptxt) = 0;
+  virtual void encode_complex(const vector<complex<double>> &data, APlaintext &ptxt) = 0;
+
+  /**
+   * @brief Encodes a contiguous array of complex numbers into a plaintext message,
+   *        without an intermediate copy.
+   *        Used by CKKS scheme.
+   *
+   * The array may alias interleaved (real, imaginary) doubles, which share
+   * the layout of complex<double>.
+   *
+   * @param data Pointer to the complex numbers to be encoded.
+   * @param len The number of complex numbers, at most slot_count().
+   * @param ptxt The plaintext message where the encoded message will be stored.
+   */
+  virtual void encode_complex(const complex<double>* data, size_t len, APlaintext &ptxt) = 0;
 
   /**
    * @brief Decodes a plaintext message into a vector of integers.
@@ -403,6 +864,28 @@ public:
    */
   virtual void decode_double(APlaintext &ptxt, vector<double> &data) = 0;
 
+  /**
+   * @brief Decodes a plaintext message directly into caller-provided memory.
+   *        Used by BGV and BFV schemes.
+   *
+   * @param ptxt The plaintext message to be decoded.
+   * @param data The destination array of integers.
+   * @param cap The capacity of the destination array.
+   * @return The number of integers written, min(cap, slot_count()).
+   */
+  virtual size_t decode_int(APlaintext &ptxt, uint64_t* data, size_t cap) = 0;
+
+  /**
+   * @brief Decodes a plaintext message directly into caller-provided memory.
+   *        Used by CKKS scheme.
+   *
+   * @param ptxt The plaintext message to be decoded.
+   * @param data The destination array of floats.
+   * @param cap The capacity of the destination array.
+   * @return The number of floats written, min(cap, slot_count()).
+   */
+  virtual size_t decode_double(APlaintext &ptxt, double* data, size_t cap) = 0;
+
   /**
    * @brief Decodes a plaintext message into a vector of complex numbers.
    *        Used by CKKS scheme.
@@ -410,7 +893,18 @@ public:
    * @param ptxt The plaintext message to be decoded.
    * @param data The vector of complex numbers where the decoded message will be stored.
    */
-  // virtual void decode_complex(APlainTxt &ptxt, vector<complex<double>> &data) = 0;
+  virtual void decode_complex(APlaintext &ptxt, vector<complex<double>> &data) = 0;
+
+  /**
+   * @brief Decodes a plaintext message directly into caller-provided memory.
+   *        Used by CKKS scheme.
+   *
+   * @param ptxt The plaintext message to be decoded.
+   * @param data The destination array of complex numbers.
+   * @param cap The capacity of the destination array.
+   * @return The number of complex numbers written, min(cap, slot_count()).
+   */
+  virtual size_t decode_complex(APlaintext &ptxt, complex<double>* data, size_t cap) = 0;
 
   // ------------------ Arithmetic ------------------
 
@@ -437,6 +931,17 @@ public:
    */
   virtual void add(ACiphertext &ctxt1, ACiphertext &ctxt2, ACiphertext &ctxt_res) = 0;
 
+  /**
+   * @brief Adds many ciphertexts and stores the sum in another ciphertext.
+   *
+   * The sum is accumulated in place, without intermediate ciphertexts.
+   *
+   * @param ctxts The ciphertexts to be added.
+   * @param count The number of ciphertexts, at least one.
+   * @param ctxt_res The ciphertext where the result will be stored, may alias an input.
+   */
+  virtual void add_many(ACiphertext** ctxts, size_t count, ACiphertext &ctxt_res) = 0;
+
   /**
    * @brief Subtracts a plaintext from a ciphertext and stores the result in another ciphertext.
    *
@@ -470,6 +975,17 @@ public:
   */
   virtual void multiply(ACiphertext &ctxt1, ACiphertext &ctxt2, ACiphertext &ctxt_res) = 0;
 
+  /**
+   * @brief Multiplies many ciphertexts and stores the product in another ciphertext.
+   * @param ctxts The ciphertexts to be multiplied.
+   * @param count The number of ciphertexts, at least one.
+   * @param ctxt_res The ciphertext where the result will be stored, may alias an input.
+   *
+   * Products are paired in a balanced tree, consuming ceil(log2(count)) levels instead of count - 1.
+   * Each product is relinearized, and rescaled for CKKS; requires relinearization keys.
+  */
+  virtual void multiply_many(ACiphertext** ctxts, size_t count, ACiphertext &ctxt_res) = 0;
+
   /**
    * @brief Multiplies a ciphertext by a plaintext and stores the result in another ciphertext.
    * @param ctxt The ciphertext to be multiplied.
@@ -498,6 +1014,93 @@ public:
    * @param ctxt_res The ciphertext where the result will be stored.
   */
   virtual void power(ACiphertext &ctxt, int power, ACiphertext &ctxt_res) = 0;
+
+  /**
+   * @brief Evaluates a polynomial on a ciphertext and stores the result in another ciphertext.
+   *        Used by CKKS scheme.
+   *
+   * Uses the Paterson-Stockmeyer method: about 2 * sqrt(degree) ciphertext multiplications,
+   * each relinearized and rescaled, at a depth of about log2(degree) + 1 levels.
+   * Requires relinearization keys, and enough levels left in the ciphertext.
+   * Coefficients too small to encode at the scale of the primes, e.g. below 2^-41
+   * for 40-bit primes, are dropped.
+   *
+   * @param ctxt The ciphertext to be evaluated.
+   * @param coeffs The coefficients, in ascending order of degree: c0 + c1 x + c2 x^2 + ...
+   * @param count The number of coefficients, at least two.
+   * @param ctxt_res The ciphertext where the result will be stored.
+  */
+  virtual void eval_polynomial(ACiphertext &ctxt, const double* coeffs, size_t count, ACiphertext &ctxt_res) = 0;
+
+  /**
+   * @brief Rotates the slots of a ciphertext and stores the result in another ciphertext.
+   *
+   * Positive steps rotate left, negative steps rotate right. For BGV and BFV, each of
+   * the two rows of slot_count() / 2 slots is rotated independently.
+   * Requires Galois keys, see GaloisKeyGen().
+   *
+   * @param ctxt The ciphertext to be rotated.
+   * @param steps The number of slots to rotate by.
+   * @param ctxt_res The ciphertext where the result will be stored.
+  */
+  virtual void rotate(ACiphertext &ctxt, int steps, ACiphertext &ctxt_res) = 0;
+
+  /**
+   * @brief Rotates one ciphertext by a batch of steps, in parallel, storing one result per step.
+   *
+   * Each step is an independent rotation of the input, as by rotate(), spread over
+   * the thread pool. The CPU work is that of one rotate() per step: key switching
+   * is not hoisted, only the wall-clock time drops.
+   *
+   * @param ctxt The ciphertext to be rotated.
+   * @param steps The rotation steps, see rotate().
+   * @param count The number of rotation steps.
+   * @param ctxts_res The ciphertexts where each rotation will be stored, one per step.
+  */
+  virtual void rotate_batch(ACiphertext &ctxt, const int* steps, size_t count, ACiphertext** ctxts_res) = 0;
+
+  // ------------------ Linear Algebra ------------------
+
+  /**
+   * @brief Encodes a plaintext matrix for products with encrypted vectors.
+   *        Used by BGV and BFV schemes.
+   *
+   * The matrix is padded with zeros to a square of dimension d, the next power of two.
+   * Its diagonals are encoded once, in the form consumed by matvec_plain().
+   *
+   * @param data The matrix, stored row by row, as `rows * cols` integers.
+   * @param rows The number of rows.
+   * @param cols The number of columns.
+   * @param mat The matrix where the encoded diagonals will be stored.
+   * @throws invalid_argument If d exceeds the number of slots in a row.
+  */
+  virtual void encode_matrix_int(const uint64_t* data, size_t rows, size_t cols, APlainMatrix &mat) = 0;
+
+  /**
+   * @brief Encodes a plaintext matrix for products with encrypted vectors.
+   *        Used by CKKS scheme.
+   *
+   * @param data The matrix, stored row by row, as `rows * cols` floats.
+   * @param rows The number of rows.
+   * @param cols The number of columns.
+   * @param mat The matrix where the encoded diagonals will be stored.
+  */
+  virtual void encode_matrix_double(const double* data, size_t rows, size_t cols, APlainMatrix &mat) = 0;
+
+  /**
+   * @brief Multiplies a plaintext matrix by an encrypted vector.
+   *
+   * Uses the diagonal method with baby-step giant-step rotations. The vector must be
+   * replicated with period mat.dim() across the slots (see Packing::encode_replicated_int),
+   * and the product is returned with the same layout: entry i of the result is held in
+   * every slot congruent to i modulo mat.dim(). For CKKS, the result is rescaled.
+   * Requires Galois keys for mat.rotation_steps(), or for every power of two.
+   *
+   * @param mat The encoded plaintext matrix.
+   * @param ctxt The encrypted vector.
+   * @param ctxt_res The ciphertext where the product will be stored.
+  */
+  virtual void matvec_plain(APlainMatrix &mat, ACiphertext &ctxt, ACiphertext &ctxt_res) = 0;
 };
 
 #endif /* AFHE_H */
@@ -16,9 +16,14 @@
 #include <vector>   /* Vectorizing all operations */
 #include <memory>   /* Smart Pointers*/
 #include <map>      /* map */
+#include <limits>   /* quiet_NaN */
+#include <cmath>    /* log2, exp2 */
+#include <stdexcept> /* invalid_argument */
 
 #include "seal/seal.h" /* Microsoft SEAL */
 #include "afhe.h"      /* Abstraction */
+#include "fingerprint.h" /* XXH64 */
+#include "handle_pool.h" /* Handle Pool */
 
 using namespace std;
 
@@ -31,35 +36,51 @@ class AsealPoly;
 /**
  * @brief Scheme types
  */
-static map<scheme, seal::scheme_type> scheme_map_to_seal {
-    {scheme::no_scheme, seal::scheme_type::none},
-    {scheme::bfv, seal::scheme_type::bfv},
-    {scheme::ckks, seal::scheme_type::ckks},
-    {scheme::bgv, seal::scheme_type::bgv},
-};
+inline seal::scheme_type scheme_to_seal(scheme scheme)
+{
+  switch (scheme)
+  {
+  case scheme::no_scheme: return seal::scheme_type::none;
+  case scheme::bfv: return seal::scheme_type::bfv;
+  case scheme::ckks: return seal::scheme_type::ckks;
+  case scheme::bgv: return seal::scheme_type::bgv;
+  }
+  throw invalid_argument("Unsupported Scheme");
+}
 
 /**
- * @brief Security Levels
+ * @brief Security Levels, unknown levels are not enforced
  */
-static map<int, seal::sec_level_type> sec_map {
-    {0, seal::sec_level_type::none},
-    {128, seal::sec_level_type::tc128},
-    {192, seal::sec_level_type::tc192},
-    {256, seal::sec_level_type::tc256},
-};
+inline seal::sec_level_type sec_level_to_seal(int sec_level)
+{
+  switch (sec_level)
+  {
+  case 128: return seal::sec_level_type::tc128;
+  case 192: return seal::sec_level_type::tc192;
+  case 256: return seal::sec_level_type::tc256;
+  default: return seal::sec_level_type::none;
+  }
+}
 
 /**
  * @brief Serialization Compression Modes
+ * @throws invalid_argument If the mode is not enabled in SEAL.
 */
-static map<string,seal::compr_mode_type> compression_mode_map {
-    {"none", seal::compr_mode_type::none},
+inline seal::compr_mode_type compr_mode_to_seal(compr_mode mode)
+{
+  switch (mode)
+  {
+  case compr_mode::no_compression: return seal::compr_mode_type::none;
 #ifdef SEAL_USE_ZLIB
-    {"zlib", seal::compr_mode_type::zlib},
+  case compr_mode::zlib: return seal::compr_mode_type::zlib;
 #endif
 #ifdef SEAL_USE_ZSTD
-    {"zstd", seal::compr_mode_type::zstd},
+  case compr_mode::zstd: return seal::compr_mode_type::zstd;
 #endif
-};
+  default: break;
+  }
+  throw invalid_argument("Unsupported Compression Mode");
+}
 
 /**
  * @brief Convert uint_64 to hexademical string.
@@ -71,10 +92,23 @@ inline string uint64_to_hex(uint64_t value) {
 /**
  * @brief Convert hexademical string to uint_64.
 */
-inline uint64_t hex_to_uint64(string value) {
+inline uint64_t hex_to_uint64(const string &value) {
   return stoi(value, 0, 16);
 }
 
+/**
+ * @brief Serialize a SEAL object directly into the returned string, without a stream.
+*/
+template <typename T>
+inline string save_to_string(const T &obj, seal::compr_mode_type mode = seal::compr_mode_type::none)
+{
+  // Exact for uncompressed, an upper bound otherwise
+  string out(static_cast<size_t>(obj.save_size(mode)), '\0');
+  size_t written = static_cast<size_t>(obj.save(reinterpret_cast<byte*>(&out[0]), out.size(), mode));
+  out.resize(written);
+  return out;
+}
+
 /**
  * @brief Abstraction for Context
 */
@@ -95,31 +129,38 @@ inline AContext& _from_context(AsealContext& c){
 /**
  * @brief Abstraction for Plaintext
  */
-class AsealPlaintext : public APlaintext, public seal::Plaintext {
+class AsealPlaintext final : public APlaintext, public seal::Plaintext {
 public:
-  // Inherit constructors
-  using seal::Plaintext::Plaintext;
-  AsealPlaintext(const seal::Plaintext &ptxt) : seal::Plaintext(ptxt) {};
+  // Every constructor tags the backend
+  AsealPlaintext() : APlaintext(backend::seal_backend) {};
+  AsealPlaintext(const string &hex_poly) : APlaintext(backend::seal_backend), seal::Plaintext(hex_poly) {};
+  AsealPlaintext(const seal::Plaintext &ptxt) : APlaintext(backend::seal_backend), seal::Plaintext(ptxt) {};
   string to_string() override {
     return seal::Plaintext::to_string();
   }
   ~AsealPlaintext(){};
 };
 
+// TAGGED CASTING, a single check of the backend instead of dynamic_cast
 inline AsealPlaintext& _to_plaintext(APlaintext& p){
-  return dynamic_cast<AsealPlaintext&>(p);
+  if (p.backend_lib != backend::seal_backend)
+  {
+    throw invalid_argument("Plaintext does not belong to the SEAL backend");
+  }
+  return static_cast<AsealPlaintext&>(p);
 };
 inline APlaintext& _from_plaintext(AsealPlaintext& p){
-  return dynamic_cast<APlaintext&>(p);
+  return static_cast<APlaintext&>(p);
 };
 
 /**
  * @brief Abstraction for Ciphertext
  */
-class AsealCiphertext : public ACiphertext, public seal::Ciphertext {
+class AsealCiphertext final : public ACiphertext, public seal::Ciphertext {
 public:
-  using seal::Ciphertext::Ciphertext;
-  AsealCiphertext(const seal::Ciphertext &ctxt) : seal::Ciphertext(ctxt) {};
+  // Every constructor tags the backend
+  AsealCiphertext() : ACiphertext(backend::seal_backend) {};
+  AsealCiphertext(const seal::Ciphertext &ctxt) : ACiphertext(backend::seal_backend), seal::Ciphertext(ctxt) {};
   ~AsealCiphertext(){};
   size_t size() override {
     return seal::Ciphertext::size();
@@ -130,26 +171,40 @@ public:
   void set_scale(double scale) override {
     seal::Ciphertext::scale() = scale;
   }
-  string save(string compression_mode="none") override {
-    ostringstream stream;
-    seal::Ciphertext::save(stream, compression_mode_map.at(compression_mode));
-    return stream.str();
+  string save(compr_mode compression_mode = compr_mode::no_compression) override {
+    return save_to_string(static_cast<const seal::Ciphertext&>(*this), compr_mode_to_seal(compression_mode));
   }
-  int save_size(string compression_mode="none") override {
-    return seal::Ciphertext::save_size(compression_mode_map.at(compression_mode));
+  int save_size(compr_mode compression_mode = compr_mode::no_compression) override {
+    return seal::Ciphertext::save_size(compr_mode_to_seal(compression_mode));
   }
-  void load(Afhe* fhe, string data) override {
-    istringstream stream(data);
-    seal::Ciphertext::load(_to_context(fhe->get_context()), stream);
+  void load(Afhe* fhe, string_view data) override {
+    load_inplace(fhe, reinterpret_cast<const byte*>(data.data()), static_cast<int>(data.size()));
   }
+  int save_inplace(byte* out, int size, compr_mode compression_mode = compr_mode::no_compression) override {
+    return static_cast<int>(seal::Ciphertext::save(out, size, compr_mode_to_seal(compression_mode)));
+  }
+  void load_inplace(Afhe* fhe, const byte* in, int size) override {
+    seal::Ciphertext::load(_to_context(fhe->get_context()), in, size);
+    noise_bits = numeric_limits<double>::quiet_NaN();
+  }
+
+  /**
+   * @brief Estimated noise bound in bits, tracked by the operations of Aseal.
+   *        NaN when unknown, e.g. after load, and for every result computed from it.
+  */
+  double noise_bits = numeric_limits<double>::quiet_NaN();
 };
 
-// DYNAMIC CASTING
+// TAGGED CASTING, a single check of the backend instead of dynamic_cast
 inline AsealCiphertext& _to_ciphertext(ACiphertext& c){
-  return dynamic_cast<AsealCiphertext&>(c);
+  if (c.backend_lib != backend::seal_backend)
+  {
+    throw invalid_argument("Ciphertext does not belong to the SEAL backend");
+  }
+  return static_cast<AsealCiphertext&>(c);
 };
 inline ACiphertext& _from_ciphertext(AsealCiphertext& c){
-  return dynamic_cast<ACiphertext&>(c);
+  return static_cast<ACiphertext&>(c);
 };
 
 /**
@@ -161,31 +216,40 @@ public:
   AsealPublicKey(const seal::PublicKey &pk) : seal::PublicKey(pk) {};
   ~AsealPublicKey(){};
   string save() override {
-    ostringstream stream;
-    seal::PublicKey::save(stream);
-    return stream.str();
+    return save_to_string(static_cast<const seal::PublicKey&>(*this));
   }
   int save_size() override {
     return seal::PublicKey::save_size();
   }
-  void load(Afhe* fhe, string data) override {
-    istringstream stream(data);
-    seal::PublicKey::load(_to_context(fhe->get_context()), stream);
+  void load(Afhe* fhe, string_view data) override {
+    load_inplace(fhe, reinterpret_cast<const byte*>(data.data()), static_cast<int>(data.size()));
   }
-  vector<uint64_t> data() override {
-    seal::Ciphertext ctxt = seal::PublicKey::data();
-    vector<uint64_t> data;
-    for (size_t i = 0; i < ctxt.size(); i++) {
-      // cout << ctxt.data()[i] << endl;
-      data.push_back(ctxt.data()[i]);
+  void load_inplace(Afhe* fhe, const byte* in, int size, bool trusted = false) override {
+    if (trusted) {
+      seal::PublicKey::unsafe_load(_to_context(fhe->get_context()), in, size);
+    } else {
+      seal::PublicKey::load(_to_context(fhe->get_context()), in, size);
     }
-    return data;
+    reset_fingerprint();
+  }
+  vector<uint64_t> data() override {
+    // First coefficients of the first polynomial, as many as polynomials, read in place
+    const seal::Ciphertext &ctxt = seal::PublicKey::data();
+    return vector<uint64_t>(ctxt.data(), ctxt.data() + ctxt.size());
+  }
+  size_t data_size() override {
+    return seal::PublicKey::data().size();
+  }
+protected:
+  uint64_t compute_fingerprint() override {
+    const seal::Ciphertext &ctxt = seal::PublicKey::data();
+    return ::fingerprint(ctxt.data(), ctxt.dyn_array().size() * sizeof(uint64_t));
   }
 };
 
 // DYNAMIC CASTING
 inline AsealPublicKey& _to_public_key(AKey& k){
-  return static_cast<AsealPublicKey&>(k);
+  return dynamic_cast<AsealPublicKey&>(k);
 };
 inline AKey& _from_public_key(AsealPublicKey& k){
   return static_cast<AKey&>(k);
@@ -200,36 +264,84 @@ public:
   AsealSecretKey(const seal::SecretKey &sk) : seal::SecretKey(sk) {};
   ~AsealSecretKey(){};
   string save() override {
-    ostringstream stream;
-    seal::SecretKey::save(stream);
-    return stream.str();
+    return save_to_string(static_cast<const seal::SecretKey&>(*this));
   }
   int save_size() override {
     return seal::SecretKey::save_size();
   }
-  void load(Afhe* fhe, string data) override {
-    istringstream stream(data);
-    seal::SecretKey::load(_to_context(fhe->get_context()), stream);
+  void load(Afhe* fhe, string_view data) override {
+    load_inplace(fhe, reinterpret_cast<const byte*>(data.data()), static_cast<int>(data.size()));
   }
-  vector<uint64_t> data() override {
-    seal::Plaintext ptxt = seal::SecretKey::data();
-    vector<uint64_t> data;
-    for (size_t i = 0; i < ptxt.scale(); i++) { // TODO: BFV / BGV?
-      // cout << ptxt.data()[i] << endl;
-      data.push_back(ptxt.data()[i]);
+  void load_inplace(Afhe* fhe, const byte* in, int size, bool trusted = false) override {
+    if (trusted) {
+      seal::SecretKey::unsafe_load(_to_context(fhe->get_context()), in, size);
+    } else {
+      seal::SecretKey::load(_to_context(fhe->get_context()), in, size);
     }
-    return data;
+    reset_fingerprint();
+  }
+  vector<uint64_t> data() override {
+    // Leading coefficient, read in place
+    const seal::Plaintext &ptxt = seal::SecretKey::data();
+    return vector<uint64_t>(ptxt.data(), ptxt.data() + data_size());
+  }
+  size_t data_size() override {
+    return seal::SecretKey::data().coeff_count() > 0 ? 1 : 0;
+  }
+protected:
+  uint64_t compute_fingerprint() override {
+    const seal::Plaintext &ptxt = seal::SecretKey::data();
+    return ::fingerprint(ptxt.data(), ptxt.coeff_count() * sizeof(uint64_t));
   }
 };
 
 // DYNAMIC CASTING
 inline AsealSecretKey& _to_secret_key(AKey& k){
-  return static_cast<AsealSecretKey&>(k);
+  return dynamic_cast<AsealSecretKey&>(k);
 };
 inline AKey& _from_secret_key(AsealSecretKey& k){
   return static_cast<AKey&>(k);
 };
 
+/**
+ * @brief Number of key switching keys, one value each in data().
+*/
+inline size_t _kswitch_data_size(const seal::KSwitchKeys &keys){
+  size_t count = 0;
+  for (const auto &level : keys.data()) {
+    count += level.size();
+  }
+  return count;
+};
+
+/**
+ * @brief Leading coefficient of each key switching key, read in place.
+*/
+inline vector<uint64_t> _kswitch_data(const seal::KSwitchKeys &keys){
+  vector<uint64_t> data;
+  data.reserve(_kswitch_data_size(keys));
+  for (const auto &level : keys.data()) {
+    for (const auto &pk : level) {
+      data.push_back(pk.data().data()[0]);
+    }
+  }
+  return data;
+};
+
+/**
+ * @brief Hashes the coefficients of every key switching key, chained through the seed.
+*/
+inline uint64_t _kswitch_fingerprint(const seal::KSwitchKeys &keys){
+  uint64_t h = 0;
+  for (const auto &level : keys.data()) {
+    for (const auto &pk : level) {
+      const seal::Ciphertext &ctxt = pk.data();
+      h = fingerprint(ctxt.data(), ctxt.dyn_array().size() * sizeof(uint64_t), h);
+    }
+  }
+  return h;
+};
+
 /**
  * @brief Abstraction for RelinKey
 */
@@ -239,27 +351,31 @@ public:
   AsealRelinKey(const seal::RelinKeys &rk) : seal::RelinKeys(rk) {};
   ~AsealRelinKey(){};
   string save() override {
-    ostringstream stream;
-    seal::RelinKeys::save(stream);
-    return stream.str();
+    return save_to_string(static_cast<const seal::RelinKeys&>(*this));
   }
   int save_size() override {
     return seal::RelinKeys::save_size();
   }
-  void load(Afhe* fhe, string data) override {
-    istringstream stream(data);
-    seal::RelinKeys::load(_to_context(fhe->get_context()), stream);
+  void load(Afhe* fhe, string_view data) override {
+    load_inplace(fhe, reinterpret_cast<const byte*>(data.data()), static_cast<int>(data.size()));
   }
-  vector<uint64_t> data() override {
-    vector<vector<seal::PublicKey>> pk = seal::RelinKeys::data();
-    vector<uint64_t> data;
-    for (size_t i = 0; i < pk.size(); i++) {
-      for (size_t j = 0; j < pk[i].size(); j++) {
-        // cout << pk[i][j].data()[0] << endl;
-        data.push_back(pk[i][j].data()[0]);
-      }
+  void load_inplace(Afhe* fhe, const byte* in, int size, bool trusted = false) override {
+    if (trusted) {
+      seal::RelinKeys::unsafe_load(_to_context(fhe->get_context()), in, size);
+    } else {
+      seal::RelinKeys::load(_to_context(fhe->get_context()), in, size);
     }
-    return data;
+    reset_fingerprint();
+  }
+  vector<uint64_t> data() override {
+    return _kswitch_data(*this);
+  }
+  size_t data_size() override {
+    return _kswitch_data_size(*this);
+  }
+protected:
+  uint64_t compute_fingerprint() override {
+    return _kswitch_fingerprint(*this);
   }
 };
 
@@ -271,21 +387,106 @@ inline AKey& _from_relin_keys(AsealRelinKey& k){
   return dynamic_cast<AKey&>(k);
 };
 
+/**
+ * @brief Abstraction for GaloisKeys
+*/
+class AsealGaloisKey : public AKey, public seal::GaloisKeys {
+public:
+  using seal::GaloisKeys::GaloisKeys;
+  AsealGaloisKey(const seal::GaloisKeys &gk) : seal::GaloisKeys(gk) {};
+  ~AsealGaloisKey(){};
+  string save() override {
+    return save_to_string(static_cast<const seal::GaloisKeys&>(*this));
+  }
+  int save_size() override {
+    return seal::GaloisKeys::save_size();
+  }
+  void load(Afhe* fhe, string_view data) override {
+    load_inplace(fhe, reinterpret_cast<const byte*>(data.data()), static_cast<int>(data.size()));
+  }
+  void load_inplace(Afhe* fhe, const byte* in, int size, bool trusted = false) override {
+    if (trusted) {
+      seal::GaloisKeys::unsafe_load(_to_context(fhe->get_context()), in, size);
+    } else {
+      seal::GaloisKeys::load(_to_context(fhe->get_context()), in, size);
+    }
+    reset_fingerprint();
+  }
+  vector<uint64_t> data() override {
+    return _kswitch_data(*this);
+  }
+  size_t data_size() override {
+    return _kswitch_data_size(*this);
+  }
+protected:
+  uint64_t compute_fingerprint() override {
+    return _kswitch_fingerprint(*this);
+  }
+};
+
+// DYNAMIC CASTING
+inline AsealGaloisKey& _to_galois_keys(AKey& k){
+  return dynamic_cast<AsealGaloisKey&>(k);
+};
+inline AKey& _from_galois_keys(AsealGaloisKey& k){
+  return dynamic_cast<AKey&>(k);
+};
+
+/**
+ * @brief Abstraction for an encoded plaintext matrix.
+ *
+ * Diagonal k = giant * baby_steps + baby is stored pre-rotated right by
+ * giant * baby_steps slots, at index k, such that a product only rotates
+ * the encrypted vector by the baby steps and each partial sum by a giant step.
+ * BGV and BFV diagonals are kept in NTT form; all-zero diagonals are skipped.
+*/
+class AsealPlainMatrix : public APlainMatrix {
+public:
+  size_t n_rows = 0;                   /** Number of rows. */
+  size_t n_cols = 0;                   /** Number of columns. */
+  size_t d = 0;                        /** Dimension of the padded square matrix. */
+  size_t baby_steps = 0;               /** Number of baby steps, a power of two. */
+  vector<seal::Plaintext> diagonals;   /** Encoded, pre-rotated diagonals. */
+  vector<bool> nonzero;                /** Whether each diagonal is non-zero. */
+
+  size_t rows() override { return n_rows; }
+  size_t cols() override { return n_cols; }
+  size_t dim() override { return d; }
+  size_t giant_steps() const { return (d + baby_steps - 1) / baby_steps; }
+  vector<int> rotation_steps() override {
+    vector<int> steps;
+    for (size_t j = 1; j < baby_steps; j++) {
+      steps.push_back(static_cast<int>(j));
+    }
+    for (size_t i = 1; i < giant_steps(); i++) {
+      steps.push_back(static_cast<int>(i * baby_steps));
+    }
+    return steps;
+  }
+};
+
+// DYNAMIC CASTING
+inline AsealPlainMatrix& _to_plain_matrix(APlainMatrix& m){
+  return dynamic_cast<AsealPlainMatrix&>(m);
+};
+
 
 /**
  * @brief Aseal class represents a concrete implementation of the Afhe class using the Microsoft SEAL library.
  */
-class Aseal : public Afhe {
+class Aseal final : public Afhe {
 private:
   shared_ptr<seal::EncryptionParameters> params; /** Pointer to the SEAL parameters object. */
   shared_ptr<seal::SEALContext> context;     /** Pointer to the SEAL context object. */
   shared_ptr<seal::BatchEncoder> bEncoder;   /** Pointer to the BatchEncoder object. */
   shared_ptr<seal::CKKSEncoder> cEncoder;    /** Pointer to the CKKSEncoder object. */
   double cEncoderScale;                      /** Scale for CKKSEncoder. */
+  prng prng_choice = prng::default_prng;     /** PRNG for new contexts. */
   shared_ptr<seal::KeyGenerator> keyGenObj;  /** Key generator.*/
   shared_ptr<seal::SecretKey> secretKey;     /** Secret key.*/
   shared_ptr<seal::PublicKey> publicKey;     /** Public key.*/
   shared_ptr<seal::RelinKeys> relinKeys;     /** Relin keys.*/
+  shared_ptr<seal::GaloisKeys> galoisKeys;   /** Galois keys.*/
 
   shared_ptr<seal::Encryptor> encryptor;     /** Requires a Public Key.*/
   shared_ptr<seal::Evaluator> evaluator;     /** Requires a context.*/
@@ -293,6 +494,119 @@ private:
 
   shared_ptr<seal::Ciphertext> ciphertext;   /** Ciphertext.*/
 
+  shared_ptr<HandlePool<AsealCiphertext>> ciphertext_pool = make_shared<HandlePool<AsealCiphertext>>(); /** Released ciphertexts.*/
+  shared_ptr<HandlePool<AsealPlaintext>> plaintext_pool = make_shared<HandlePool<AsealPlaintext>>();    /** Released plaintexts.*/
+
+  /**
+   * @brief Sets the selected PRNG factory on the parameters, before creating a context.
+   *
+   * The PRNG is not serialized with the parameters, so it is set again after every load.
+   */
+  void set_random_generator();
+
+  /**
+   * @brief Returns the calling thread's scratch plaintext, reused by the
+   *        fused encrypt and decrypt methods to avoid an allocation per call.
+   */
+  static AsealPlaintext& scratch_plaintext();
+
+  /**
+   * @brief Lays out the diagonals of a padded square matrix and encodes them.
+   * @param value Returns the matrix entry at (row, col), zero when out of bounds.
+   * @param encode Encodes a vector of slots into a plaintext.
+  */
+  template <typename T, typename Value, typename Encode>
+  void encode_diagonals(size_t rows, size_t cols, AsealPlainMatrix &mat, Value value, Encode encode);
+
+  /**
+   * @brief Returns the number of slots rotated together, a single row for BGV and BFV.
+  */
+  size_t rotation_row_size();
+
+  /**
+   * @brief Rotates a ciphertext in place with a given evaluator, without
+   *        modifying the members of Aseal; safe to call from many threads.
+  */
+  void rotate_inplace(seal::Evaluator &evaluator, seal::Ciphertext &ctxt, int steps);
+
+  /**
+   * @brief CKKS product at matching levels, relinearized and rescaled.
+   *        The result must not alias the second operand.
+  */
+  void ckks_multiply(seal::Evaluator &evaluator, const seal::Ciphertext &a, const seal::Ciphertext &b, seal::Ciphertext &res);
+
+  /**
+   * @brief CKKS product with a constant, rescaled without changing the scale.
+  */
+  void ckks_multiply_const(seal::Evaluator &evaluator, const seal::Ciphertext &a, double c, seal::Ciphertext &res);
+
+  /**
+   * @brief CKKS sum in place, switching to the lower level and aligning scales.
+  */
+  void ckks_add(seal::Evaluator &evaluator, seal::Ciphertext &acc, const seal::Ciphertext &b);
+
+  /**
+   * @brief CKKS sum with a constant, in place.
+  */
+  void ckks_add_const(seal::Evaluator &evaluator, seal::Ciphertext &acc, double c);
+
+  /**
+   * Noise estimation, as log2 bounds from the encryption parameters alone.
+   * BGV and BFV bound the invariant noise, decryption is correct below 1/2.
+   * CKKS bounds the error of the scaled message, for inputs of magnitude at most one.
+  */
+
+  /**
+   * @brief Returns log2(2^a + 2^b), the bound of a sum; NaN if either bound is unknown.
+  */
+  static double log2_sum(double a, double b);
+
+  /**
+   * @brief Returns the context data of a ciphertext's parameters.
+   * @throws invalid_argument If the ciphertext is not valid for the context.
+  */
+  shared_ptr<const seal::SEALContext::ContextData> context_data_of(const seal::parms_id_type &parms_id);
+
+  /**
+   * @brief Returns log2 of the coefficient modulus at a level.
+  */
+  double log2_modulus(const seal::parms_id_type &parms_id);
+
+  /**
+   * @brief Returns the noise of a fresh encryption at a level, also added by key switching.
+  */
+  double noise_floor(const seal::parms_id_type &parms_id);
+
+  /**
+   * @brief Returns the tracked noise of a ciphertext, NaN when unknown.
+  */
+  double noise_of(AsealCiphertext &ctxt);
+
+  /**
+   * @brief Returns the noise of a product of ciphertexts, before relinearization.
+  */
+  double noise_multiply(const seal::parms_id_type &parms_id, double noise_a, double scale_a, double noise_b, double scale_b);
+
+  /**
+   * @brief Returns the noise of a product with a plaintext.
+  */
+  double noise_multiply_plain(double noise, double plain_scale);
+
+  /**
+   * @brief Returns the noise after key switching, by relinearization or rotation.
+  */
+  double noise_key_switch(double noise, const seal::parms_id_type &parms_id);
+
+  /**
+   * @brief Returns the noise after switching down to a level.
+  */
+  double noise_mod_switch(double noise, const seal::parms_id_type &parms_id);
+
+  /**
+   * @brief Returns the CKKS error after dividing by a prime of log2_prime bits.
+  */
+  double noise_rescale(double noise, double log2_prime);
+
 public:
   /**
    * @brief Default constructor for the Aseal class.
@@ -323,13 +637,30 @@ public:
    */
   virtual ~Aseal();
 
+  // ------------------ Handles ------------------
+  ACiphertext* acquire_ciphertext() override;
+  APlaintext* acquire_plaintext() override;
+  void release(ACiphertext* ctxt) override;
+  void release(APlaintext* ptxt) override;
+  void set_pool_capacity(size_t capacity) override;
+
   // ------------------ Context ------------------
   string ContextGen(
     scheme scheme, uint64_t poly_modulus_degree = 1024,
     uint64_t plain_modulus_bit_size = 0, uint64_t plain_modulus = 0,
-    int sec_level = 128, vector<int> qi_sizes = {}) override;
+    int sec_level = 128, const vector<int> &qi_sizes = {}) override;
+
+  string ContextGen(string_view params) override;
+  string ContextGen(const byte* params, int size) override;
 
-  string ContextGen(string params) override;
+  /**
+   * @brief Validate a custom coefficient modulus chain against the security level.
+   * @param poly_modulus_degree The degree of the polynomial modulus.
+   * @param bit_sizes The bit sizes of each prime in the chain.
+   * @param sec_level The security level, in bits.
+   * @throws invalid_argument If the total bit count exceeds the security bound.
+  */
+  void validate_coeff_modulus(uint64_t poly_modulus_degree, const vector<int> &bit_sizes, int sec_level);
 
   inline shared_ptr<seal::SEALContext> _this_context() {
     if (this->context == nullptr)
@@ -339,10 +670,45 @@ public:
     return this->context;
   }
 
+  inline seal::Evaluator& _this_evaluator() {
+    // Context errors take precedence, the evaluator is built with it
+    _this_context();
+    if (this->evaluator == nullptr)
+    {
+      throw logic_error("Evaluator is not initialized");
+    }
+    return *this->evaluator;
+  }
+
+  inline seal::Encryptor& _this_encryptor() {
+    // Built with the public key, once per key
+    _this_context();
+    if (this->encryptor == nullptr)
+    {
+      throw logic_error("PublicKey must be set to encrypt");
+    }
+    return *this->encryptor;
+  }
+
+  inline seal::Decryptor& _this_decryptor() {
+    // Built with the secret key, once per key
+    _this_context();
+    if (this->decryptor == nullptr)
+    {
+      throw logic_error("SecretKey must be set to decrypt");
+    }
+    return *this->decryptor;
+  }
+
+  void set_prng(prng type) override;
+  prng get_prng() override { return this->prng_choice; }
+
   AContext& get_context() override {
     return _from_context(static_cast<AsealContext&>(*_this_context()));
   }
 
+  scheme get_scheme() override;
+
   /**
    * @brief Assign Encoders used for encoding and decoding.
    * @param ignore_exception If true, ignore exceptions.
@@ -352,18 +718,26 @@ public:
   */
   void set_encoders(bool ignore_exception=false);
 
+  /**
+   * @brief Assign the Evaluator for the current context.
+   *
+   * The Evaluator is built once per context and only read by each operation,
+   * so operations may run concurrently from several threads (or isolates).
+  */
+  void set_evaluator();
+
   /**
    * @brief Represent SEALContext parameters as a serialized string.
    * @param compression_mode The compression mode to use.
    * Note: String may contain null-terminating characters.
   */
-  string save_parameters(string compression_mode="none") override;
+  string save_parameters(compr_mode compression_mode = compr_mode::no_compression) override;
 
   /**
    * @brief Calculate the size of the serialized SEALContext parameters.
    * @param compression_mode The compression mode to use.
   */
-  int save_parameters_size(string compression_mode="none") override;
+  int save_parameters_size(compr_mode compression_mode = compr_mode::no_compression) override;
 
   /**
    * @brief Load SEALContext parameters from a serialized byte array.
@@ -371,7 +745,7 @@ public:
    * @param size The size of the byte array.
    * @param compression_mode The compression mode used.
   */
-  void save_parameters_inplace(byte* buffer, int size, string compression_mode="none") override;
+  void save_parameters_inplace(byte* buffer, int size, compr_mode compression_mode = compr_mode::no_compression) override;
 
   /**
    * @brief Load SEALContext parameters from a serialized byte array.
@@ -395,45 +769,113 @@ public:
 
   // ------------------ Keys ------------------
   void KeyGen() override;
-  void KeyGen(string sk);
+  void KeyGen(const string &sk);
   void RelinKeyGen() override;
   AKey& get_public_key() override;
   AKey& get_secret_key() override;
   AKey& get_relin_keys() override;
+  void GaloisKeyGen(const vector<int> &steps = {}) override;
+  AKey& get_galois_keys() override;
+  void set_public_key(AKey &key) override;
+  void set_secret_key(AKey &key) override;
+  void set_relin_keys(AKey &key) override;
+  void set_galois_keys(AKey &key) override;
+  void share_key(key type, shared_ptr<AKey> k) override;
 
   // ------------------ Cryptography ------------------
 
   void encrypt(APlaintext &ptxt, ACiphertext &ctxt) override;
+  void encrypt_many(APlaintext** ptxts, size_t count, ACiphertext** ctxts) override;
   void decrypt(ACiphertext &ctxt, APlaintext &ptxt) override;
   int invariant_noise_budget(ACiphertext &ctxt) override;
+  int estimate_noise_budget(ACiphertext &ctxt) override;
+  void encrypt_int(const uint64_t* data, size_t len, ACiphertext &ctxt) override;
+  void encrypt_double(const double* data, size_t len, ACiphertext &ctxt) override;
+  size_t decrypt_int(ACiphertext &ctxt, uint64_t* data, size_t cap) override;
+  size_t decrypt_double(ACiphertext &ctxt, double* data, size_t cap) override;
+  void encrypt_int_batch(const uint64_t* data, size_t len, size_t count, ACiphertext** ctxts) override;
+  void encrypt_double_batch(const double* data, size_t len, size_t count, ACiphertext** ctxts) override;
+  size_t decrypt_int_batch(ACiphertext** ctxts, size_t count, uint64_t* data, size_t cap) override;
+  size_t decrypt_double_batch(ACiphertext** ctxts, size_t count, double* data, size_t cap) override;
   void relinearize(ACiphertext &ctxt) override;
   void mod_switch_to(APlaintext &ptxt, ACiphertext &ctxt) override;
   void mod_switch_to(ACiphertext &to, ACiphertext &from) override;
   void mod_switch_to_next(APlaintext &ptxt) override;
   void mod_switch_to_next(ACiphertext &ctxt) override;
   void rescale_to_next(ACiphertext &ctxt) override;
+  int compact_for_transfer(ACiphertext &ctxt, int min_budget = 1) override;
+  int chain_index(ACiphertext &ctxt) override;
+  int level(ACiphertext &ctxt) override;
+  int coeff_modulus_count(ACiphertext &ctxt) override;
+  void mod_switch_to_level(ACiphertext &ctxt, int level) override;
+  vector<level_cost> level_costs() override;
 
   // -------------------- Codec --------------------
 
   int slot_count() override;
 
-  void encode_int(vector<uint64_t> &data, APlaintext &ptxt) override;
+  void encode_int(const vector<uint64_t> &data, APlaintext &ptxt) override;
+  void encode_int(const uint64_t* data, size_t len, APlaintext &ptxt) override;
   void decode_int(APlaintext &ptxt, vector<uint64_t> &data) override;
+  size_t decode_int(APlaintext &ptxt, uint64_t* data, size_t cap) override;
 
   void encode_double(double data, APlaintext &ptxt) override;
-  void encode_double(vector<double> &data, APlaintext &ptxt) override;
+  void encode_double(const vector<double> &data, APlaintext &ptxt) override;
+  void encode_double(const double* data, size_t len, APlaintext &ptxt) override;
   void decode_double(APlaintext &ptxt, vector<double> &data) override;
+  size_t decode_double(APlaintext &ptxt, double* data, size_t cap) override;
+
+  void encode_complex(const vector<complex<double>> &data, APlaintext &ptxt) override;
+  void encode_complex(const complex<double>* data, size_t len, APlaintext &ptxt) override;
+  void decode_complex(APlaintext &ptxt, vector<complex<double>> &data) override;
+  size_t decode_complex(APlaintext &ptxt, complex<double>* data, size_t cap) override;
 
   // ------------------ Arithmetic ------------------
 
   void add(ACiphertext &ctxt, APlaintext &ptxt, ACiphertext &ctxt_res) override;
   void add(ACiphertext &ctxt1, ACiphertext &ctxt2, ACiphertext &ctxt_res) override;
+  void add_many(ACiphertext** ctxts, size_t count, ACiphertext &ctxt_res) override;
   void subtract(ACiphertext &ctxt, APlaintext &ptxt, ACiphertext &ctxt_res) override;
   void subtract(ACiphertext &ctxt1, ACiphertext &ctxt2, ACiphertext &ctxt_res) override;
   void multiply(ACiphertext &ctxt1, ACiphertext &ctxt2, ACiphertext &ctxt_res) override;
+  void multiply_many(ACiphertext** ctxts, size_t count, ACiphertext &ctxt_res) override;
   void multiply(ACiphertext &ctxt, APlaintext &ptxt, ACiphertext &ctxt_res) override;
   void square(ACiphertext &ctxt, ACiphertext &ctxt_res) override;
   void power(ACiphertext &ctxt, int power, ACiphertext &ctxt_res) override;
+  void eval_polynomial(ACiphertext &ctxt, const double* coeffs, size_t count, ACiphertext &ctxt_res) override;
+  void rotate(ACiphertext &ctxt, int steps, ACiphertext &ctxt_res) override;
+  void rotate_batch(ACiphertext &ctxt, const int* steps, size_t count, ACiphertext** ctxts_res) override;
+
+  // ---------------- Linear Algebra ----------------
+
+  void encode_matrix_int(const uint64_t* data, size_t rows, size_t cols, APlainMatrix &mat) override;
+  void encode_matrix_double(const double* data, size_t rows, size_t cols, APlainMatrix &mat) override;
+  void matvec_plain(APlainMatrix &mat, ACiphertext &ctxt, ACiphertext &ctxt_res) override;
+
+  // --------------- Typed Operations ---------------
+  // Non-virtual overloads on the SEAL types, without the backend checks of the
+  // overrides above, which forward to them. Used by Fhe<SealBackend>.
+
+  void encrypt(AsealPlaintext &ptxt, AsealCiphertext &ctxt);
+  void decrypt(AsealCiphertext &ctxt, AsealPlaintext &ptxt);
+  void relinearize(AsealCiphertext &ctxt);
+  void mod_switch_to_next(AsealCiphertext &ctxt);
+  void rescale_to_next(AsealCiphertext &ctxt);
+  int level(AsealCiphertext &ctxt);
+
+  void encode_int(const uint64_t* data, size_t len, AsealPlaintext &ptxt);
+  size_t decode_int(AsealPlaintext &ptxt, uint64_t* data, size_t cap);
+  void encode_double(const double* data, size_t len, AsealPlaintext &ptxt);
+  size_t decode_double(AsealPlaintext &ptxt, double* data, size_t cap);
+
+  void add(AsealCiphertext &ctxt, AsealPlaintext &ptxt, AsealCiphertext &ctxt_res);
+  void add(AsealCiphertext &ctxt1, AsealCiphertext &ctxt2, AsealCiphertext &ctxt_res);
+  void subtract(AsealCiphertext &ctxt, AsealPlaintext &ptxt, AsealCiphertext &ctxt_res);
+  void subtract(AsealCiphertext &ctxt1, AsealCiphertext &ctxt2, AsealCiphertext &ctxt_res);
+  void multiply(AsealCiphertext &ctxt1, AsealCiphertext &ctxt2, AsealCiphertext &ctxt_res);
+  void multiply(AsealCiphertext &ctxt, AsealPlaintext &ptxt, AsealCiphertext &ctxt_res);
+  void square(AsealCiphertext &ctxt, AsealCiphertext &ctxt_res);
+  void rotate(AsealCiphertext &ctxt, int steps, AsealCiphertext &ctxt_res);
 };
 
 #endif /* ASEAL_H */
@@ -13,12 +13,13 @@ using namespace std;
 
 class ErrorTranslator {
 private:
-    const char* error_message;
+    const char* error_message = nullptr;
 
 public:
-    // Get the singleton instance of ErrorTranslator
+    // Get the instance of ErrorTranslator for the calling thread,
+    // so concurrent isolates do not overwrite each other's errors
     static ErrorTranslator& getInstance() {
-        static ErrorTranslator instance;
+        static thread_local ErrorTranslator instance;
         return instance;
     }
 
@@ -11,13 +11,26 @@
 #define FHE_H
 
 
-#include <map>    /* map */
+#include <cstring> /* strcmp */
+#include <stdexcept> /* invalid_argument */
 #include "afhe.h" /* Abstraction Layer */
 #include "error_handling.h" /* Error Handling */
+#include "packing.h" /* Batch Packing */
+#include "key_cache.h" /* Key Cache */
 
 // Include Backend Libraries
 #include <aseal.h>   /* Microsoft SEAL */
 
+/**
+ * @brief Exports the C API, the only visible symbols when built with
+ *        hidden visibility, see FHEL_BUNDLED.
+ */
+#if defined(_WIN32)
+#define FHEL_API __declspec(dllexport)
+#else
+#define FHEL_API __attribute__((visibility("default")))
+#endif
+
 extern "C" {
     /**
      * @brief Enum for the supported backend libraries.
@@ -54,71 +67,150 @@ extern "C" {
         galois_k = key::galois_keys,   /* Galois Keys */
     };
 
+    /**
+     * @brief Enum for the supported pseudo-random number generators.
+     * @return Integer representing the PRNG type.
+    */
+    enum fhe_prng_t : int32_t
+    {
+        default_p = prng::default_prng, /* Backend Default */
+        blake2xb_p = prng::blake2xb,    /* BLAKE2Xb */
+        shake256_p = prng::shake256,    /* SHAKE256 (FIPS 202) */
+    };
+
 }
 
+// The C API types share the values of the (abstract) types
+static_assert(static_cast<int>(fhe_backend_t::seal_b) == backend::seal_backend, "fhe_backend_t");
+static_assert(static_cast<int>(fhe_scheme_t::bgv_s) == scheme::bgv, "fhe_scheme_t");
+static_assert(static_cast<int>(fhe_key_t::galois_k) == key::galois_keys, "fhe_key_t");
+static_assert(static_cast<int>(fhe_prng_t::shake256_p) == prng::shake256, "fhe_prng_t");
+
 /**
- * @brief Map (abstract) backend type to fhe_backend_t
+ * @brief Convert (abstract) backend type to fhe_backend_t
 */
-static map<backend, fhe_backend_t> backend_map_backend_t{
-  {backend::no_backend, fhe_backend_t::no_b},
-  {backend::seal_backend, fhe_backend_t::seal_b},
-};
+constexpr fhe_backend_t to_backend_t(backend lib)
+{
+  return static_cast<fhe_backend_t>(lib);
+}
 
 /**
- * @brief Map scheme_t to (abstract) scheme type
+ * @brief Convert scheme_t to (abstract) scheme type
+ * @throws invalid_argument If the scheme is not supported.
 */
-static map<fhe_scheme_t, scheme> scheme_t_map_scheme{
-  {fhe_scheme_t::no_s, scheme::no_scheme},
-  {fhe_scheme_t::bfv_s, scheme::bfv},
-  {fhe_scheme_t::ckks_s, scheme::ckks},
-  {fhe_scheme_t::bgv_s, scheme::bgv},
-};
+inline scheme to_scheme(fhe_scheme_t scheme_type)
+{
+  switch (scheme_type)
+  {
+  case fhe_scheme_t::no_s:
+  case fhe_scheme_t::bfv_s:
+  case fhe_scheme_t::ckks_s:
+  case fhe_scheme_t::bgv_s:
+    return static_cast<scheme>(scheme_type);
+  }
+  throw invalid_argument("Unsupported Scheme");
+}
 
 /**
- * @brief Map key_t to (abstract) key type
+ * @brief Convert key_t to (abstract) key type
+ * @throws invalid_argument If the key type is not supported.
 */
-static map<key_t, key> key_t_map_key {
-  {fhe_key_t::no_k, key::no_key},
-  {fhe_key_t::public_k, key::public_key},
-  {fhe_key_t::secret_k, key::secret_key},
-  {fhe_key_t::relin_k, key::relin_keys},
-  {fhe_key_t::galois_k, key::galois_keys},
-};
+inline key to_key(fhe_key_t key_type)
+{
+  switch (key_type)
+  {
+  case fhe_key_t::no_k:
+  case fhe_key_t::public_k:
+  case fhe_key_t::secret_k:
+  case fhe_key_t::relin_k:
+  case fhe_key_t::galois_k:
+    return static_cast<key>(key_type);
+  }
+  throw invalid_argument("Unsupported Key Type");
+}
+
+/**
+ * @brief Convert prng_t to (abstract) prng type
+ * @throws invalid_argument If the PRNG is not supported.
+*/
+inline prng to_prng(fhe_prng_t prng_type)
+{
+  switch (prng_type)
+  {
+  case fhe_prng_t::default_p:
+  case fhe_prng_t::blake2xb_p:
+  case fhe_prng_t::shake256_p:
+    return static_cast<prng>(prng_type);
+  }
+  throw invalid_argument("Unsupported PRNG");
+}
 
-struct cmp_str
+/**
+ * @brief Name of a type, as passed by the bindings.
+*/
+template <typename T>
+struct type_name
 {
-   bool operator()(const char* a, const char* b) const
-   {
-      return std::strcmp(a, b) < 0;
-   }
+  const char* name;
+  T type;
 };
 
 /**
- * @brief Map string to type for the supported schemes.
+ * @brief Find a type by name.
+ * @param table The supported types.
+ * @param name The name to find.
+ * @param type Receives the type, if found.
+ * @return True if the name is supported.
 */
-static map<const char*, fhe_scheme_t, cmp_str> scheme_t_map{
+template <typename T, size_t N>
+inline bool find_type(const type_name<T> (&table)[N], const char* name, T &type)
+{
+  for (const type_name<T> &entry : table)
+  {
+    if (strcmp(entry.name, name) == 0)
+    {
+      type = entry.type;
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Names of the supported schemes.
+*/
+static constexpr type_name<fhe_scheme_t> scheme_t_names[] = {
   {"bfv", fhe_scheme_t::bfv_s},
   {"ckks", fhe_scheme_t::ckks_s},
   {"bgv", fhe_scheme_t::bgv_s},
 };
 
 /**
- * @brief Map string to type for the supported backend libraries.
+ * @brief Names of the supported backend libraries.
 */
-static map<const char*, fhe_backend_t, cmp_str> backend_t_map{
+static constexpr type_name<fhe_backend_t> backend_t_names[] = {
   {"seal", fhe_backend_t::seal_b},
 };
 
 /**
- * @brief Map string to type for the supported key types.
+ * @brief Names of the supported key types.
 */
-static map<const char*, fhe_key_t, cmp_str> key_t_map{
+static constexpr type_name<fhe_key_t> key_t_names[] = {
   {"public", fhe_key_t::public_k},
   {"secret", fhe_key_t::secret_k},
   {"relin", fhe_key_t::relin_k},
   {"galois", fhe_key_t::galois_k},
 };
 
+/**
+ * @brief Names of the supported PRNGs.
+*/
+static constexpr type_name<fhe_prng_t> prng_t_names[] = {
+  {"default", fhe_prng_t::default_p},
+  {"blake2xb", fhe_prng_t::blake2xb_p},
+  {"shake256", fhe_prng_t::shake256_p},
+};
+
 extern "C" {
     /**
      * @brief Convert backend type to string.
@@ -131,26 +223,41 @@ extern "C" {
      * @brief Check for an error.
      * @return Reference to the error translator.
     */
-    const char* check_for_error();
+    FHEL_API const char* check_for_error();
 
     /**
      * @brief Clear the error.
     */
-    void clear_error();
+    FHEL_API void clear_error();
 
     /**
      * @brief Convert string to backend type.
      * @param backend String to convert.
      * @return Backend library type.
      */
-    fhe_backend_t backend_t_from_string(const char* backend);
+    FHEL_API fhe_backend_t backend_t_from_string(const char* backend);
 
     /**
      * @brief Convert scheme type to string.
      * @param scheme Scheme to convert.
      * @return String representing the scheme.
      */
-    fhe_scheme_t scheme_t_from_string(const char* scheme);
+    FHEL_API fhe_scheme_t scheme_t_from_string(const char* scheme);
+
+    /**
+     * @brief Convert string to PRNG type.
+     * @param prng String to convert.
+     * @return PRNG type.
+     */
+    FHEL_API fhe_prng_t prng_t_from_string(const char* prng);
+
+    /**
+     * @brief Select the PRNG for encryption and key generation, before generating a context.
+     * @param afhe Pointer to the backend library.
+     * @param prng PRNG to use.
+     * @return 0 on success, or -1 on error.
+    */
+    FHEL_API int set_prng(Afhe* afhe, fhe_prng_t prng);
 
     /**
      * @brief Generate a context for the backend library.
@@ -164,7 +271,7 @@ extern "C" {
      * @param qi_sizes_length Length of the array of primes.
      * @return String representing the context.
     */
-    const char* generate_context(Afhe* afhe, fhe_scheme_t scheme, uint64_t poly_mod_degree, uint64_t pt_mod_bit, uint64_t pt_mod, uint64_t sec_level, const uint64_t* qi_sizes, uint64_t qi_sizes_length);
+    FHEL_API const char* generate_context(Afhe* afhe, fhe_scheme_t scheme, uint64_t poly_mod_degree, uint64_t pt_mod_bit, uint64_t pt_mod, uint64_t sec_level, const uint64_t* qi_sizes, uint64_t qi_sizes_length);
 
     /**
      * @brief Generate a context for the backend library from parameters.
@@ -172,65 +279,73 @@ extern "C" {
      * @param params String representing the parameters.
      * @return String representing the context.
     */
-    const char* generate_context_from_str(Afhe* afhe, const char* params, int size);
+    FHEL_API const char* generate_context_from_str(Afhe* afhe, const char* params, int size);
 
     /**
      * @brief Save the parameters for the backend library.
      * @param afhe Pointer to the backend library.
      * @return String representing the parameters.
     */
-    const char* save_parameters(Afhe* afhe);
+    FHEL_API const char* save_parameters(Afhe* afhe);
 
     /**
      * @brief Save the size of the parameters for the backend library.
     */
-    int save_parameters_size(Afhe* afhe);
+    FHEL_API int save_parameters_size(Afhe* afhe);
 
     /**
      * @brief Number of slots available based on parameters.
      * @param afhe Pointer to the backend library.
     */
-    int get_slot_count(Afhe* afhe);
+    FHEL_API int get_slot_count(Afhe* afhe);
 
     /**
      * @brief Convert string to key type.
      * @param key name to convert.
      * @return Key type.
      */
-    fhe_key_t key_t_from_string(const char* key);
+    FHEL_API fhe_key_t key_t_from_string(const char* key);
 
     /**
      * @brief Initialize a key for the backend library.
      * @param afhe Pointer to the backend library.
      * @param key_type Type of key to initialize.
     */
-    AKey* init_key(Afhe* afhe, fhe_key_t key_type);
+    FHEL_API AKey* init_key(Afhe* afhe, fhe_key_t key_type);
 
     /**
      * @brief Generate keys for the backend library.
      * @param afhe Pointer to the backend library.
     */
-    void generate_keys(Afhe* afhe);
+    FHEL_API void generate_keys(Afhe* afhe);
 
     /**
      * @brief Generate relinearization keys for the backend library.
      * @param afhe Pointer to the backend library.
     */
-    void generate_relin_keys(Afhe* afhe);
+    FHEL_API void generate_relin_keys(Afhe* afhe);
+
+    /**
+     * @brief Generate Galois keys for the backend library.
+     * @param afhe Pointer to the backend library.
+     * @param steps Array of rotation steps; when empty, every power of two is generated.
+     * @param count Number of rotation steps in the array.
+    */
+    FHEL_API void generate_galois_keys(Afhe* afhe, const int* steps, int count);
 
     /**
      * @brief Save key to a serialized format.
      * @param key Pointer to the key.
      * @return String representing the key.
     */
-    const char* save_key(AKey* key);
+    FHEL_API const char* save_key(AKey* key);
 
     /**
      * @brief Save the size of the key.
      * @param key Pointer to the key.
      * @return Size of the serialized key payload.
     */
-    int save_key_size(AKey* key);
+    FHEL_API int save_key_size(AKey* key);
 
     /**
      * @brief Load a key from a serialized format.
@@ -239,7 +354,26 @@ extern "C" {
      * @param size Size of the key.
      * @return Pointer to the loaded key.
     */
-    AKey* load_key(fhe_key_t key_type, Afhe* afhe, const char* data, int size);
+    FHEL_API AKey* load_key(fhe_key_t key_type, Afhe* afhe, const char* data, int size);
+
+    /**
+     * @brief Load a key from a serialized format, without validating it.
+     * @param key_type Type of key to load.
+     * @param afhe Pointer to the backend library.
+     * @param data String representing the key.
+     * @param size Size of the key.
+     * @return Pointer to the loaded key.
+     * @note Only for keys from a trusted source, e.g. stored by this server.
+    */
+    FHEL_API AKey* load_key_trusted(fhe_key_t key_type, Afhe* afhe, const char* data, int size);
+
+    /**
+     * @brief Install a key into the backend library, e.g. a loaded key.
+     * @param key_type Type of the key.
+     * @param afhe Pointer to the backend library.
+     * @param key Pointer to the key, its contents are moved into the backend.
+    */
+    FHEL_API void set_key(fhe_key_t key_type, Afhe* afhe, AKey* key);
 
     /**
      * @brief Retrieve the key data.
@@ -247,46 +381,59 @@ extern "C" {
      * @return Vector of integers representing the key.
      * @note Returned data cannot be used to reconstruct the key.
     */
-    uint64_t* get_key_data(AKey* key);
+    FHEL_API uint64_t* get_key_data(AKey* key);
 
     /**
      * @brief Retrieve the key data size.
      * @param key Pointer to the key.
      * @return Size of the key data.
     */
-    int get_key_data_size(AKey* key);
+    FHEL_API int get_key_data_size(AKey* key);
+
+    /**
+     * @brief Retrieve the fingerprint of the key material, computed once per key.
+     * @param key Pointer to the key.
+     * @return 64-bit hash of the raw key coefficients.
+    */
+    FHEL_API uint64_t get_key_fingerprint(AKey* key);
 
     /**
      * @brief Retrieve the public key.
      * @param afhe Pointer to the backend library.
     */
-    AKey* get_public_key(Afhe* afhe);
+    FHEL_API AKey* get_public_key(Afhe* afhe);
 
     /**
      * @brief Retrieve the secret key.
      * @param afhe Pointer to the backend library.
     */
-    AKey* get_secret_key(Afhe* afhe);
+    FHEL_API AKey* get_secret_key(Afhe* afhe);
 
     /**
      * @brief Retrieve the relinearization keys.
      * @param afhe Pointer to the backend library.
     */
-    AKey* get_relin_keys(Afhe* afhe);
+    FHEL_API AKey* get_relin_keys(Afhe* afhe);
+
+    /**
+     * @brief Retrieve the Galois keys.
+     * @param afhe Pointer to the backend library.
+    */
+    FHEL_API AKey* get_galois_keys(Afhe* afhe);
 
     /**
      * @brief Initialize the backend library.
      * @param backend Backend library to use.
      * @return Pointer to the backend library.
      */
-    Afhe* init_backend(fhe_backend_t backend);
+    FHEL_API Afhe* init_backend(fhe_backend_t backend);
 
     /**
      * @brief Initialize a plaintext.
      * @param backend Backend library to use.
      * @return Pointer to the plaintext.
      */
-    APlaintext* init_plaintext(fhe_backend_t backend);
+    FHEL_API APlaintext* init_plaintext(fhe_backend_t backend);
 
     /**
      * @brief Initialize a plaintext with a value.
@@ -294,42 +441,97 @@ extern "C" {
      * @param value Value to initialize the plaintext with.
      * @return Pointer to the plaintext.
      */
-    APlaintext* init_plaintext_value(fhe_backend_t backend, const char* value);
+    FHEL_API APlaintext* init_plaintext_value(fhe_backend_t backend, const char* value);
 
     /**
      * @brief Get the value of a plaintext.
      * @param plaintext Pointer to the plaintext.
      * @return Value of the plaintext.
      */
-    const char* get_plaintext_value(APlaintext* plaintext);
+    FHEL_API const char* get_plaintext_value(APlaintext* plaintext);
 
     /**
      * @brief Initialize a ciphertext.
      * @param backend Backend library to use.
      * @return Pointer to the ciphertext.
      */
-    ACiphertext* init_ciphertext(fhe_backend_t backend);
+    FHEL_API ACiphertext* init_ciphertext(fhe_backend_t backend);
+
+    /**
+     * @brief Release a plaintext, recycled by the backend for later results.
+     * @param afhe Pointer to the backend library, or null to delete the plaintext.
+     * @param plaintext Pointer to the plaintext, not used afterwards.
+     */
+    FHEL_API void delete_plaintext(Afhe* afhe, APlaintext* plaintext);
+
+    /**
+     * @brief Release a ciphertext, recycled by the backend for later results.
+     * @param afhe Pointer to the backend library, or null to delete the ciphertext.
+     * @param ciphertext Pointer to the ciphertext, not used afterwards.
+     */
+    FHEL_API void delete_ciphertext(Afhe* afhe, ACiphertext* ciphertext);
+
+    /**
+     * @brief Set the number of released ciphertexts and plaintexts each kept for reuse.
+     * @param afhe Pointer to the backend library.
+     * @param capacity Maximum of each, zero to delete every released object.
+     * @return 0 on success, or -1 on error.
+     */
+    FHEL_API int set_pool_capacity(Afhe* afhe, int capacity);
 
     /**
      * @brief Get the size of a ciphertext.
      * @param ciphertext Pointer to the ciphertext.
      * @return Size of the ciphertext.
      */
-    int get_ciphertext_size(ACiphertext* ciphertext);
+    FHEL_API int get_ciphertext_size(ACiphertext* ciphertext);
+
+    /**
+     * @brief Get the scale of a ciphertext, used by the CKKS scheme.
+     * @param ciphertext Pointer to the ciphertext.
+     * @return Scale of the ciphertext.
+     */
+    FHEL_API double get_ciphertext_scale(ACiphertext* ciphertext);
+
+    /**
+     * @brief Set the scale of a ciphertext, used by the CKKS scheme.
+     * @param ciphertext Pointer to the ciphertext.
+     * @param scale Scale of the ciphertext.
+     */
+    FHEL_API void set_ciphertext_scale(ACiphertext* ciphertext, double scale);
 
     /**
      * @brief Convert the ciphertext to a string.
      * @param ciphertext Pointer to the ciphertext.
-     * @return String representing the ciphertext.
+     * @return String representing the ciphertext, or null on error.
     */
-    const char* save_ciphertext(ACiphertext* ciphertext);
+    FHEL_API const char* save_ciphertext(ACiphertext* ciphertext);
+
+    /**
+     * @brief Compact the ciphertext for transfer, then convert it to a string.
+     * @param afhe Pointer to the backend library.
+     * @param ciphertext Pointer to the ciphertext, switched down inplace.
+     * @param min_budget Bits of estimated noise budget to keep.
+     * @return String representing the ciphertext; its size is given by save_ciphertext_size.
+     *         Null on error, e.g. when the noise of a BGV or BFV ciphertext is unknown.
+    */
+    FHEL_API const char* save_ciphertext_compact(Afhe* afhe, ACiphertext* ciphertext, int min_budget);
 
     /**
      * @brief Save the size of the ciphertext.
      * @param ciphertext Pointer to the ciphertext.
      * @return Size of the serialized ciphertext payload.
     */
-    int save_ciphertext_size(ACiphertext* ciphertext);
+    FHEL_API int save_ciphertext_size(ACiphertext* ciphertext);
+
+    /**
+     * @brief Serialize the ciphertext into a caller-provided buffer.
+     * @param ciphertext Pointer to the ciphertext.
+     * @param out Buffer of at least save_ciphertext_size bytes.
+     * @param size Size of the buffer.
+     * @return Number of bytes written, or -1 on error.
+    */
+    FHEL_API int save_ciphertext_inplace(ACiphertext* ciphertext, uint8_t* out, int size);
 
     /**
      * @brief Load a ciphertext from a string.
@@ -338,7 +540,7 @@ extern "C" {
      * @param size Size of the ciphertext.
      * @return Pointer to the loaded ciphertext.
     */
-    ACiphertext* load_ciphertext(Afhe* afhe, const char* data, int size);
+    FHEL_API ACiphertext* load_ciphertext(Afhe* afhe, const char* data, int size);
 
     /**
      * @brief Encrypt a plaintext.
@@ -346,7 +548,17 @@ extern "C" {
      * @param plaintext Pointer to the plaintext.
      * @return Pointer to the ciphertext.
     */
-    ACiphertext* encrypt(Afhe* afhe, APlaintext* plaintext);
+    FHEL_API ACiphertext* encrypt(Afhe* afhe, APlaintext* plaintext);
+
+    /**
+     * @brief Encrypt many plaintexts, sharing one encryptor across threads.
+     * @param afhe Pointer to the backend library.
+     * @param plaintexts Array of count pointers to the plaintexts.
+     * @param count Number of plaintexts.
+     * @param out Array of count pointers, filled with the new ciphertexts.
+     * @return 0 on success, or -1 on error, with every pointer in out set to null.
+    */
+    FHEL_API int encrypt_many(Afhe* afhe, APlaintext** plaintexts, int count, ACiphertext** out);
 
     /**
      * @brief Decrypt a ciphertext.
@@ -354,7 +566,89 @@ extern "C" {
      * @param ciphertext Pointer to the ciphertext.
      * @return Pointer to the plaintext.
     */
-    APlaintext* decrypt(Afhe* afhe, ACiphertext* ciphertext);
+    FHEL_API APlaintext* decrypt(Afhe* afhe, ACiphertext* ciphertext);
+
+    /**
+     * @brief Encode and encrypt an array of integers in a single call.
+     * @param afhe Pointer to the backend library.
+     * @param data Array of integers.
+     * @param size Number of integers in the array.
+     * @return Pointer to the ciphertext.
+    */
+    FHEL_API ACiphertext* encrypt_ints(Afhe* afhe, const uint64_t* data, int size);
+
+    /**
+     * @brief Encode and encrypt an array of doubles in a single call.
+     * @param afhe Pointer to the backend library.
+     * @param data Array of doubles.
+     * @param size Number of doubles in the array.
+     * @return Pointer to the ciphertext.
+    */
+    FHEL_API ACiphertext* encrypt_doubles(Afhe* afhe, const double* data, int size);
+
+    /**
+     * @brief Decrypt and decode a ciphertext into a caller-provided array of integers.
+     * @param afhe Pointer to the backend library.
+     * @param ciphertext Pointer to the ciphertext.
+     * @param out Destination array, owned by the caller.
+     * @param cap Capacity of the destination array.
+     * @return Number of integers written, or -1 on error.
+    */
+    FHEL_API int decrypt_ints_into(Afhe* afhe, ACiphertext* ciphertext, uint64_t* out, size_t cap);
+
+    /**
+     * @brief Decrypt and decode a ciphertext into a caller-provided array of doubles.
+     * @param afhe Pointer to the backend library.
+     * @param ciphertext Pointer to the ciphertext.
+     * @param out Destination array, owned by the caller.
+     * @param cap Capacity of the destination array.
+     * @return Number of doubles written, or -1 on error.
+    */
+    FHEL_API int decrypt_doubles_into(Afhe* afhe, ACiphertext* ciphertext, double* out, size_t cap);
+
+    /**
+     * @brief Encrypt rows of integers, one ciphertext per row.
+     * @param afhe Pointer to the backend library.
+     * @param data Array of count * size integers, stored row by row.
+     * @param size Number of integers in each row.
+     * @param count Number of rows.
+     * @param out Array of count pointers, filled with the new ciphertexts.
+     * @return 0 on success, or -1 on error, with every pointer in out set to null.
+    */
+    FHEL_API int encrypt_ints_batch(Afhe* afhe, const uint64_t* data, int size, int count, ACiphertext** out);
+
+    /**
+     * @brief Encrypt rows of doubles, one ciphertext per row.
+     * @param afhe Pointer to the backend library.
+     * @param data Array of count * size doubles, stored row by row.
+     * @param size Number of doubles in each row.
+     * @param count Number of rows.
+     * @param out Array of count pointers, filled with the new ciphertexts.
+     * @return 0 on success, or -1 on error, with every pointer in out set to null.
+    */
+    FHEL_API int encrypt_doubles_batch(Afhe* afhe, const double* data, int size, int count, ACiphertext** out);
+
+    /**
+     * @brief Decrypt ciphertexts into rows of a caller-provided array of integers.
+     * @param afhe Pointer to the backend library.
+     * @param ciphertexts Array of count pointers to ciphertexts.
+     * @param count Number of ciphertexts.
+     * @param out Destination array of count * cap integers, owned by the caller.
+     * @param cap Number of integers reserved for each row.
+     * @return Number of integers written in each row, or -1 on error.
+    */
+    FHEL_API int decrypt_ints_batch_into(Afhe* afhe, ACiphertext** ciphertexts, int count, uint64_t* out, size_t cap);
+
+    /**
+     * @brief Decrypt ciphertexts into rows of a caller-provided array of doubles.
+     * @param afhe Pointer to the backend library.
+     * @param ciphertexts Array of count pointers to ciphertexts.
+     * @param count Number of ciphertexts.
+     * @param out Destination array of count * cap doubles, owned by the caller.
+     * @param cap Number of doubles reserved for each row.
+     * @return Number of doubles written in each row, or -1 on error.
+    */
+    FHEL_API int decrypt_doubles_batch_into(Afhe* afhe, ACiphertext** ciphertexts, int count, double* out, size_t cap);
 
     /**
      * @brief Calculate the added noise to the ciphertext.
@@ -362,7 +656,15 @@ extern "C" {
      * @param ciphertext Pointer to the ciphertext.
      * @return Noise added to the ciphertext.
     */
-    int invariant_noise_budget(Afhe* afhe, ACiphertext* ciphertext);
+    FHEL_API int invariant_noise_budget(Afhe* afhe, ACiphertext* ciphertext);
+
+    /**
+     * @brief Estimate the noise budget of a ciphertext, without the secret key.
+     * @param afhe Pointer to the backend library.
+     * @param ciphertext Pointer to the ciphertext.
+     * @return Estimated noise budget in bits, or -1 when unknown or on error.
+    */
+    FHEL_API int estimate_noise_budget(Afhe* afhe, ACiphertext* ciphertext);
 
     /**
      * @brief Relinearize a ciphertext.
@@ -370,14 +672,80 @@ extern "C" {
      * @param ciphertext Pointer to the ciphertext.
      * @return Pointer to the relinearized ciphertext.
     */
-    ACiphertext* relinearize(Afhe* afhe, ACiphertext* ciphertext);
+    FHEL_API ACiphertext* relinearize(Afhe* afhe, ACiphertext* ciphertext);
 
     /**
      * @brief Mod switch to the next level for a ciphertext.
      * @param afhe Pointer to the backend library.
      * @param ciphertext Pointer to the ciphertext.
     */
-    void mod_switch_to_next(Afhe* afhe, ACiphertext* ciphertext);
+    FHEL_API void mod_switch_to_next(Afhe* afhe, ACiphertext* ciphertext);
+
+    /**
+     * @brief Switch a ciphertext down to the lowest level that still decrypts correctly.
+     * @param afhe Pointer to the backend library.
+     * @param ciphertext Pointer to the ciphertext, switched down inplace.
+     * @param min_budget Bits of estimated noise budget to keep.
+     * @return Number of levels dropped, or -1 on error, e.g. when the noise of a BGV or BFV ciphertext is unknown.
+    */
+    FHEL_API int compact_for_transfer(Afhe* afhe, ACiphertext* ciphertext, int min_budget);
+
+    /**
+     * @brief Rescale a ciphertext to the next level, used by the CKKS scheme.
+     * @param afhe Pointer to the backend library.
+     * @param ciphertext Pointer to the ciphertext, rescaled inplace.
+    */
+    FHEL_API void rescale_to_next(Afhe* afhe, ACiphertext* ciphertext);
+
+    /**
+     * @brief Get the index of a ciphertext's parameters in the modulus chain.
+     * @param afhe Pointer to the backend library.
+     * @param ciphertext Pointer to the ciphertext.
+     * @return Chain index, 0 at the last level, or -1 on error.
+    */
+    FHEL_API int get_chain_index(Afhe* afhe, ACiphertext* ciphertext);
+
+    /**
+     * @brief Get the level of a ciphertext, the number of levels dropped since encryption.
+     * @param afhe Pointer to the backend library.
+     * @param ciphertext Pointer to the ciphertext.
+     * @return Level of the ciphertext, or -1 on error.
+    */
+    FHEL_API int get_ciphertext_level(Afhe* afhe, ACiphertext* ciphertext);
+
+    /**
+     * @brief Get the number of primes in a ciphertext's coefficient modulus.
+     * @param afhe Pointer to the backend library.
+     * @param ciphertext Pointer to the ciphertext.
+     * @return Number of primes, or -1 on error.
+    */
+    FHEL_API int get_coeff_modulus_count(Afhe* afhe, ACiphertext* ciphertext);
+
+    /**
+     * @brief Mod switch a ciphertext down to a level.
+     * @param afhe Pointer to the backend library.
+     * @param ciphertext Pointer to the ciphertext, switched down inplace.
+     * @param level Level to switch to, see get_ciphertext_level().
+     * @return 0 on success, or -1 on error.
+    */
+    FHEL_API int mod_switch_to_level(Afhe* afhe, ACiphertext* ciphertext, int level);
+
+    /**
+     * @brief Get the number of levels in the modulus chain, the rows of get_level_costs().
+     * @param afhe Pointer to the backend library.
+     * @return Number of levels, or -1 on error.
+    */
+    FHEL_API int get_level_count(Afhe* afhe);
+
+    /**
+     * @brief Get the size and relative cost of operations at each level.
+     * @param afhe Pointer to the backend library.
+     * @param out Destination array, filled with 4 doubles per level: number of primes,
+     *            bits of the coefficient modulus, relative cost of a product and of key switching.
+     * @param cap Capacity of the destination array.
+     * @return Number of levels written, or -1 on error.
+    */
+    FHEL_API int get_level_costs(Afhe* afhe, double* out, size_t cap);
 
     /**
      * @brief Add two ciphertexts.
@@ -386,7 +754,16 @@ extern "C" {
      * @param ciphertext2 Pointer to the second ciphertext.
      * @return Pointer to the resulting ciphertext.
     */
-    ACiphertext* add(Afhe* afhe, ACiphertext* ciphertext1, ACiphertext* ciphertext2);
+    FHEL_API ACiphertext* add(Afhe* afhe, ACiphertext* ciphertext1, ACiphertext* ciphertext2);
+
+    /**
+     * @brief Add many ciphertexts, accumulated in place.
+     * @param afhe Pointer to the backend library.
+     * @param ciphertexts Array of pointers to the ciphertexts.
+     * @param count Number of ciphertexts.
+     * @return Pointer to the resulting ciphertext.
+    */
+    FHEL_API ACiphertext* add_many(Afhe* afhe, ACiphertext** ciphertexts, int count);
 
     /**
      * @brief Add a plaintext to a ciphertext.
@@ -395,7 +772,7 @@ extern "C" {
      * @param plaintext Pointer to the plaintext.
      * @return Pointer to the resulting ciphertext.
     */
-    ACiphertext* add_plain(Afhe* afhe, ACiphertext* ciphertext, APlaintext* plaintext);
+    FHEL_API ACiphertext* add_plain(Afhe* afhe, ACiphertext* ciphertext, APlaintext* plaintext);
 
     /**
      * @brief Subtract two ciphertexts.
@@ -404,7 +781,7 @@ extern "C" {
      * @param ciphertext2 Pointer to the second ciphertext.
      * @return Pointer to the resulting ciphertext.
     */
-    ACiphertext* subtract(Afhe* afhe, ACiphertext* ciphertext1, ACiphertext* ciphertext2);
+    FHEL_API ACiphertext* subtract(Afhe* afhe, ACiphertext* ciphertext1, ACiphertext* ciphertext2);
 
     /**
      * @brief Subtract a plaintext from a ciphertext.
@@ -412,7 +789,7 @@ extern "C" {
      * @param ciphertext Pointer to the ciphertext.
      * @param plaintext Pointer to the plaintext.
     */
-    ACiphertext* subtract_plain(Afhe* afhe, ACiphertext* ciphertext, APlaintext* plaintext);
+    FHEL_API ACiphertext* subtract_plain(Afhe* afhe, ACiphertext* ciphertext, APlaintext* plaintext);
 
     /**
      * @brief Multiply two ciphertexts.
@@ -421,7 +798,16 @@ extern "C" {
      * @param ciphertext2 Pointer to the second ciphertext.
      * @return Pointer to the resulting ciphertext.
     */
-    ACiphertext* multiply(Afhe* afhe, ACiphertext* ciphertext1, ACiphertext* ciphertext2);
+    FHEL_API ACiphertext* multiply(Afhe* afhe, ACiphertext* ciphertext1, ACiphertext* ciphertext2);
+
+    /**
+     * @brief Multiply many ciphertexts in a balanced tree, relinearizing each product.
+     * @param afhe Pointer to the backend library.
+     * @param ciphertexts Array of pointers to the ciphertexts.
+     * @param count Number of ciphertexts.
+     * @return Pointer to the resulting ciphertext.
+    */
+    FHEL_API ACiphertext* multiply_many(Afhe* afhe, ACiphertext** ciphertexts, int count);
 
     /**
      * @brief Multiply a ciphertext by a plaintext.
@@ -430,7 +816,7 @@ extern "C" {
      * @param plaintext Pointer to the plaintext.
      * @return Pointer to the resulting ciphertext.
     */
-    ACiphertext* multiply_plain(Afhe* afhe, ACiphertext* ciphertext, APlaintext* plaintext);
+    FHEL_API ACiphertext* multiply_plain(Afhe* afhe, ACiphertext* ciphertext, APlaintext* plaintext);
 
     /**
      * @brief Square a ciphertext.
@@ -438,7 +824,7 @@ extern "C" {
      * @param ciphertext Pointer to the ciphertext.
      * @return Pointer to the resulting ciphertext.
     */
-    ACiphertext* square(Afhe* afhe, ACiphertext* ciphertext);
+    FHEL_API ACiphertext* square(Afhe* afhe, ACiphertext* ciphertext);
 
     /**
      * @brief Raise ciphertext to a power.
@@ -447,7 +833,37 @@ extern "C" {
      * @param power Power to raise the ciphertext to.
      * @return Pointer to the resulting ciphertext.
     */
-    ACiphertext* power(Afhe* afhe, ACiphertext* ciphertext, int power);
+    FHEL_API ACiphertext* power(Afhe* afhe, ACiphertext* ciphertext, int power);
+
+    /**
+     * @brief Evaluate a polynomial on a ciphertext, used by CKKS scheme.
+     * @param afhe Pointer to the backend library.
+     * @param ciphertext Pointer to the ciphertext.
+     * @param coeffs Array of coefficients, in ascending order of degree.
+     * @param count Number of coefficients.
+     * @return Pointer to the resulting ciphertext.
+    */
+    FHEL_API ACiphertext* eval_polynomial(Afhe* afhe, ACiphertext* ciphertext, const double* coeffs, int count);
+
+    /**
+     * @brief Rotate the slots of a ciphertext.
+     * @param afhe Pointer to the backend library.
+     * @param ciphertext Pointer to the ciphertext.
+     * @param steps Number of slots to rotate by; positive rotates left.
+     * @return Pointer to the rotated ciphertext.
+    */
+    FHEL_API ACiphertext* rotate(Afhe* afhe, ACiphertext* ciphertext, int steps);
+
+    /**
+     * @brief Rotate one ciphertext by a batch of steps, as independent rotations run in parallel.
+     * @param afhe Pointer to the backend library.
+     * @param ciphertext Pointer to the ciphertext.
+     * @param steps Array of rotation steps.
+     * @param count Number of rotation steps.
+     * @param out Array of count pointers, filled with the rotated ciphertexts.
+     * @return 0 on success, or -1 on error, with every pointer in out set to null.
+    */
+    FHEL_API int rotate_batch(Afhe* afhe, ACiphertext* ciphertext, const int* steps, int count, ACiphertext** out);
 
     /**
      * @brief Encode a vector of integers into a plaintext.
@@ -455,7 +871,7 @@ extern "C" {
      * @param data Vector of integers to encode.
      * @return Pointer to the plaintext.
     */
-    APlaintext* encode_int(Afhe* afhe, uint64_t* data, int len);
+    FHEL_API APlaintext* encode_int(Afhe* afhe, uint64_t* data, int len);
 
     /**
      * @brief Decode a plaintext into a vector of integers.
@@ -463,7 +879,17 @@ extern "C" {
      * @param plaintext Pointer to the plaintext.
      * @return Vector of integers.
     */
-    uint64_t* decode_int(Afhe* afhe, APlaintext* plaintext);
+    FHEL_API uint64_t* decode_int(Afhe* afhe, APlaintext* plaintext);
+
+    /**
+     * @brief Decode a plaintext directly into a caller-provided array of integers.
+     * @param afhe Pointer to the backend library.
+     * @param plaintext Pointer to the plaintext.
+     * @param out Destination array, owned by the caller.
+     * @param cap Capacity of the destination array.
+     * @return Number of integers written, or -1 on error.
+    */
+    FHEL_API int decode_int_into(Afhe* afhe, APlaintext* plaintext, uint64_t* out, size_t cap);
 
     /**
      * @brief Encode a vector of doubles into a plaintext.
@@ -471,7 +897,7 @@ extern "C" {
      * @param data Vector of doubles to encode.
      * @return Pointer to the plaintext.
     */
-    APlaintext* encode_double(Afhe* afhe, double* data, int len);
+    FHEL_API APlaintext* encode_double(Afhe* afhe, double* data, int len);
 
     /**
      * @brief Encode a double into a plaintext.
@@ -479,7 +905,7 @@ extern "C" {
      * @param data Double to encode.
      * @return Pointer to the plaintext.
     */
-    APlaintext* encode_double_value(Afhe* afhe, double data);
+    FHEL_API APlaintext* encode_double_value(Afhe* afhe, double data);
 
     /**
      * @brief Decode a plaintext into a vector of doubles.
@@ -487,7 +913,232 @@ extern "C" {
      * @param plaintext Pointer to the plaintext.
      * @return Vector of doubles.
     */
-    double* decode_double(Afhe* afhe, APlaintext* plaintext);
+    FHEL_API double* decode_double(Afhe* afhe, APlaintext* plaintext);
+
+    /**
+     * @brief Decode a plaintext directly into a caller-provided array of doubles.
+     * @param afhe Pointer to the backend library.
+     * @param plaintext Pointer to the plaintext.
+     * @param out Destination array, owned by the caller.
+     * @param cap Capacity of the destination array.
+     * @return Number of doubles written, or -1 on error.
+    */
+    FHEL_API int decode_double_into(Afhe* afhe, APlaintext* plaintext, double* out, size_t cap);
+
+    /**
+     * @brief Encode complex numbers, stored as interleaved (real, imaginary) doubles.
+     * @param afhe Pointer to the backend library.
+     * @param data Array of 2 * size doubles.
+     * @param size Number of complex numbers in the array.
+     * @return Pointer to the plaintext.
+    */
+    FHEL_API APlaintext* encode_complex(Afhe* afhe, const double* data, int size);
+
+    /**
+     * @brief Decode a plaintext into interleaved (real, imaginary) doubles.
+     * @param afhe Pointer to the backend library.
+     * @param plaintext Pointer to the plaintext.
+     * @param out Destination array of 2 * cap doubles, owned by the caller.
+     * @param cap Number of complex numbers the destination can hold.
+     * @return Number of complex numbers written, or -1 on error.
+    */
+    FHEL_API int decode_complex_into(Afhe* afhe, APlaintext* plaintext, double* out, size_t cap);
+
+    /**
+     * @brief Initialize a layout packing many records into one plaintext.
+     * @param afhe Pointer to the backend library.
+     * @param record_size Number of values in each record.
+     * @return Pointer to the packing layout.
+    */
+    FHEL_API Packing* init_packing(Afhe* afhe, int record_size);
+
+    /**
+     * @brief Delete a packing layout.
+     * @param packing Pointer to the packing layout.
+    */
+    FHEL_API void delete_packing(Packing* packing);
+
+    /**
+     * @brief Maximum number of records packed into one plaintext.
+     * @param packing Pointer to the packing layout.
+    */
+    FHEL_API int get_packing_capacity(Packing* packing);
+
+    /**
+     * @brief Encode contiguous integer records into a plaintext.
+     * @param afhe Pointer to the backend library.
+     * @param packing Pointer to the packing layout.
+     * @param records Array of count * record_size integers.
+     * @param count Number of records.
+     * @return Pointer to the plaintext.
+    */
+    FHEL_API APlaintext* pack_int(Afhe* afhe, Packing* packing, uint64_t* records, int count);
+
+    /**
+     * @brief Decode integer records from a packed plaintext.
+     * @param afhe Pointer to the backend library.
+     * @param packing Pointer to the packing layout.
+     * @param plaintext Pointer to the plaintext.
+     * @param records Destination array of count * record_size integers.
+     * @param count Number of records.
+     * @return Number of records decoded, or -1 on error.
+    */
+    FHEL_API int unpack_int(Afhe* afhe, Packing* packing, APlaintext* plaintext, uint64_t* records, int count);
+
+    /**
+     * @brief Encode one integer record into every record position.
+     * @param afhe Pointer to the backend library.
+     * @param packing Pointer to the packing layout.
+     * @param record Array of record_size integers.
+     * @return Pointer to the plaintext, an operand applied to every record.
+    */
+    FHEL_API APlaintext* pack_replicated_int(Afhe* afhe, Packing* packing, uint64_t* record);
+
+    /**
+     * @brief Encode contiguous floating point records into a plaintext.
+     * @param afhe Pointer to the backend library.
+     * @param packing Pointer to the packing layout.
+     * @param records Array of count * record_size doubles.
+     * @param count Number of records.
+     * @return Pointer to the plaintext.
+    */
+    FHEL_API APlaintext* pack_double(Afhe* afhe, Packing* packing, double* records, int count);
+
+    /**
+     * @brief Decode floating point records from a packed plaintext.
+     * @param afhe Pointer to the backend library.
+     * @param packing Pointer to the packing layout.
+     * @param plaintext Pointer to the plaintext.
+     * @param records Destination array of count * record_size doubles.
+     * @param count Number of records.
+     * @return Number of records decoded, or -1 on error.
+    */
+    FHEL_API int unpack_double(Afhe* afhe, Packing* packing, APlaintext* plaintext, double* records, int count);
+
+    /**
+     * @brief Encode one floating point record into every record position.
+     * @param afhe Pointer to the backend library.
+     * @param packing Pointer to the packing layout.
+     * @param record Array of record_size doubles.
+     * @return Pointer to the plaintext, an operand applied to every record.
+    */
+    FHEL_API APlaintext* pack_replicated_double(Afhe* afhe, Packing* packing, double* record);
+
+    /**
+     * @brief Isolate one record of a packed ciphertext.
+     * @param afhe Pointer to the backend library.
+     * @param packing Pointer to the packing layout.
+     * @param ciphertext Pointer to the packed ciphertext.
+     * @param record Index of the record to keep.
+     * @return Pointer to the resulting ciphertext; for CKKS, rescaled to the next level.
+    */
+    FHEL_API ACiphertext* select_record(Afhe* afhe, Packing* packing, ACiphertext* ciphertext, int record);
+
+    /**
+     * @brief Initialize an empty plain matrix for the backend library.
+     * @param backend Backend library to use.
+     * @return Pointer to the plain matrix.
+    */
+    FHEL_API APlainMatrix* init_plain_matrix(fhe_backend_t backend);
+
+    /**
+     * @brief Encode a matrix of integers for products with encrypted vectors.
+     * @param afhe Pointer to the backend library.
+     * @param data Array of rows * cols integers, stored row by row.
+     * @param rows Number of rows.
+     * @param cols Number of columns.
+     * @return Pointer to the encoded matrix, reused by every product, or null on error.
+    */
+    FHEL_API APlainMatrix* encode_matrix_int(Afhe* afhe, const uint64_t* data, int rows, int cols);
+
+    /**
+     * @brief Encode a matrix of doubles for products with encrypted vectors.
+     * @param afhe Pointer to the backend library.
+     * @param data Array of rows * cols doubles, stored row by row.
+     * @param rows Number of rows.
+     * @param cols Number of columns.
+     * @return Pointer to the encoded matrix, reused by every product, or null on error.
+    */
+    FHEL_API APlainMatrix* encode_matrix_double(Afhe* afhe, const double* data, int rows, int cols);
+
+    /**
+     * @brief Delete an encoded matrix, and its plaintext diagonals.
+     * @param matrix Pointer to the encoded matrix.
+    */
+    FHEL_API void delete_plain_matrix(APlainMatrix* matrix);
+
+    /**
+     * @brief Dimension of the padded square matrix, the period of the vector layout.
+     * @param matrix Pointer to the encoded matrix.
+    */
+    FHEL_API int get_matrix_dim(APlainMatrix* matrix);
+
+    /**
+     * @brief Rotation steps used by a product with the matrix.
+     * @param matrix Pointer to the encoded matrix.
+     * @param out Destination array, owned by the caller.
+     * @param cap Capacity of the destination array.
+     * @return Total number of rotation steps, or -1 on error.
+    */
+    FHEL_API int get_matrix_rotation_steps(APlainMatrix* matrix, int* out, int cap);
+
+    /**
+     * @brief Multiply a plaintext matrix by an encrypted vector.
+     * @param afhe Pointer to the backend library.
+     * @param matrix Pointer to the encoded matrix.
+     * @param ciphertext Pointer to the encrypted vector, replicated with period get_matrix_dim().
+     * @return Pointer to the encrypted product.
+    */
+    FHEL_API ACiphertext* matvec_plain(Afhe* afhe, APlainMatrix* matrix, ACiphertext* ciphertext);
+
+    /**
+     * @brief Create a cache of deserialized keys, shared by many backends.
+     * @param budget_bytes Memory budget, in bytes of serialized keys.
+     * @param spill_dir Directory where evicted keys are written; empty or null to drop them.
+     * @return Pointer to the key cache.
+    */
+    FHEL_API KeyCache* init_key_cache(uint64_t budget_bytes, const char* spill_dir);
+
+    /**
+     * @brief Delete a key cache, and its spilled files.
+     * @param cache Pointer to the key cache.
+     * @note Keys attached to a backend remain valid.
+    */
+    FHEL_API void delete_key_cache(KeyCache* cache);
+
+    /**
+     * @brief Attach a serialized key to the backend, deserialized only on a cache miss.
+     * @param cache Pointer to the key cache.
+     * @param key_type Type of the key; secret keys are rejected.
+     * @param afhe Pointer to the backend library.
+     * @param data Serialized key.
+     * @param size Size of the serialized key.
+     * @param trusted Non-zero to skip validating the key on a miss.
+     * @return Cache id of the key, a hash of its serialization used by key_cache_attach().
+     * @note The cache id differs from get_key_fingerprint(), a hash of the key material.
+    */
+    FHEL_API uint64_t key_cache_load(KeyCache* cache, fhe_key_t key_type, Afhe* afhe, const char* data, int size, int trusted);
+
+    /**
+     * @brief Attach a cached key to the backend, by cache id.
+     * @param cache Pointer to the key cache.
+     * @param afhe Pointer to the backend library.
+     * @param cache_id Cache id returned by key_cache_load().
+     * @return 1 if attached, 0 if the key is not cached, or -1 on error.
+    */
+    FHEL_API int key_cache_attach(KeyCache* cache, Afhe* afhe, uint64_t cache_id);
+
+    /**
+     * @brief Number of bytes held in memory by the key cache.
+     * @param cache Pointer to the key cache.
+    */
+    FHEL_API uint64_t key_cache_memory_size(KeyCache* cache);
+
+    /**
+     * @brief Number of keys in the key cache, in memory or spilled.
+     * @param cache Pointer to the key cache.
+    */
+    FHEL_API int key_cache_count(KeyCache* cache);
 }
 
 #endif /* FHE_H */
@@ -0,0 +1,83 @@
+/**
+ * @file fhe_typed.h
+ * ------------------------------------------------------------------
+ * @brief Typed interface to the backends, with the backend types
+ *        resolved at compile time instead of through Afhe.
+ * ------------------------------------------------------------------
+ * @author Jeffrey Murray Jr (jeffmur)
+ */
+
+#ifndef FHE_TYPED_H
+#define FHE_TYPED_H
+
+#include <cstdint>  /* uint64_t */
+#include "afhe.h"   /* Abstraction */
+#include <aseal.h>  /* Microsoft SEAL */
+
+using namespace std;
+
+/**
+ * @brief Types of the Microsoft SEAL backend.
+ */
+struct SealBackend {
+  using backend_type = Aseal;
+  using plaintext_type = AsealPlaintext;
+  using ciphertext_type = AsealCiphertext;
+  static constexpr backend tag = backend::seal_backend;
+};
+
+/**
+ * @brief Fully Homomorphic Encryption over a backend known at compile time.
+ *
+ * Operations take plaintexts and ciphertexts of the backend types and resolve
+ * to the typed overloads of the backend, e.g. Aseal::add(AsealCiphertext&, ...),
+ * bound statically and without the backend checks of the Afhe overrides.
+ * Used by C++ callers with many small operations, e.g. Fhe<SealBackend>;
+ * the C API remains on Afhe.
+ *
+ * @tparam Backend The backend types, e.g. SealBackend.
+ */
+template <typename Backend>
+class Fhe {
+public:
+  using Plaintext = typename Backend::plaintext_type;
+  using Ciphertext = typename Backend::ciphertext_type;
+
+  /**
+   * @brief Returns the backend, to set up the context, keys and encoders.
+  */
+  typename Backend::backend_type& backend() { return impl; }
+
+  // ------------------ Cryptography ------------------
+
+  void encrypt(Plaintext &ptxt, Ciphertext &ctxt) { impl.encrypt(ptxt, ctxt); }
+  void decrypt(Ciphertext &ctxt, Plaintext &ptxt) { impl.decrypt(ctxt, ptxt); }
+  void relinearize(Ciphertext &ctxt) { impl.relinearize(ctxt); }
+  void mod_switch_to_next(Ciphertext &ctxt) { impl.mod_switch_to_next(ctxt); }
+  void rescale_to_next(Ciphertext &ctxt) { impl.rescale_to_next(ctxt); }
+  int level(Ciphertext &ctxt) { return impl.level(ctxt); }
+
+  // -------------------- Codec --------------------
+
+  int slot_count() { return impl.slot_count(); }
+  void encode_int(const uint64_t* data, size_t len, Plaintext &ptxt) { impl.encode_int(data, len, ptxt); }
+  size_t decode_int(Plaintext &ptxt, uint64_t* data, size_t cap) { return impl.decode_int(ptxt, data, cap); }
+  void encode_double(const double* data, size_t len, Plaintext &ptxt) { impl.encode_double(data, len, ptxt); }
+  size_t decode_double(Plaintext &ptxt, double* data, size_t cap) { return impl.decode_double(ptxt, data, cap); }
+
+  // ------------------ Arithmetic ------------------
+
+  void add(Ciphertext &ctxt1, Ciphertext &ctxt2, Ciphertext &ctxt_res) { impl.add(ctxt1, ctxt2, ctxt_res); }
+  void add(Ciphertext &ctxt, Plaintext &ptxt, Ciphertext &ctxt_res) { impl.add(ctxt, ptxt, ctxt_res); }
+  void subtract(Ciphertext &ctxt1, Ciphertext &ctxt2, Ciphertext &ctxt_res) { impl.subtract(ctxt1, ctxt2, ctxt_res); }
+  void subtract(Ciphertext &ctxt, Plaintext &ptxt, Ciphertext &ctxt_res) { impl.subtract(ctxt, ptxt, ctxt_res); }
+  void multiply(Ciphertext &ctxt1, Ciphertext &ctxt2, Ciphertext &ctxt_res) { impl.multiply(ctxt1, ctxt2, ctxt_res); }
+  void multiply(Ciphertext &ctxt, Plaintext &ptxt, Ciphertext &ctxt_res) { impl.multiply(ctxt, ptxt, ctxt_res); }
+  void square(Ciphertext &ctxt, Ciphertext &ctxt_res) { impl.square(ctxt, ctxt_res); }
+  void rotate(Ciphertext &ctxt, int steps, Ciphertext &ctxt_res) { impl.rotate(ctxt, steps, ctxt_res); }
+
+private:
+  typename Backend::backend_type impl; /** The backend, owned by value. */
+};
+
+#endif /* FHE_TYPED_H */
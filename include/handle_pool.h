@@ -0,0 +1,102 @@
+/**
+ * @file handle_pool.h
+ * ------------------------------------------------------------------
+ * @brief Pool of released plaintexts and ciphertexts, recycled by
+ *        a backend for the results it returns through the C API.
+ * ------------------------------------------------------------------
+ * @author Jeffrey Murray Jr (jeffmur)
+ */
+
+#ifndef HANDLE_POOL_H
+#define HANDLE_POOL_H
+
+#include <memory> /* unique_ptr */
+#include <mutex>  /* mutex */
+#include <vector> /* vector */
+
+using namespace std;
+
+/**
+ * @brief Holds released objects of one type, up to a capacity.
+ *
+ * Recycled objects keep their data buffers, so results of the same shape
+ * are written without reallocating. Objects past the capacity are deleted.
+ * All methods are thread-safe.
+ *
+ * @tparam T The pooled type, default constructible.
+ */
+template <typename T>
+class HandlePool {
+private:
+  vector<unique_ptr<T>> idle; /** Released objects, most recent last. */
+  size_t capacity;            /** Maximum number of idle objects. */
+  mutex lock;
+
+public:
+  /**
+   * @brief Creates an empty pool.
+   * @param capacity The maximum number of idle objects.
+  */
+  explicit HandlePool(size_t capacity = 64) : capacity(capacity) {}
+
+  HandlePool(const HandlePool&) = delete;
+  HandlePool& operator=(const HandlePool&) = delete;
+
+  /**
+   * @brief Returns an idle object, or a new one when the pool is empty.
+   * @return An object owned by the caller.
+  */
+  T* acquire()
+  {
+    {
+      lock_guard<mutex> guard(lock);
+      if (!idle.empty())
+      {
+        T* obj = idle.back().release();
+        idle.pop_back();
+        return obj;
+      }
+    }
+    return new T();
+  }
+
+  /**
+   * @brief Takes back an object, deleted when the pool is full.
+  */
+  void release(T* obj)
+  {
+    // Declared first, so a deleted object is freed after unlocking
+    unique_ptr<T> owned(obj);
+    lock_guard<mutex> guard(lock);
+    if (idle.size() < capacity)
+    {
+      idle.push_back(move(owned));
+    }
+  }
+
+  /**
+   * @brief Sets the maximum number of idle objects, deleting any past it.
+  */
+  void set_capacity(size_t max_idle)
+  {
+    vector<unique_ptr<T>> dropped;
+    lock_guard<mutex> guard(lock);
+    capacity = max_idle;
+    while (idle.size() > capacity)
+    {
+      dropped.push_back(move(idle.back()));
+      idle.pop_back();
+    }
+  }
+
+  /**
+   * @brief Returns the number of idle objects.
+  */
+  size_t size()
+  {
+    lock_guard<mutex> guard(lock);
+    return idle.size();
+  }
+};
+
+#endif /* HANDLE_POOL_H */
@@ -0,0 +1,185 @@
+/**
+ * @file key_cache.h
+ * ------------------------------------------------------------------
+ * @brief Least recently used cache of deserialized keys, shared by
+ *        the backends of a multi-tenant evaluation server.
+ * ------------------------------------------------------------------
+ * @author Jeffrey Murray Jr (jeffmur)
+ */
+
+#ifndef KEY_CACHE_H
+#define KEY_CACHE_H
+
+#include <cstdint>       /* uint64_t */
+#include <functional>    /* function */
+#include <list>          /* list */
+#include <memory>        /* shared_ptr */
+#include <mutex>         /* mutex */
+#include <string>        /* string */
+#include <unordered_map> /* unordered_map */
+#include <vector>        /* vector */
+#include "afhe.h"        /* Abstraction */
+
+using namespace std;
+
+/**
+ * @brief Creates an empty key of a given type, for the backend loading it.
+ */
+using KeyFactory = function<AKey*(key type)>;
+
+/**
+ * @brief Caches deserialized keys, identified by a hash of their serialization, the cache id.
+ *
+ * The cache id differs from AKey::fingerprint(), which hashes the key material:
+ * the serialization is hashed before deserializing, to skip deserializing on a hit.
+ * Both the cache id and a second hash, checked on every hit, are seeded with secrets
+ * of the cache, so a tenant cannot compute serializations colliding with another's key.
+ *
+ * Keys are held in memory up to a budget, measured by their serialized size.
+ * Past the budget, the least recently used keys are evicted; when a spill
+ * directory is set, evicted keys are written there and later loaded back from
+ * a memory-mapped file, instead of being sent again by the tenant.
+ *
+ * Cached keys are shared with each backend they are attached to, without copying,
+ * and stay valid for that backend after eviction. A cached key must only be attached
+ * to backends with the same encryption parameters as the one that loaded it.
+ * All methods are thread-safe.
+ */
+class KeyCache {
+private:
+  struct Entry {
+    key type;               /** Type of the key. */
+    size_t bytes;           /** Serialized size, counted against the budget. */
+    uint64_t check;         /** Second hash of the serialization, verified on a hit. */
+    shared_ptr<AKey> value; /** Deserialized key, null when spilled. */
+    string spill_path;      /** File holding the spilled key, if any. */
+    list<uint64_t>::iterator lru; /** Position in the LRU list, when in memory. */
+    bool spilling = false;  /** Being written to disk, outside the lock. */
+  };
+
+  struct Victim {
+    uint64_t id;            /** Cache id of the evicted key. */
+    shared_ptr<AKey> value; /** Key written to disk. */
+    string path;            /** File written, empty when the write failed. */
+  };
+
+  uint64_t id_seed;            /** Secret seed of the cache ids. */
+  uint64_t check_seed;         /** Secret seed of the hashes verified on a hit. */
+  size_t budget;               /** Memory budget, in bytes. */
+  size_t used = 0;             /** Bytes held in memory. */
+  string spill_dir;            /** Directory for spilled keys, empty to drop them. */
+  list<uint64_t> lru;          /** Keys in memory, most recently used first. */
+  unordered_map<uint64_t, Entry> entries;
+  mutex lock;
+
+  /**
+   * @brief Marks an entry in memory as most recently used. Requires the lock.
+  */
+  void touch(Entry &entry, uint64_t id);
+
+  /**
+   * @brief Holds a key in memory. Requires the lock.
+  */
+  void insert(uint64_t id, key type, size_t bytes, uint64_t check, shared_ptr<AKey> value);
+
+  /**
+   * @brief Checks that a cached entry holds the given serialization. Requires the lock.
+   * @throws invalid_argument If the serialization collides with a different cached key.
+  */
+  static void verify(const Entry &entry, key type, size_t bytes, uint64_t check);
+
+  /**
+   * @brief Holds a spilled key in memory again. Requires the lock.
+  */
+  void restore(Entry &entry, uint64_t id, shared_ptr<AKey> value);
+
+  /**
+   * @brief Evicts least recently used keys until within budget. Takes the lock.
+   *
+   * Keys past the budget are serialized and written to the spill directory
+   * without the lock, then dropped from memory once on disk.
+   * The most recently used key is kept, even when larger than the budget.
+  */
+  void evict();
+
+  /**
+   * @brief Keys past the budget, not yet on disk, marked as spilling. Requires the lock.
+  */
+  vector<Victim> spill_candidates();
+
+  /**
+   * @brief Drops keys from memory until within budget. Requires the lock.
+   *
+   * Keys without a spilled file are removed from the cache.
+  */
+  void drop_past_budget();
+
+  /**
+   * @brief Writes a key to a spill file, only readable by the owner.
+   * @return The path of the file, empty when the key could not be written.
+  */
+  string write_spill(uint64_t id, AKey &value);
+
+  /**
+   * @brief Deserializes a key.
+   * @throws invalid_argument If the factory cannot create a key of this type.
+  */
+  static shared_ptr<AKey> deserialize(Afhe* fhe, key type, const byte* data, size_t size,
+                                      bool trusted, const KeyFactory &make_key);
+
+public:
+  /**
+   * @brief Creates an empty cache.
+   * @param budget_bytes The memory budget, in bytes of serialized keys.
+   * @param spill_dir Directory where evicted keys are written; when empty, they are dropped.
+   * @throws invalid_argument If spilling is not supported on this platform.
+  */
+  KeyCache(size_t budget_bytes, string spill_dir = "");
+
+  /**
+   * @brief Removes any spilled files.
+  */
+  ~KeyCache();
+
+  KeyCache(const KeyCache&) = delete;
+  KeyCache& operator=(const KeyCache&) = delete;
+
+  /**
+   * @brief Returns the cached key for a serialization, deserializing it only on a miss.
+   *
+   * @param fhe The backend validating the key, on a miss.
+   * @param type The type of the key, a public, relinearization or galois key.
+   * @param data The serialized key.
+   * @param size The number of bytes in the buffer.
+   * @param trusted If true, skips validating the key on a miss, see AKey::load_inplace.
+   * @param make_key Creates an empty key for the backend, on a miss.
+   * @param id Receives the cache id of the key, a seeded hash of its serialization.
+   * @return The key, shared with the cache.
+   * @throws invalid_argument If the key is a secret key, or collides with a different cached key.
+  */
+  shared_ptr<AKey> load(Afhe* fhe, key type, const byte* data, size_t size, bool trusted,
+                        const KeyFactory &make_key, uint64_t &id);
+
+  /**
+   * @brief Returns a cached key by cache id, loading spilled keys back into memory.
+   *
+   * @param fhe The backend loading a spilled key.
+   * @param id The cache id returned by load().
+   * @param make_key Creates an empty key for the backend, for a spilled key.
+   * @param type Receives the type of the key.
+   * @return The key, or null when it is not cached.
+  */
+  shared_ptr<AKey> find(Afhe* fhe, uint64_t id, const KeyFactory &make_key, key &type);
+
+  /**
+   * @brief Returns the number of bytes held in memory.
+  */
+  size_t memory_size();
+
+  /**
+   * @brief Returns the number of cached keys, in memory or spilled.
+  */
+  size_t count();
+};
+
+#endif /* KEY_CACHE_H */
@@ -0,0 +1,139 @@
+/**
+ * @file packing.h
+ * ------------------------------------------------------------------
+ * @brief Batch packing layer, places many small records into the
+ *        SIMD slots of a single plaintext at fixed slot offsets.
+ * ------------------------------------------------------------------
+ * @author Jeffrey Murray Jr (jeffmur)
+ */
+
+#ifndef PACKING_H
+#define PACKING_H
+
+#include <cstdint> /* uint64_t */
+#include <vector>  /* vector */
+#include "afhe.h"  /* Abstraction */
+
+using namespace std;
+
+/**
+ * @brief Packs fixed-size records into the slots of a plaintext.
+ *
+ * Each record occupies `stride` consecutive slots, starting at the slot offset
+ * `record * stride`. The stride is the record size rounded up to a power of two,
+ * so records never straddle a rotation boundary (e.g. the rows of a BFV batch).
+ * Unused slots are zero, and element-wise ciphertext operations between two
+ * packed ciphertexts act independently on every record.
+ */
+class Packing {
+private:
+  Afhe* fhe;          /** Backend used to encode and evaluate. */
+  size_t rsize;       /** Number of values in each record. */
+  size_t rstride;     /** Slots reserved for each record. */
+  size_t slots;       /** Number of slots in a plaintext. */
+
+  /**
+   * @brief Validate the number of records against the layout.
+  */
+  void check_count(size_t count);
+
+  /**
+   * @brief Scatter contiguous records into a vector of slots.
+  */
+  template <typename T>
+  vector<T> scatter(const T* records, size_t count);
+
+  /**
+   * @brief Gather records from a vector of slots into contiguous memory.
+  */
+  template <typename T>
+  void gather(const vector<T> &slot_data, T* records, size_t count);
+
+public:
+  /**
+   * @brief Creates a packing layout for the context of an initialized backend.
+   * @param fhe The backend library, with encoders initialized.
+   * @param record_size The number of values in each record.
+   * @throws invalid_argument If the record does not fit in a single plaintext.
+  */
+  Packing(Afhe* fhe, size_t record_size);
+
+  /**
+   * @brief Returns the number of values in each record.
+  */
+  size_t record_size() const { return rsize; }
+
+  /**
+   * @brief Returns the number of slots reserved for each record.
+  */
+  size_t stride() const { return rstride; }
+
+  /**
+   * @brief Returns the maximum number of records packed in one plaintext.
+  */
+  size_t capacity() const { return slots / rstride; }
+
+  /**
+   * @brief Returns the first slot of a record.
+  */
+  size_t offset(size_t record) const { return record * rstride; }
+
+  /**
+   * @brief Encodes contiguous integer records into a plaintext.
+   *        Used by BGV and BFV schemes.
+   *
+   * @param records The records, laid out as `count * record_size()` values.
+   * @param count The number of records, at most capacity().
+   * @param ptxt The plaintext where the packed records will be stored.
+  */
+  void encode_int(const uint64_t* records, size_t count, APlaintext &ptxt);
+
+  /**
+   * @brief Decodes integer records from a packed plaintext.
+   *        Used by BGV and BFV schemes.
+   *
+   * @param ptxt The packed plaintext.
+   * @param records The destination, holding `count * record_size()` values.
+   * @param count The number of records to be unpacked.
+  */
+  void decode_int(APlaintext &ptxt, uint64_t* records, size_t count);
+
+  /**
+   * @brief Encodes contiguous floating point records into a plaintext.
+   *        Used by CKKS scheme.
+  */
+  void encode_double(const double* records, size_t count, APlaintext &ptxt);
+
+  /**
+   * @brief Decodes floating point records from a packed plaintext.
+   *        Used by CKKS scheme.
+  */
+  void decode_double(APlaintext &ptxt, double* records, size_t count);
+
+  /**
+   * @brief Encodes a single record into every record position.
+   *
+   * Adding or multiplying a packed ciphertext by the result applies the same
+   * operand to every record.
+  */
+  void encode_replicated_int(const uint64_t* record, APlaintext &ptxt);
+
+  /**
+   * @brief Encodes a single floating point record into every record position.
+  */
+  void encode_replicated_double(const double* record, APlaintext &ptxt);
+
+  /**
+   * @brief Encodes a mask selecting one record, zero in all other slots.
+   *
+   * Multiplying a packed ciphertext by the mask isolates a single record;
+   * for CKKS, the mask must be switched to the level of the ciphertext,
+   * and the product rescaled.
+   *
+   * @param record The index of the record to keep.
+   * @param ptxt The plaintext where the mask will be stored.
+  */
+  void encode_mask(size_t record, APlaintext &ptxt);
+};
+
+#endif /* PACKING_H */
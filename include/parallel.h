@@ -0,0 +1,110 @@
+/**
+ * @file parallel.h
+ * ------------------------------------------------------------------
+ * @brief Parallel loop over independent tasks, used to spread
+ *        ciphertext operations over a persistent thread pool.
+ * ------------------------------------------------------------------
+ * @author Jeffrey Murray Jr (jeffmur)
+ */
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <atomic>             /* atomic */
+#include <condition_variable> /* condition_variable */
+#include <deque>              /* deque */
+#include <exception>          /* exception_ptr */
+#include <functional>         /* function */
+#include <memory>             /* shared_ptr */
+#include <mutex>              /* mutex */
+#include <thread>             /* thread */
+#include <vector>             /* vector */
+
+using namespace std;
+
+/**
+ * @brief Process-wide pool of worker threads, shared by every backend.
+ *
+ * Started on first use with one worker less than the hardware threads, since
+ * each caller takes part in its own loop. Concurrent loops, e.g. from many
+ * isolates, share the same workers instead of each spawning their own threads.
+ */
+class ThreadPool {
+private:
+  /**
+   * @brief A loop submitted to the pool, claimed one task at a time.
+  */
+  struct Job {
+    const function<void(size_t)>* body; /** Task, owned by the caller. */
+    size_t count;                       /** Number of tasks. */
+    atomic<size_t> next{0};             /** Next task to claim. */
+    atomic<size_t> done{0};             /** Number of finished tasks. */
+    exception_ptr error;                /** First exception thrown by a task. */
+    mutex lock;
+    condition_variable finished;
+
+    /**
+     * @brief Runs tasks until none are left to claim.
+    */
+    void work();
+  };
+
+  deque<shared_ptr<Job>> jobs;  /** Loops with tasks left to claim. */
+  vector<thread> workers;
+  mutex lock;
+  condition_variable wake;
+
+  explicit ThreadPool(size_t size);
+
+  /**
+   * @brief Runs tasks of submitted loops, for the lifetime of the process.
+  */
+  void worker();
+
+public:
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /**
+   * @brief Returns the pool of the process, started on first use.
+  */
+  static ThreadPool& instance();
+
+  /**
+   * @brief Returns the number of worker threads.
+  */
+  size_t size() const { return workers.size(); }
+
+  /**
+   * @brief Runs body(i) for every i in [0, count), on the calling thread and the workers.
+   *
+   * Returns once every task finished; rethrows the first exception thrown by a task.
+   * Tasks may run loops themselves, the caller of a loop can always finish it alone.
+  */
+  void run(size_t count, const function<void(size_t)> &body);
+};
+
+/**
+ * @brief Runs body(i) for every i in [0, count), spread over the thread pool.
+ *
+ * Tasks must be independent of each other. The calling thread takes part in the
+ * work, and the first exception thrown by a task is rethrown once all tasks finish.
+ *
+ * @param count The number of tasks.
+ * @param body The task, called with its index.
+ */
+template <typename F>
+void parallel_for(size_t count, F &&body)
+{
+  if (count <= 1 || ThreadPool::instance().size() == 0)
+  {
+    for (size_t i = 0; i < count; i++)
+    {
+      body(i);
+    }
+    return;
+  }
+  ThreadPool::instance().run(count, function<void(size_t)>(ref(body)));
+}
+
+#endif /* PARALLEL_H */
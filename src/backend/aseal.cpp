@@ -11,21 +11,56 @@
 
 #include "aseal.h"
 #include "afhe.h"
+#include "parallel.h"
 
 using namespace std;
 using namespace seal;
 
 Aseal::~Aseal(){};
 
+ACiphertext* Aseal::acquire_ciphertext()
+{
+  return ciphertext_pool->acquire();
+}
+
+APlaintext* Aseal::acquire_plaintext()
+{
+  return plaintext_pool->acquire();
+}
+
+void Aseal::release(ACiphertext* ctxt)
+{
+  AsealCiphertext &c = _to_ciphertext(*ctxt);
+
+  // The data buffer is kept for the next result
+  c.noise_bits = numeric_limits<double>::quiet_NaN();
+  ciphertext_pool->release(&c);
+}
+
+void Aseal::release(APlaintext* ptxt)
+{
+  AsealPlaintext &p = _to_plaintext(*ptxt);
+
+  // Cleared in place, the data buffer is kept for the next result
+  p.set_zero();
+  plaintext_pool->release(&p);
+}
+
+void Aseal::set_pool_capacity(size_t capacity)
+{
+  ciphertext_pool->set_capacity(capacity);
+  plaintext_pool->set_capacity(capacity);
+}
+
 string Aseal::ContextGen(scheme scheme,
                          uint64_t poly_modulus_degree,
                          uint64_t plain_modulus_bit_size,
                          uint64_t plain_modulus,
                          int sec_level,
-                         vector<int> bit_sizes)
+                         const vector<int> &bit_sizes)
 { try {
   // Initialize parameters with scheme
-  this->params = make_shared<EncryptionParameters>(scheme_map_to_seal.at(scheme));
+  this->params = make_shared<EncryptionParameters>(scheme_to_seal(scheme));
 
   /*
    * BGV encodes plaintext with “least significant bits”
@@ -36,8 +71,20 @@ string Aseal::ContextGen(scheme scheme,
     // Set polynomial modulus degree
     this->params->set_poly_modulus_degree(poly_modulus_degree);
 
-    // Set coefficient modulus
-    this->params->set_coeff_modulus(CoeffModulus::BFVDefault(poly_modulus_degree));
+    /**
+     * Set coefficient modulus; a caller-provided chain of prime bit sizes
+     * allows shallow circuits to avoid paying for unused primes.
+     * Otherwise, fallback to the default chain for the security level.
+    */
+    if (bit_sizes.size() > 0)
+    {
+      validate_coeff_modulus(poly_modulus_degree, bit_sizes, sec_level);
+      this->params->set_coeff_modulus(CoeffModulus::Create(poly_modulus_degree, bit_sizes));
+    }
+    else
+    {
+      this->params->set_coeff_modulus(CoeffModulus::BFVDefault(poly_modulus_degree));
+    }
 
     /**
      * When plain_modulus_bit_size is set, batching is enabled, plain_modulus is not used
@@ -75,7 +122,9 @@ string Aseal::ContextGen(scheme scheme,
   }
 
   // Validate parameters by putting them inside a SEALContext
-  this->context = make_shared<SEALContext>(*this->params, true, sec_map[sec_level]);
+  set_random_generator();
+  this->context = make_shared<SEALContext>(*this->params, true, sec_level_to_seal(sec_level));
+  set_evaluator();
 
   // Initialize Encoder object
   if(this->context->parameters_set() && plain_modulus_bit_size > 0)
@@ -94,18 +143,48 @@ string Aseal::ContextGen(scheme scheme,
   }
 }
 
-string Aseal::ContextGen(string parms)
+void Aseal::validate_coeff_modulus(uint64_t poly_modulus_degree,
+                                   const vector<int> &bit_sizes,
+                                   int sec_level)
+{
+  int total_bit_count = 0;
+  for (int bit_size : bit_sizes)
+  {
+    if (bit_size <= 0)
+    {
+      throw invalid_argument("coeff_modulus bit sizes must be positive");
+    }
+    total_bit_count += bit_size;
+  }
+
+  // Insecure chains are rejected before any primes are generated
+  int max_bit_count = CoeffModulus::MaxBitCount(poly_modulus_degree, sec_level_to_seal(sec_level));
+  if (total_bit_count > max_bit_count)
+  {
+    throw invalid_argument("coeff_modulus bit count (" + to_string(total_bit_count) +
+                           ") exceeds the maximum (" + to_string(max_bit_count) +
+                           ") for the security level");
+  }
+}
+
+string Aseal::ContextGen(string_view parms)
+{
+  // Read in place, without copying into a stream
+  return ContextGen(reinterpret_cast<const byte*>(parms.data()), static_cast<int>(parms.size()));
+}
+
+string Aseal::ContextGen(const byte *parms, int size)
 {
   // Initialize parameters with scheme
   this->params = make_shared<EncryptionParameters>();
 
-  // Load parameters from string
-  istringstream ss(parms);
-
-  this->params->load(ss);
+  // Load parameters from memory
+  this->params->load(parms, size);
 
   // Validate parameters by putting them inside a SEALContext
+  set_random_generator();
   this->context = make_shared<SEALContext>(*this->params, true);
+  set_evaluator();
 
   // Initialize Encoder object
   if(this->context->parameters_set())
@@ -120,6 +199,24 @@ string Aseal::ContextGen(string parms)
                 this->context->parameter_error_message();
 }
 
+scheme Aseal::get_scheme()
+{
+  // Gather current context, resolves object
+  auto &seal_context = *_this_context();
+
+  switch (seal_context.key_context_data()->parms().scheme())
+  {
+  case scheme_type::bfv:
+    return scheme::bfv;
+  case scheme_type::ckks:
+    return scheme::ckks;
+  case scheme_type::bgv:
+    return scheme::bgv;
+  default:
+    return scheme::no_scheme;
+  }
+}
+
 void Aseal::set_encoders(bool ignore_exception)
 {
   // Gather current context and scheme.
@@ -152,16 +249,55 @@ void Aseal::set_encoders(bool ignore_exception)
   }
 }
 
-void Aseal::save_parameters_inplace(byte *out, int size, string compr_mode)
+void Aseal::set_prng(prng type)
+{
+  if (type != prng::default_prng && type != prng::blake2xb && type != prng::shake256)
+  {
+    throw invalid_argument("Unsupported PRNG");
+  }
+  this->prng_choice = type;
+}
+
+void Aseal::set_random_generator()
+{
+  switch (this->prng_choice)
+  {
+  case prng::blake2xb:
+    this->params->set_random_generator(make_shared<Blake2xbPRNGFactory>());
+    break;
+  case prng::shake256:
+    this->params->set_random_generator(make_shared<Shake256PRNGFactory>());
+    break;
+  default:
+    // SEALContext falls back to the default factory
+    break;
+  }
+}
+
+void Aseal::set_evaluator()
+{
+  if (this->context->parameters_set())
+  {
+    this->evaluator = make_shared<Evaluator>(*this->context);
+  }
+  else
+  {
+    this->evaluator = nullptr;
+  }
+}
+
+void Aseal::save_parameters_inplace(byte *out, int size, compr_mode compression_mode)
 {
   // Initialize params
   this->params = make_shared<EncryptionParameters>();
 
   // Write to memory
-  this->params->save(out, size, compression_mode_map.at(compr_mode));
+  this->params->save(out, size, compr_mode_to_seal(compression_mode));
 
   // Validate parameters by putting them inside a SEALContext
+  set_random_generator();
   this->context = make_shared<SEALContext>(*this->params, true);
+  set_evaluator();
 }
 
 void Aseal::load_parameters_inplace(const byte *in, int size)
@@ -173,31 +309,23 @@ void Aseal::load_parameters_inplace(const byte *in, int size)
   this->params->load(in, size);
 
   // Validate parameters by putting them inside a SEALContext
+  set_random_generator();
   this->context = make_shared<SEALContext>(*this->params, true);
+  set_evaluator();
 }
 
-string Aseal::save_parameters(string compr_mode)
+string Aseal::save_parameters(compr_mode compression_mode)
 {
-  // Share as a binary string
-  ostringstream ss;
-
   if (this->params == nullptr)
   {
     throw logic_error("Parameters are not set, cannot save them.");
   }
 
-  // Save parameters to stringstream
-  int size = save_parameters_size(compr_mode);
-  this->params->save(ss, compression_mode_map.at(compr_mode));
-
-  // cout << endl << "save_parameters: " << ss.str() << endl;
-  // cout << "save_parameters_size: " << size << " vs str length: " << ss.str().length() << endl;
-  // cout << "compression_mode: " << compr_mode << endl;
-
-  return ss.str();
+  // Share as a binary string, written in place
+  return save_to_string(*this->params, compr_mode_to_seal(compression_mode));
 }
 
-int Aseal::save_parameters_size(string compr_mode)
+int Aseal::save_parameters_size(compr_mode compression_mode)
 {
   if (this->params == nullptr)
   {
@@ -205,13 +333,14 @@ int Aseal::save_parameters_size(string compr_mode)
   }
 
   // Save parameters to stringstream
-  return this->params->save_size(compression_mode_map.at(compr_mode));
+  return this->params->save_size(compr_mode_to_seal(compression_mode));
 }
 
 void Aseal::disable_mod_switch()
 {
   // Update existing context with same parameters
   this->context = make_shared<SEALContext>(*this->params, false);
+  set_evaluator();
 }
 
 void Aseal::set_encoder_scale(double scale)
@@ -236,19 +365,20 @@ void Aseal::KeyGen()
   // Assign Secret Key
   this->secretKey = make_shared<SecretKey>(keyGenObj->secret_key());
 
-  // Refresh Encryptor, Evaluator, and Decryptor objects
+  // Refresh Encryptor and Decryptor objects
   this->encryptor = make_shared<Encryptor>(seal_context, *this->publicKey);
+  this->decryptor = make_shared<Decryptor>(seal_context, *this->secretKey);
 }
 
-void Aseal::KeyGen(string secret_key)
+void Aseal::KeyGen(const string &secret_key)
 {
   // Gather current context, resolves object
   auto &seal_context = *_this_context();
 
   this->secretKey = make_shared<SecretKey>();
 
-  istringstream ss(secret_key);
-  this->secretKey->load(seal_context, ss);
+  // Read in place, without copying into a stream
+  this->secretKey->load(seal_context, reinterpret_cast<const byte*>(secret_key.data()), secret_key.size());
 
   // Initialize KeyGen object
   this->keyGenObj = make_shared<KeyGenerator>(seal_context);
@@ -259,8 +389,9 @@ void Aseal::KeyGen(string secret_key)
   // Derive Key Pair
   keyGenObj->create_public_key(*this->publicKey);
 
-  // Refresh Encryptor, Evaluator, and Decryptor objects
+  // Refresh Encryptor and Decryptor objects
   this->encryptor = make_shared<Encryptor>(seal_context, *this->publicKey);
+  this->decryptor = make_shared<Decryptor>(seal_context, *this->secretKey);
 }
 
 AKey& Aseal::get_public_key()
@@ -296,76 +427,293 @@ AKey& Aseal::get_relin_keys(){
   return _from_relin_keys(*relinKeys);
 }
 
-void Aseal::relinearize(ACiphertext &ctxt)
+void Aseal::GaloisKeyGen(const vector<int> &steps)
 {
   // Gather current context, resolves object
   auto &seal_context = *_this_context();
 
-  // Initialize Evaluator object
-  this->evaluator = make_shared<Evaluator>(seal_context);
+  // Initialize KeyGen object
+  if (this->keyGenObj == nullptr)
+  {
+    throw logic_error("KeyGen() must be called before GaloisKeyGen()");
+  }
 
-  // Relinearize using casted types
-  this->evaluator->relinearize_inplace(_to_ciphertext(ctxt), *this->relinKeys);
+  // Generate Galois Keys, for every power of two when no steps are given
+  this->galoisKeys = make_shared<GaloisKeys>();
+  if (steps.empty())
+  {
+    keyGenObj->create_galois_keys(*galoisKeys);
+  }
+  else
+  {
+    keyGenObj->create_galois_keys(steps, *galoisKeys);
+  }
 }
 
-void Aseal::mod_switch_to(APlaintext &ptxt, ACiphertext &ctxt)
+AKey& Aseal::get_galois_keys(){
+  if (this->galoisKeys == nullptr)
+  {
+    throw logic_error("GaloisKeyGen() must be called before get_galois_keys()");
+  }
+  AsealGaloisKey* galoisKeys = new AsealGaloisKey(*this->galoisKeys);
+  return _from_galois_keys(*galoisKeys);
+}
+
+void Aseal::set_public_key(AKey &key)
 {
   // Gather current context, resolves object
   auto &seal_context = *_this_context();
 
-  // Initialize Evaluator object
-  this->evaluator = make_shared<Evaluator>(seal_context);
+  // Move the key data, without copying
+  this->publicKey = make_shared<PublicKey>(move(static_cast<PublicKey &>(_to_public_key(key))));
+  key.reset_fingerprint();
 
-  // Mod Switch using from Ciphertext parms_id
-  this->evaluator->mod_switch_to_inplace(_to_plaintext(ptxt), _to_ciphertext(ctxt).parms_id());
+  // Refresh Encryptor object
+  this->encryptor = make_shared<Encryptor>(seal_context, *this->publicKey);
 }
 
-void Aseal::mod_switch_to(ACiphertext &to, ACiphertext &from)
+void Aseal::set_secret_key(AKey &key)
 {
   // Gather current context, resolves object
   auto &seal_context = *_this_context();
 
-  // Initialize Evaluator object
-  this->evaluator = make_shared<Evaluator>(seal_context);
+  // Move the key data, without copying
+  this->secretKey = make_shared<SecretKey>(move(static_cast<SecretKey &>(_to_secret_key(key))));
+  key.reset_fingerprint();
 
-  // Mod Switch using from Ciphertext parms_id
-  this->evaluator->mod_switch_to_inplace(_to_ciphertext(to),  _to_ciphertext(from).parms_id());
+  // Evaluation keys are derived from the installed secret key
+  this->keyGenObj = make_shared<KeyGenerator>(seal_context, *this->secretKey);
+
+  // Refresh Decryptor object
+  this->decryptor = make_shared<Decryptor>(seal_context, *this->secretKey);
 }
 
-void Aseal::mod_switch_to_next(ACiphertext &ctxt)
+void Aseal::set_relin_keys(AKey &key)
+{
+  // Keys are only valid within a context
+  _this_context();
+
+  // Move the key data, without copying
+  this->relinKeys = make_shared<RelinKeys>(move(static_cast<RelinKeys &>(_to_relin_keys(key))));
+  key.reset_fingerprint();
+}
+
+void Aseal::set_galois_keys(AKey &key)
+{
+  // Keys are only valid within a context
+  _this_context();
+
+  // Move the key data, without copying
+  this->galoisKeys = make_shared<GaloisKeys>(move(static_cast<GaloisKeys &>(_to_galois_keys(key))));
+  key.reset_fingerprint();
+}
+
+void Aseal::share_key(key type, shared_ptr<AKey> k)
 {
   // Gather current context, resolves object
   auto &seal_context = *_this_context();
 
-  // Initialize Evaluator object
-  this->evaluator = make_shared<Evaluator>(seal_context);
+  // Aliases the shared key, the backend holds a reference
+  switch (type)
+  {
+  case key::public_key:
+    if (auto pk = dynamic_pointer_cast<AsealPublicKey>(k))
+    {
+      this->publicKey = pk;
+      this->encryptor = make_shared<Encryptor>(seal_context, *this->publicKey);
+      return;
+    }
+    break;
+  case key::secret_key:
+    if (auto sk = dynamic_pointer_cast<AsealSecretKey>(k))
+    {
+      this->secretKey = sk;
+      this->keyGenObj = make_shared<KeyGenerator>(seal_context, *this->secretKey);
+      this->decryptor = make_shared<Decryptor>(seal_context, *this->secretKey);
+      return;
+    }
+    break;
+  case key::relin_keys:
+    if (auto rk = dynamic_pointer_cast<AsealRelinKey>(k))
+    {
+      this->relinKeys = rk;
+      return;
+    }
+    break;
+  case key::galois_keys:
+    if (auto gk = dynamic_pointer_cast<AsealGaloisKey>(k))
+    {
+      this->galoisKeys = gk;
+      return;
+    }
+    break;
+  default:
+    break;
+  }
+  throw invalid_argument("Key does not match the key type");
+}
+
+void Aseal::relinearize(ACiphertext &ctxt)
+{
+  // Relinearize using casted types
+  relinearize(_to_ciphertext(ctxt));
+}
+
+void Aseal::relinearize(AsealCiphertext &ctxt)
+{
+  ctxt.noise_bits = noise_key_switch(noise_of(ctxt), ctxt.parms_id());
+  _this_evaluator().relinearize_inplace(ctxt, *this->relinKeys);
+}
+
+void Aseal::mod_switch_to(APlaintext &ptxt, ACiphertext &ctxt)
+{
+  // Mod Switch using from Ciphertext parms_id
+  _this_evaluator().mod_switch_to_inplace(_to_plaintext(ptxt), _to_ciphertext(ctxt).parms_id());
+}
+
+void Aseal::mod_switch_to(ACiphertext &to, ACiphertext &from)
+{
+  // Mod Switch using from Ciphertext parms_id
+  AsealCiphertext &c = _to_ciphertext(to);
+  const parms_id_type parms_id = _to_ciphertext(from).parms_id();
+  if (c.parms_id() != parms_id)
+  {
+    c.noise_bits = noise_mod_switch(noise_of(c), parms_id);
+  }
+  _this_evaluator().mod_switch_to_inplace(c, parms_id);
+}
 
+void Aseal::mod_switch_to_next(ACiphertext &ctxt)
+{
   // Mod Switch using casted types
-  this->evaluator->mod_switch_to_next_inplace(_to_ciphertext(ctxt));
+  mod_switch_to_next(_to_ciphertext(ctxt));
+}
+
+void Aseal::mod_switch_to_next(AsealCiphertext &ctxt)
+{
+  double noise = noise_of(ctxt);
+  _this_evaluator().mod_switch_to_next_inplace(ctxt);
+  ctxt.noise_bits = noise_mod_switch(noise, ctxt.parms_id());
 }
 
 void Aseal::mod_switch_to_next(APlaintext &ptxt)
 {
-  // Gather current context, resolves object
+  // Mod Switch using casted types
+  _this_evaluator().mod_switch_to_next_inplace(_to_plaintext(ptxt));
+}
+
+void Aseal::rescale_to_next(ACiphertext &ctxt)
+{
+  // Rescale using casted types
+  rescale_to_next(_to_ciphertext(ctxt));
+}
+
+void Aseal::rescale_to_next(AsealCiphertext &ctxt)
+{
+  double noise = noise_of(ctxt), scale = ctxt.scale();
+  _this_evaluator().rescale_to_next_inplace(ctxt);
+  ctxt.noise_bits = noise_rescale(noise, log2(scale / ctxt.scale()));
+}
+
+int Aseal::compact_for_transfer(ACiphertext &ctxt, int min_budget)
+{
+  AsealCiphertext &c = _to_ciphertext(ctxt);
+  auto context_data = context_data_of(c.parms_id());
+
+  // Walk down the chain while the next level keeps the budget
+  const bool is_ckks = get_scheme() == scheme::ckks;
+  double noise = noise_of(c);
+  if (!is_ckks && isnan(noise))
+  {
+    throw invalid_argument("Noise of the ciphertext is unknown, e.g. after load; "
+                           "switch it down with mod_switch_to_level instead");
+  }
+  parms_id_type target = c.parms_id();
+  int levels = 0;
+  for (auto next = context_data->next_context_data(); next != nullptr; next = next->next_context_data())
+  {
+    double next_noise = noise_mod_switch(noise, next->parms_id());
+    double budget = is_ckks ? log2_modulus(next->parms_id()) - log2(c.scale()) - 1.0 : -next_noise - 1.0;
+    if (budget < min_budget)
+    {
+      break;
+    }
+    noise = next_noise;
+    target = next->parms_id();
+    levels++;
+  }
+
+  if (levels > 0)
+  {
+    _this_evaluator().mod_switch_to_inplace(c, target);
+    c.noise_bits = noise;
+  }
+  return levels;
+}
+
+int Aseal::chain_index(ACiphertext &ctxt)
+{
+  return static_cast<int>(context_data_of(_to_ciphertext(ctxt).parms_id())->chain_index());
+}
+
+int Aseal::level(ACiphertext &ctxt)
+{
+  return level(_to_ciphertext(ctxt));
+}
+
+int Aseal::level(AsealCiphertext &ctxt)
+{
+  // Counted from the first level of data, where fresh ciphertexts are
   auto &seal_context = *_this_context();
+  return static_cast<int>(seal_context.first_context_data()->chain_index()) -
+         static_cast<int>(context_data_of(ctxt.parms_id())->chain_index());
+}
 
-  // Initialize Evaluator object
-  this->evaluator = make_shared<Evaluator>(seal_context);
+int Aseal::coeff_modulus_count(ACiphertext &ctxt)
+{
+  return static_cast<int>(context_data_of(_to_ciphertext(ctxt).parms_id())->parms().coeff_modulus().size());
+}
 
-  // Mod Switch using casted types
-  this->evaluator->mod_switch_to_next_inplace(_to_plaintext(ptxt));
+void Aseal::mod_switch_to_level(ACiphertext &ctxt, int level)
+{
+  int current = this->level(ctxt);
+  if (level < current)
+  {
+    throw invalid_argument("Cannot switch a ciphertext at level " + to_string(current) +
+                           " up to level " + to_string(level));
+  }
+  if (level - current > chain_index(ctxt))
+  {
+    throw invalid_argument("Level " + to_string(level) + " is past the end of the modulus chain");
+  }
+
+  // One level at a time, for the noise estimate
+  for (int i = current; i < level; i++)
+  {
+    mod_switch_to_next(ctxt);
+  }
 }
 
-void Aseal::rescale_to_next(ACiphertext &ctxt)
+vector<level_cost> Aseal::level_costs()
 {
   // Gather current context, resolves object
   auto &seal_context = *_this_context();
 
-  // Initialize Evaluator object
-  this->evaluator = make_shared<Evaluator>(seal_context);
-
-  // Rescale using casted types
-  this->evaluator->rescale_to_next_inplace(_to_ciphertext(ctxt));
+  // Products are linear in the number of primes, key switching is quadratic
+  auto top = seal_context.first_context_data();
+  double k0 = static_cast<double>(top->parms().coeff_modulus().size());
+  vector<level_cost> costs;
+  for (auto data = top; data != nullptr; data = data->next_context_data())
+  {
+    double k = static_cast<double>(data->parms().coeff_modulus().size());
+    costs.push_back({
+      static_cast<int>(k),
+      log2_modulus(data->parms_id()),
+      k / k0,
+      (k * (k + 1.0)) / (k0 * (k0 + 1.0)),
+    });
+  }
+  return costs;
 }
 
 // string Aseal::get_secret_key()
@@ -380,189 +728,667 @@ void Aseal::rescale_to_next(ACiphertext &ctxt)
 
 void Aseal::encrypt(APlaintext &ptxt, ACiphertext &ctxt)
 {
-  // Gather current context, resolves object
-  auto &seal_context = *_this_context();
-
-  // Initialize Encryptor object
-  this->encryptor = make_shared<Encryptor>(seal_context, *this->publicKey);
-
   // Encrypt using casted types
-  this->encryptor->encrypt(_to_plaintext(ptxt), _to_ciphertext(ctxt));
+  encrypt(_to_plaintext(ptxt), _to_ciphertext(ctxt));
 }
 
-void Aseal::decrypt(ACiphertext &ctxt, APlaintext &ptxt)
+void Aseal::encrypt(AsealPlaintext &ptxt, AsealCiphertext &ctxt)
 {
-  // Gather current context, resolves object
-  auto &seal_context = *_this_context();
+  _this_encryptor().encrypt(ptxt, ctxt);
+  ctxt.noise_bits = noise_floor(ctxt.parms_id());
+}
 
-  // Initialize Decryptor object
-  this->decryptor = make_shared<Decryptor>(seal_context, *this->secretKey);
+void Aseal::encrypt_many(APlaintext** ptxts, size_t count, ACiphertext** ctxts)
+{
+  Encryptor &encryptor = _this_encryptor();
+
+  // Encryptions are independent, each draws its own randomness
+  parallel_for(count, [&](size_t i) {
+    AsealCiphertext &c = _to_ciphertext(*ctxts[i]);
+    encryptor.encrypt(_to_plaintext(*ptxts[i]), c);
+    c.noise_bits = noise_floor(c.parms_id());
+  });
+}
 
+void Aseal::decrypt(ACiphertext &ctxt, APlaintext &ptxt)
+{
   // Decrypt using casted types
-  this->decryptor->decrypt(_to_ciphertext(ctxt), _to_plaintext(ptxt));
+  decrypt(_to_ciphertext(ctxt), _to_plaintext(ptxt));
 }
 
-int Aseal::invariant_noise_budget(ACiphertext &ctxt)
+void Aseal::decrypt(AsealCiphertext &ctxt, AsealPlaintext &ptxt)
 {
-  // Gather current context, resolves object
-  auto &seal_context = *_this_context();
+  _this_decryptor().decrypt(ctxt, ptxt);
+}
 
-  // Initialize Decryptor object
-  this->decryptor = make_shared<Decryptor>(seal_context, *this->secretKey);
+int Aseal::invariant_noise_budget(ACiphertext &ctxt)
+{
+  return _this_decryptor().invariant_noise_budget(_to_ciphertext(ctxt));
+}
 
-  return this->decryptor->invariant_noise_budget(_to_ciphertext(ctxt));
+double Aseal::log2_sum(double a, double b)
+{
+  // An unknown bound stays unknown, max and min would drop it
+  if (isnan(a) || isnan(b))
+  {
+    return numeric_limits<double>::quiet_NaN();
+  }
+  double hi = max(a, b), lo = min(a, b);
+  return hi + log2(1.0 + exp2(lo - hi));
 }
 
-int Aseal::slot_count()
+shared_ptr<const SEALContext::ContextData> Aseal::context_data_of(const parms_id_type &parms_id)
 {
-  // Gather current context, resolves object
   auto &seal_context = *_this_context();
-
-  if (this->bEncoder != nullptr) {
-    return this->bEncoder->slot_count();
+  auto context_data = seal_context.get_context_data(parms_id);
+  if (context_data == nullptr)
+  {
+    throw invalid_argument("Ciphertext is not valid for the encryption parameters");
   }
-  else if (this->cEncoder != nullptr) {
-    return this->cEncoder->slot_count();
+  return context_data;
+}
+
+double Aseal::log2_modulus(const parms_id_type &parms_id)
+{
+  auto context_data = context_data_of(parms_id);
+
+  double log2_q = 0.0;
+  for (const auto &prime : context_data->parms().coeff_modulus())
+  {
+    log2_q += log2(static_cast<double>(prime.value()));
   }
-  throw logic_error("Encoder is not initialized");
+  return log2_q;
 }
 
-void Aseal::encode_int(vector<uint64_t> &data, APlaintext &ptxt)
+double Aseal::noise_floor(const parms_id_type &parms_id)
 {
-  // Gather current context, resolves object
   auto &seal_context = *_this_context();
+  const EncryptionParameters &parms = seal_context.first_context_data()->parms();
 
-  // Initialize Encoder object
-  // this->bEncoder = make_shared<BatchEncoder>(seal_context);
+  // Six standard deviations of the error over the 2n + 1 terms of a fresh encryption,
+  // and one bit for the rounding of bit counts
+  double n = static_cast<double>(parms.poly_modulus_degree());
+  double bound = log2(6.0 * 3.2 * sqrt(2.0 * n + 1.0)) + 1.0;
+  if (parms.scheme() == scheme_type::ckks)
+  {
+    return bound;
+  }
 
-  // Encode using casted types
-  this->bEncoder->encode(data, _to_plaintext(ptxt));
+  // Invariant noise is relative to q / t
+  return bound + log2(static_cast<double>(parms.plain_modulus().value())) - log2_modulus(parms_id);
 }
 
-void Aseal::decode_int(APlaintext &ptxt, vector<uint64_t> &data)
+double Aseal::noise_of(AsealCiphertext &ctxt)
+{
+  return ctxt.noise_bits;
+}
+
+double Aseal::noise_multiply(const parms_id_type &parms_id, double noise_a, double scale_a, double noise_b, double scale_b)
 {
-  // Gather current context, resolves object
   auto &seal_context = *_this_context();
+  const EncryptionParameters &parms = seal_context.first_context_data()->parms();
+  if (parms.scheme() == scheme_type::ckks)
+  {
+    // Each error is scaled by the other message, plus the product of errors
+    return log2_sum(noise_a + log2(scale_b), noise_b + log2(scale_a)) + 1.0;
+  }
 
-  // Initialize Encoder object
-  // this->bEncoder = make_shared<BatchEncoder>(seal_context);
+  double log2_n = log2(static_cast<double>(parms.poly_modulus_degree()));
+  double log2_t = log2(static_cast<double>(parms.plain_modulus().value()));
+  if (parms.scheme() == scheme_type::bgv)
+  {
+    // Errors multiply, t * e1 * e2 over n terms
+    return noise_a + noise_b + log2_n + log2_modulus(parms_id) - log2_t + 2.0;
+  }
 
-  // Decode using casted types
-  this->bEncoder->decode(_to_plaintext(ptxt), data);
+  // Grows by t * n over the sum of invariant noises
+  return log2_t + log2_n + 1.0 + log2_sum(noise_a, noise_b);
 }
 
-void Aseal::encode_double(vector<double> &data, APlaintext &ptxt)
+double Aseal::noise_multiply_plain(double noise, double plain_scale)
 {
-  // Gather current context, resolves object
   auto &seal_context = *_this_context();
+  const EncryptionParameters &parms = seal_context.first_context_data()->parms();
+  if (parms.scheme() == scheme_type::ckks)
+  {
+    return noise + log2(plain_scale) + 1.0;
+  }
 
-  // Encode using casted types
-  this->cEncoder->encode(data, this->cEncoderScale, _to_plaintext(ptxt));
+  // Grows by n coefficients of at most t / 2
+  double log2_n = log2(static_cast<double>(parms.poly_modulus_degree()));
+  double log2_t = log2(static_cast<double>(parms.plain_modulus().value()));
+  return noise + log2_n + log2_t - 1.0;
 }
 
-void Aseal::encode_double(double data, APlaintext &ptxt)
+double Aseal::noise_key_switch(double noise, const parms_id_type &parms_id)
 {
-  // Gather current context, resolves object
-  auto &seal_context = *_this_context();
-
-  // Encode using casted types
-  this->cEncoder->encode(data, this->cEncoderScale, _to_plaintext(ptxt));
+  // The special prime divides the key switching error down to about a fresh encryption
+  return log2_sum(noise, noise_floor(parms_id));
 }
 
-void Aseal::decode_double(APlaintext &ptxt, vector<double> &data)
+double Aseal::noise_mod_switch(double noise, const parms_id_type &parms_id)
+{
+  auto &seal_context = *_this_context();
+  if (get_scheme() == scheme::ckks)
+  {
+    // Dropping primes keeps the scale and the error
+    return noise;
+  }
+
+  // Rounding to the smaller modulus adds about n * t / q'
+  const EncryptionParameters &parms = seal_context.first_context_data()->parms();
+  double log2_n = log2(static_cast<double>(parms.poly_modulus_degree()));
+  double log2_t = log2(static_cast<double>(parms.plain_modulus().value()));
+  return log2_sum(noise, log2_t + log2_n + 1.0 - log2_modulus(parms_id));
+}
+
+double Aseal::noise_rescale(double noise, double log2_prime)
+{
+  auto &seal_context = *_this_context();
+  const EncryptionParameters &parms = seal_context.first_context_data()->parms();
+  double log2_n = log2(static_cast<double>(parms.poly_modulus_degree()));
+
+  // The error shrinks with the scale, plus the rounding of the division
+  return log2_sum(noise - log2_prime, log2_n / 2.0 + 2.0);
+}
+
+int Aseal::estimate_noise_budget(ACiphertext &ctxt)
+{
+  AsealCiphertext &c = _to_ciphertext(ctxt);
+  double noise = noise_of(c);
+  if (isnan(noise))
+  {
+    // Not tracked since encryption, e.g. after load
+    return -1;
+  }
+  double budget = get_scheme() == scheme::ckks ? log2(c.scale()) - noise : -noise - 1.0;
+  return max(0, static_cast<int>(floor(budget)));
+}
+
+AsealPlaintext& Aseal::scratch_plaintext()
+{
+  // One buffer per thread, its allocation is reused across calls
+  thread_local AsealPlaintext scratch;
+
+  // Leave NTT form, a CKKS plaintext cannot be resized by the other encoders
+  scratch.parms_id() = parms_id_zero;
+  return scratch;
+}
+
+void Aseal::encrypt_int(const uint64_t* data, size_t len, ACiphertext &ctxt)
+{
+  ACiphertext* ctxts[] = {&ctxt};
+  encrypt_int_batch(data, len, 1, ctxts);
+}
+
+void Aseal::encrypt_double(const double* data, size_t len, ACiphertext &ctxt)
+{
+  ACiphertext* ctxts[] = {&ctxt};
+  encrypt_double_batch(data, len, 1, ctxts);
+}
+
+size_t Aseal::decrypt_int(ACiphertext &ctxt, uint64_t* data, size_t cap)
+{
+  ACiphertext* ctxts[] = {&ctxt};
+  return decrypt_int_batch(ctxts, 1, data, cap);
+}
+
+size_t Aseal::decrypt_double(ACiphertext &ctxt, double* data, size_t cap)
+{
+  ACiphertext* ctxts[] = {&ctxt};
+  return decrypt_double_batch(ctxts, 1, data, cap);
+}
+
+void Aseal::encrypt_int_batch(const uint64_t* data, size_t len, size_t count, ACiphertext** ctxts)
+{
+  Encryptor &encryptor = _this_encryptor();
+
+  // Rows are independent, each thread encodes into its own scratch plaintext
+  parallel_for(count, [&](size_t i) {
+    AsealPlaintext &scratch = scratch_plaintext();
+    encode_int(data + i * len, len, scratch);
+    AsealCiphertext &c = _to_ciphertext(*ctxts[i]);
+    encryptor.encrypt(scratch, c);
+    c.noise_bits = noise_floor(c.parms_id());
+  });
+}
+
+void Aseal::encrypt_double_batch(const double* data, size_t len, size_t count, ACiphertext** ctxts)
+{
+  Encryptor &encryptor = _this_encryptor();
+
+  // Rows are independent, each thread encodes into its own scratch plaintext
+  parallel_for(count, [&](size_t i) {
+    AsealPlaintext &scratch = scratch_plaintext();
+    encode_double(data + i * len, len, scratch);
+    AsealCiphertext &c = _to_ciphertext(*ctxts[i]);
+    encryptor.encrypt(scratch, c);
+    c.noise_bits = noise_floor(c.parms_id());
+  });
+}
+
+size_t Aseal::decrypt_int_batch(ACiphertext** ctxts, size_t count, uint64_t* data, size_t cap)
+{
+  Decryptor &decryptor = _this_decryptor();
+
+  AsealPlaintext &scratch = scratch_plaintext();
+  size_t written = 0;
+  for (size_t i = 0; i < count; i++)
+  {
+    decryptor.decrypt(_to_ciphertext(*ctxts[i]), scratch);
+    written = decode_int(scratch, data + i * cap, cap);
+  }
+  return written;
+}
+
+size_t Aseal::decrypt_double_batch(ACiphertext** ctxts, size_t count, double* data, size_t cap)
+{
+  Decryptor &decryptor = _this_decryptor();
+
+  AsealPlaintext &scratch = scratch_plaintext();
+  size_t written = 0;
+  for (size_t i = 0; i < count; i++)
+  {
+    decryptor.decrypt(_to_ciphertext(*ctxts[i]), scratch);
+    written = decode_double(scratch, data + i * cap, cap);
+  }
+  return written;
+}
+
+int Aseal::slot_count()
+{
+  // Gather current context, resolves object
+  auto &seal_context = *_this_context();
+
+  if (this->bEncoder != nullptr) {
+    return this->bEncoder->slot_count();
+  }
+  else if (this->cEncoder != nullptr) {
+    return this->cEncoder->slot_count();
+  }
+  throw logic_error("Encoder is not initialized");
+}
+
+void Aseal::encode_int(const vector<uint64_t> &data, APlaintext &ptxt)
 {
   // Gather current context, resolves object
   auto &seal_context = *_this_context();
 
   // Initialize Encoder object
-  // this->cEncoder = make_shared<CKKSEncoder>(seal_context);
+  // this->bEncoder = make_shared<BatchEncoder>(seal_context);
+
+  // Encode using casted types
+  this->bEncoder->encode(data, _to_plaintext(ptxt));
+}
+
+void Aseal::decode_int(APlaintext &ptxt, vector<uint64_t> &data)
+{
+  // Gather current context, resolves object
+  auto &seal_context = *_this_context();
+
+  // Initialize Encoder object
+  // this->bEncoder = make_shared<BatchEncoder>(seal_context);
 
   // Decode using casted types
-  this->cEncoder->decode(_to_plaintext(ptxt), data);
+  this->bEncoder->decode(_to_plaintext(ptxt), data);
 }
 
-void Aseal::add(ACiphertext &ctxt, APlaintext &ptxt, ACiphertext &ctxt_res)
+void Aseal::encode_int(const uint64_t* data, size_t len, APlaintext &ptxt)
+{
+  encode_int(data, len, _to_plaintext(ptxt));
+}
+
+void Aseal::encode_int(const uint64_t* data, size_t len, AsealPlaintext &ptxt)
 {
   // Gather current context, resolves object
   auto &seal_context = *_this_context();
 
-  // Initialize Evaluator object
-  this->evaluator = make_shared<Evaluator>(seal_context);
+#ifdef SEAL_USE_MSGSL
+  // Encode from a view over the caller's memory
+  this->bEncoder->encode(gsl::span<const uint64_t>(data, len), ptxt);
+#else
+  vector<uint64_t> data_vec(data, data + len);
+  this->bEncoder->encode(data_vec, ptxt);
+#endif
+}
 
-  // Add using casted types
-  this->evaluator->add_plain(_to_ciphertext(ctxt), _to_plaintext(ptxt), _to_ciphertext(ctxt_res));
+size_t Aseal::decode_int(APlaintext &ptxt, uint64_t* data, size_t cap)
+{
+  return decode_int(_to_plaintext(ptxt), data, cap);
 }
 
-void Aseal::add(ACiphertext &ctxt1, ACiphertext &ctxt2, ACiphertext &ctxt_res)
+size_t Aseal::decode_int(AsealPlaintext &ptxt, uint64_t* data, size_t cap)
 {
   // Gather current context, resolves object
   auto &seal_context = *_this_context();
 
-  // Initialize Evaluator object
-  this->evaluator = make_shared<Evaluator>(seal_context);
+  size_t slots = this->bEncoder->slot_count();
+#ifdef SEAL_USE_MSGSL
+  // Decode directly into the caller's memory, when all slots fit
+  if (cap >= slots)
+  {
+    this->bEncoder->decode(ptxt, gsl::span<uint64_t>(data, slots));
+    return slots;
+  }
+#endif
+  vector<uint64_t> data_vec;
+  this->bEncoder->decode(ptxt, data_vec);
+  size_t written = min(cap, data_vec.size());
+  copy_n(data_vec.begin(), written, data);
+  return written;
+}
 
-  // Add using casted types
-  this->evaluator->add(_to_ciphertext(ctxt1), _to_ciphertext(ctxt2), _to_ciphertext(ctxt_res));
+void Aseal::encode_double(const vector<double> &data, APlaintext &ptxt)
+{
+  // Gather current context, resolves object
+  auto &seal_context = *_this_context();
+
+  // Encode using casted types
+  this->cEncoder->encode(data, this->cEncoderScale, _to_plaintext(ptxt));
 }
 
-void Aseal::subtract(ACiphertext &ctxt, APlaintext &ptxt, ACiphertext &ctxt_res)
+void Aseal::encode_double(double data, APlaintext &ptxt)
 {
   // Gather current context, resolves object
   auto &seal_context = *_this_context();
 
-  // Initialize Evaluator object
-  this->evaluator = make_shared<Evaluator>(seal_context);
+  // Encode using casted types
+  this->cEncoder->encode(data, this->cEncoderScale, _to_plaintext(ptxt));
+}
 
-  // Subtract using casted types
-  this->evaluator->sub_plain(_to_ciphertext(ctxt), _to_plaintext(ptxt), _to_ciphertext(ctxt_res));
+void Aseal::decode_double(APlaintext &ptxt, vector<double> &data)
+{
+  // Gather current context, resolves object
+  auto &seal_context = *_this_context();
+
+  // Initialize Encoder object
+  // this->cEncoder = make_shared<CKKSEncoder>(seal_context);
+
+  // Decode using casted types
+  this->cEncoder->decode(_to_plaintext(ptxt), data);
 }
 
-void Aseal::subtract(ACiphertext &ctxt1, ACiphertext &ctxt2, ACiphertext &ctxt_res)
+void Aseal::encode_double(const double* data, size_t len, APlaintext &ptxt)
+{
+  encode_double(data, len, _to_plaintext(ptxt));
+}
+
+void Aseal::encode_double(const double* data, size_t len, AsealPlaintext &ptxt)
 {
   // Gather current context, resolves object
   auto &seal_context = *_this_context();
 
-  // Initialize Evaluator object
-  this->evaluator = make_shared<Evaluator>(seal_context);
+#ifdef SEAL_USE_MSGSL
+  // Encode from a view over the caller's memory
+  this->cEncoder->encode(gsl::span<const double>(data, len), this->cEncoderScale, ptxt);
+#else
+  vector<double> data_vec(data, data + len);
+  this->cEncoder->encode(data_vec, this->cEncoderScale, ptxt);
+#endif
+}
 
-  // Subtract using casted types
-  this->evaluator->sub(_to_ciphertext(ctxt1), _to_ciphertext(ctxt2), _to_ciphertext(ctxt_res));
+size_t Aseal::decode_double(APlaintext &ptxt, double* data, size_t cap)
+{
+  return decode_double(_to_plaintext(ptxt), data, cap);
 }
 
-void Aseal::multiply(ACiphertext &ctxt1, ACiphertext &ctxt2, ACiphertext &ctxt_res)
+size_t Aseal::decode_double(AsealPlaintext &ptxt, double* data, size_t cap)
 {
   // Gather current context, resolves object
   auto &seal_context = *_this_context();
 
-  // Initialize Evaluator object
-  this->evaluator = make_shared<Evaluator>(seal_context);
+  size_t slots = this->cEncoder->slot_count();
+#ifdef SEAL_USE_MSGSL
+  // Decode directly into the caller's memory, when all slots fit
+  if (cap >= slots)
+  {
+    this->cEncoder->decode(ptxt, gsl::span<double>(data, slots));
+    return slots;
+  }
+#endif
+  vector<double> data_vec;
+  this->cEncoder->decode(ptxt, data_vec);
+  size_t written = min(cap, data_vec.size());
+  copy_n(data_vec.begin(), written, data);
+  return written;
+}
 
-  // Multiply using casted types
-  this->evaluator->multiply(_to_ciphertext(ctxt1), _to_ciphertext(ctxt2), _to_ciphertext(ctxt_res));
+void Aseal::encode_complex(const vector<complex<double>> &data, APlaintext &ptxt)
+{
+  // Gather current context, resolves object
+  auto &seal_context = *_this_context();
+
+  // Encode using casted types
+  this->cEncoder->encode(data, this->cEncoderScale, _to_plaintext(ptxt));
 }
 
-void Aseal::multiply(ACiphertext &ctxt, APlaintext &ptxt, ACiphertext &ctxt_res)
+void Aseal::encode_complex(const complex<double>* data, size_t len, APlaintext &ptxt)
 {
   // Gather current context, resolves object
   auto &seal_context = *_this_context();
 
-  // Initialize Evaluator object
-  this->evaluator = make_shared<Evaluator>(seal_context);
+#ifdef SEAL_USE_MSGSL
+  // Encode from a view over the caller's memory
+  this->cEncoder->encode(gsl::span<const complex<double>>(data, len), this->cEncoderScale, _to_plaintext(ptxt));
+#else
+  vector<complex<double>> data_vec(data, data + len);
+  this->cEncoder->encode(data_vec, this->cEncoderScale, _to_plaintext(ptxt));
+#endif
+}
 
-  // Multiply using casted types
-  this->evaluator->multiply_plain(_to_ciphertext(ctxt), _to_plaintext(ptxt), _to_ciphertext(ctxt_res));
+void Aseal::decode_complex(APlaintext &ptxt, vector<complex<double>> &data)
+{
+  // Gather current context, resolves object
+  auto &seal_context = *_this_context();
+
+  // Decode using casted types
+  this->cEncoder->decode(_to_plaintext(ptxt), data);
 }
 
-void Aseal::square(ACiphertext &ctxt, ACiphertext &ctxt_res)
+size_t Aseal::decode_complex(APlaintext &ptxt, complex<double>* data, size_t cap)
 {
   // Gather current context, resolves object
   auto &seal_context = *_this_context();
 
-  // Initialize Evaluator object
-  this->evaluator = make_shared<Evaluator>(seal_context);
+  size_t slots = this->cEncoder->slot_count();
+#ifdef SEAL_USE_MSGSL
+  // Decode directly into the caller's memory, when all slots fit
+  if (cap >= slots)
+  {
+    this->cEncoder->decode(_to_plaintext(ptxt), gsl::span<complex<double>>(data, slots));
+    return slots;
+  }
+#endif
+  vector<complex<double>> data_vec;
+  this->cEncoder->decode(_to_plaintext(ptxt), data_vec);
+  size_t written = min(cap, data_vec.size());
+  copy_n(data_vec.begin(), written, data);
+  return written;
+}
+
+void Aseal::add(ACiphertext &ctxt, APlaintext &ptxt, ACiphertext &ctxt_res)
+{
+  // Add using casted types
+  add(_to_ciphertext(ctxt), _to_plaintext(ptxt), _to_ciphertext(ctxt_res));
+}
+
+void Aseal::add(AsealCiphertext &ctxt, AsealPlaintext &ptxt, AsealCiphertext &ctxt_res)
+{
+  double noise = noise_of(ctxt);
+  _this_evaluator().add_plain(ctxt, ptxt, ctxt_res);
+  ctxt_res.noise_bits = noise;
+}
+
+void Aseal::add(ACiphertext &ctxt1, ACiphertext &ctxt2, ACiphertext &ctxt_res)
+{
+  // Add using casted types
+  add(_to_ciphertext(ctxt1), _to_ciphertext(ctxt2), _to_ciphertext(ctxt_res));
+}
+
+void Aseal::add(AsealCiphertext &ctxt1, AsealCiphertext &ctxt2, AsealCiphertext &ctxt_res)
+{
+  double noise = log2_sum(noise_of(ctxt1), noise_of(ctxt2));
+  _this_evaluator().add(ctxt1, ctxt2, ctxt_res);
+  ctxt_res.noise_bits = noise;
+}
+
+void Aseal::add_many(ACiphertext** ctxts, size_t count, ACiphertext &ctxt_res)
+{
+  if (count == 0)
+  {
+    throw invalid_argument("add_many requires at least one ciphertext");
+  }
+
+  // Accumulate in place, the result is written last since it may alias an input
+  Ciphertext sum = _to_ciphertext(*ctxts[0]);
+  double noise = noise_of(_to_ciphertext(*ctxts[0]));
+  for (size_t i = 1; i < count; i++)
+  {
+    _this_evaluator().add_inplace(sum, _to_ciphertext(*ctxts[i]));
+    noise = log2_sum(noise, noise_of(_to_ciphertext(*ctxts[i])));
+  }
+  AsealCiphertext &res = _to_ciphertext(ctxt_res);
+  static_cast<Ciphertext &>(res) = move(sum);
+  res.noise_bits = noise;
+}
+
+void Aseal::subtract(ACiphertext &ctxt, APlaintext &ptxt, ACiphertext &ctxt_res)
+{
+  // Subtract using casted types
+  subtract(_to_ciphertext(ctxt), _to_plaintext(ptxt), _to_ciphertext(ctxt_res));
+}
+
+void Aseal::subtract(AsealCiphertext &ctxt, AsealPlaintext &ptxt, AsealCiphertext &ctxt_res)
+{
+  double noise = noise_of(ctxt);
+  _this_evaluator().sub_plain(ctxt, ptxt, ctxt_res);
+  ctxt_res.noise_bits = noise;
+}
+
+void Aseal::subtract(ACiphertext &ctxt1, ACiphertext &ctxt2, ACiphertext &ctxt_res)
+{
+  // Subtract using casted types
+  subtract(_to_ciphertext(ctxt1), _to_ciphertext(ctxt2), _to_ciphertext(ctxt_res));
+}
+
+void Aseal::subtract(AsealCiphertext &ctxt1, AsealCiphertext &ctxt2, AsealCiphertext &ctxt_res)
+{
+  double noise = log2_sum(noise_of(ctxt1), noise_of(ctxt2));
+  _this_evaluator().sub(ctxt1, ctxt2, ctxt_res);
+  ctxt_res.noise_bits = noise;
+}
+
+void Aseal::multiply(ACiphertext &ctxt1, ACiphertext &ctxt2, ACiphertext &ctxt_res)
+{
+  // Multiply using casted types
+  multiply(_to_ciphertext(ctxt1), _to_ciphertext(ctxt2), _to_ciphertext(ctxt_res));
+}
+
+void Aseal::multiply(AsealCiphertext &ctxt1, AsealCiphertext &ctxt2, AsealCiphertext &ctxt_res)
+{
+  double noise = noise_multiply(ctxt1.parms_id(), noise_of(ctxt1), ctxt1.scale(), noise_of(ctxt2), ctxt2.scale());
+  _this_evaluator().multiply(ctxt1, ctxt2, ctxt_res);
+  ctxt_res.noise_bits = noise;
+}
+
+void Aseal::multiply_many(ACiphertext** ctxts, size_t count, ACiphertext &ctxt_res)
+{
+  if (count == 0)
+  {
+    throw invalid_argument("multiply_many requires at least one ciphertext");
+  }
+  if (this->relinKeys == nullptr)
+  {
+    throw logic_error("RelinKeys must be set to perform multiply_many");
+  }
+
+  Evaluator &evaluator = _this_evaluator();
+  const bool is_ckks = get_scheme() == scheme::ckks;
+
+  // The first layer reads the inputs, later layers the previous products
+  vector<const Ciphertext*> operands(count);
+  vector<double> noise(count);
+  for (size_t i = 0; i < count; i++)
+  {
+    operands[i] = &_to_ciphertext(*ctxts[i]);
+    noise[i] = noise_of(_to_ciphertext(*ctxts[i]));
+  }
+
+  // Balanced tree: pairs of a layer are independent, an odd operand moves up a layer
+  vector<Ciphertext> layer;
+  while (operands.size() > 1)
+  {
+    const size_t pairs = operands.size() / 2;
+    vector<Ciphertext> next(pairs + operands.size() % 2);
+    vector<double> next_noise(next.size());
+    parallel_for(pairs, [&](size_t t) {
+      const Ciphertext &a = *operands[2 * t], &b = *operands[2 * t + 1];
+      double product = noise_multiply(a.parms_id(), noise[2 * t], a.scale(), noise[2 * t + 1], b.scale());
+      if (is_ckks)
+      {
+        ckks_multiply(evaluator, a, b, next[t]);
+        product = noise_key_switch(product, next[t].parms_id());
+        next_noise[t] = noise_rescale(product, log2(a.scale() * b.scale() / next[t].scale()));
+      }
+      else
+      {
+        evaluator.multiply(a, b, next[t]);
+        evaluator.relinearize_inplace(next[t], *this->relinKeys);
+        next_noise[t] = noise_key_switch(product, next[t].parms_id());
+      }
+    });
+    if (operands.size() % 2 == 1)
+    {
+      next[pairs] = *operands.back();
+      next_noise[pairs] = noise.back();
+    }
+    noise = move(next_noise);
 
+    layer = move(next);
+    operands.resize(layer.size());
+    for (size_t i = 0; i < layer.size(); i++)
+    {
+      operands[i] = &layer[i];
+    }
+  }
+
+  // The result is written last since it may alias an input
+  AsealCiphertext &res = _to_ciphertext(ctxt_res);
+  if (layer.empty())
+  {
+    static_cast<Ciphertext &>(res) = *operands[0];
+  }
+  else
+  {
+    static_cast<Ciphertext &>(res) = move(layer[0]);
+  }
+  res.noise_bits = noise[0];
+}
+
+void Aseal::multiply(ACiphertext &ctxt, APlaintext &ptxt, ACiphertext &ctxt_res)
+{
+  // Multiply using casted types
+  multiply(_to_ciphertext(ctxt), _to_plaintext(ptxt), _to_ciphertext(ctxt_res));
+}
+
+void Aseal::multiply(AsealCiphertext &ctxt, AsealPlaintext &ptxt, AsealCiphertext &ctxt_res)
+{
+  double noise = noise_multiply_plain(noise_of(ctxt), ptxt.scale());
+  _this_evaluator().multiply_plain(ctxt, ptxt, ctxt_res);
+  ctxt_res.noise_bits = noise;
+}
+
+void Aseal::square(ACiphertext &ctxt, ACiphertext &ctxt_res)
+{
   // Square using casted types
-  this->evaluator->square(_to_ciphertext(ctxt), _to_ciphertext(ctxt_res));
+  square(_to_ciphertext(ctxt), _to_ciphertext(ctxt_res));
+}
+
+void Aseal::square(AsealCiphertext &ctxt, AsealCiphertext &ctxt_res)
+{
+  double noise = noise_multiply(ctxt.parms_id(), noise_of(ctxt), ctxt.scale(), noise_of(ctxt), ctxt.scale());
+  _this_evaluator().square(ctxt, ctxt_res);
+  ctxt_res.noise_bits = noise;
 }
 
 void Aseal::power(ACiphertext &ctxt, int power, ACiphertext &ctxt_res)
@@ -576,12 +1402,585 @@ void Aseal::power(ACiphertext &ctxt, int power, ACiphertext &ctxt_res)
     throw logic_error("RelinKeys must be set to perform power operation");
   }
 
+  // Relinearized products in a tree of depth ceil(log2(power))
+  AsealCiphertext &c = _to_ciphertext(ctxt);
+  double noise = noise_of(c);
+  for (int k = 1; k < power; k <<= 1)
+  {
+    noise = noise_key_switch(noise_multiply(c.parms_id(), noise, 1.0, noise, 1.0), c.parms_id());
+  }
+
+  // Power using casted types
+  _this_evaluator().exponentiate(c, power, *this->relinKeys, _to_ciphertext(ctxt_res));
+  _to_ciphertext(ctxt_res).noise_bits = noise;
+}
+
+void Aseal::ckks_multiply(Evaluator &evaluator, const Ciphertext &a, const Ciphertext &b, Ciphertext &res)
+{
+  auto &seal_context = *_this_context();
+  size_t a_level = seal_context.get_context_data(a.parms_id())->chain_index();
+  size_t b_level = seal_context.get_context_data(b.parms_id())->chain_index();
+
+  // Operands must share a level, the higher one is switched down
+  if (&a == &b)
+  {
+    evaluator.square(a, res);
+  }
+  else if (a_level > b_level)
+  {
+    evaluator.mod_switch_to(a, b.parms_id(), res);
+    evaluator.multiply_inplace(res, b);
+  }
+  else if (b_level > a_level)
+  {
+    Ciphertext b_low;
+    evaluator.mod_switch_to(b, a.parms_id(), b_low);
+    evaluator.multiply(a, b_low, res);
+  }
+  else
+  {
+    evaluator.multiply(a, b, res);
+  }
+  evaluator.relinearize_inplace(res, *this->relinKeys);
+  evaluator.rescale_to_next_inplace(res);
+}
+
+void Aseal::ckks_multiply_const(Evaluator &evaluator, const Ciphertext &a, double c, Ciphertext &res)
+{
+  auto &seal_context = *_this_context();
+
+  // Encoded at the scale of the prime dropped by the rescale, which keeps the input scale
+  auto context_data = seal_context.get_context_data(a.parms_id());
+  double prime = static_cast<double>(context_data->parms().coeff_modulus().back().value());
+  Plaintext ptxt;
+  this->cEncoder->encode(c, a.parms_id(), prime, ptxt);
+
+  evaluator.multiply_plain(a, ptxt, res);
+  evaluator.rescale_to_next_inplace(res);
+  res.scale() = a.scale();
+}
+
+void Aseal::ckks_add(Evaluator &evaluator, Ciphertext &acc, const Ciphertext &b)
+{
+  auto &seal_context = *_this_context();
+  size_t acc_level = seal_context.get_context_data(acc.parms_id())->chain_index();
+  size_t b_level = seal_context.get_context_data(b.parms_id())->chain_index();
+
+  if (acc_level > b_level)
+  {
+    evaluator.mod_switch_to_inplace(acc, b.parms_id());
+  }
+  if (b_level > acc_level || acc.scale() != b.scale())
+  {
+    // Scales drift apart by the ratio of the rescaling primes, close enough to be aligned
+    Ciphertext b_aligned;
+    evaluator.mod_switch_to(b, acc.parms_id(), b_aligned);
+    b_aligned.scale() = acc.scale();
+    evaluator.add_inplace(acc, b_aligned);
+  }
+  else
+  {
+    evaluator.add_inplace(acc, b);
+  }
+}
+
+void Aseal::ckks_add_const(Evaluator &evaluator, Ciphertext &acc, double c)
+{
+  Plaintext ptxt;
+  this->cEncoder->encode(c, acc.parms_id(), acc.scale(), ptxt);
+  evaluator.add_plain_inplace(acc, ptxt);
+}
+
+/**
+ * @brief Partial sum of a polynomial, a constant until a ciphertext term is added.
+*/
+struct PolyTerm
+{
+  bool is_const = true;
+  double c = 0.0;
+  Ciphertext ct;
+};
+
+void Aseal::eval_polynomial(ACiphertext &ctxt, const double* coeffs, size_t count, ACiphertext &ctxt_res)
+{
+  if (get_scheme() != scheme::ckks)
+  {
+    throw invalid_argument("eval_polynomial requires the CKKS scheme");
+  }
+  if (this->relinKeys == nullptr)
+  {
+    throw logic_error("RelinKeys must be set to perform eval_polynomial");
+  }
+
   // Gather current context, resolves object
   auto &seal_context = *_this_context();
 
-  // Initialize Evaluator object
-  this->evaluator = make_shared<Evaluator>(seal_context);
+  // Coefficients are encoded at the scale of a prime, smaller ones round to a zero
+  // plaintext, which multiply_plain rejects; they are dropped, below the rescale error
+  double min_prime = numeric_limits<double>::infinity();
+  for (const auto &prime : seal_context.first_context_data()->parms().coeff_modulus())
+  {
+    min_prime = min(min_prime, static_cast<double>(prime.value()));
+  }
+  vector<double> kept(coeffs, coeffs + count);
+  for (size_t i = 1; i < count; i++)
+  {
+    if (fabs(kept[i]) * min_prime < 0.5)
+    {
+      kept[i] = 0.0;
+    }
+  }
+  coeffs = kept.data();
 
-  // Power using casted types
-  this->evaluator->exponentiate(_to_ciphertext(ctxt), power, *this->relinKeys, _to_ciphertext(ctxt_res));
+  // Trailing zero coefficients do not contribute to the degree
+  while (count > 0 && coeffs[count - 1] == 0.0)
+  {
+    count--;
+  }
+  if (count < 2)
+  {
+    throw invalid_argument("Polynomial must have a degree of at least one");
+  }
+  const size_t degree = count - 1;
+
+  Evaluator &evaluator = _this_evaluator();
+
+  // Baby steps k ~ sqrt(degree + 1), and m blocks of k coefficients, both powers of two
+  size_t k = 1;
+  while (k * k < count)
+  {
+    k <<= 1;
+  }
+  size_t m = 1;
+  while (m * k < count)
+  {
+    m <<= 1;
+  }
+
+  // Baby steps: x^1 .. x^k, each at the minimal depth ceil(log2(i))
+  // Powers in (half, 2 * half] only depend on powers up to half
+  const size_t top = m > 1 ? k : k - 1;
+  vector<Ciphertext> powers(top + 1);
+  powers[1] = _to_ciphertext(ctxt);
+  const double noise_in = noise_of(_to_ciphertext(ctxt));
+  for (size_t half = 1; half < top; half <<= 1)
+  {
+    parallel_for(min(2 * half, top) - half, [&](size_t t) {
+      size_t i = half + 1 + t;
+      ckks_multiply(evaluator, powers[half], powers[i - half], powers[i]);
+    });
+  }
+
+  // Every block is a linear combination of the baby steps, without ciphertext products
+  vector<PolyTerm> terms(m);
+  parallel_for(m, [&](size_t b) {
+    PolyTerm &q = terms[b];
+    const size_t base = b * k;
+    for (size_t i = 1; i < k && base + i <= degree; i++)
+    {
+      if (coeffs[base + i] == 0.0)
+      {
+        continue;
+      }
+      Ciphertext term;
+      ckks_multiply_const(evaluator, powers[i], coeffs[base + i], term);
+      if (q.is_const)
+      {
+        q.ct = move(term);
+        q.is_const = false;
+      }
+      else
+      {
+        ckks_add(evaluator, q.ct, term);
+      }
+    }
+
+    double c0 = base <= degree ? coeffs[base] : 0.0;
+    if (q.is_const)
+    {
+      q.c = c0;
+    }
+    else if (c0 != 0.0)
+    {
+      ckks_add_const(evaluator, q.ct, c0);
+    }
+  });
+
+  // Giant steps: pairs of blocks are joined by x^(k * 2^j), halving the number of terms
+  Ciphertext giant;
+  for (size_t span = 1; span < m; span <<= 1)
+  {
+    if (span == 1)
+    {
+      giant = powers[k];
+    }
+    else
+    {
+      ckks_multiply(evaluator, giant, giant, giant);
+    }
+
+    parallel_for(m / (2 * span), [&](size_t t) {
+      PolyTerm &low = terms[2 * t * span];
+      PolyTerm &high = terms[(2 * t + 1) * span];
+
+      Ciphertext product;
+      if (!high.is_const)
+      {
+        ckks_multiply(evaluator, high.ct, giant, product);
+      }
+      else if (high.c != 0.0)
+      {
+        ckks_multiply_const(evaluator, giant, high.c, product);
+      }
+      else
+      {
+        return;
+      }
+
+      if (low.is_const)
+      {
+        if (low.c != 0.0)
+        {
+          ckks_add_const(evaluator, product, low.c);
+        }
+        low.ct = move(product);
+        low.is_const = false;
+      }
+      else
+      {
+        ckks_add(evaluator, low.ct, product);
+      }
+    });
+  }
+
+  // The input error is scaled by at most the slope sum(i * |c_i|) on [-1, 1],
+  // plus the rounding of every rescale and key switch
+  double slope = 1.0;
+  for (size_t i = 1; i < count; i++)
+  {
+    slope += i * fabs(coeffs[i]);
+  }
+  double log2_n = log2(static_cast<double>(seal_context.first_context_data()->parms().poly_modulus_degree()));
+  double noise = log2_sum(noise_in + log2(slope), log2_n / 2.0 + 3.0 + log2(static_cast<double>(count)));
+
+  // The leading coefficient is nonzero, the sum holds a ciphertext term
+  AsealCiphertext &res = _to_ciphertext(ctxt_res);
+  static_cast<Ciphertext &>(res) = move(terms[0].ct);
+  res.noise_bits = noise;
 }
+
+void Aseal::rotate_inplace(Evaluator &evaluator, Ciphertext &ctxt, int steps)
+{
+  if (get_scheme() == scheme::ckks)
+  {
+    evaluator.rotate_vector_inplace(ctxt, steps, *this->galoisKeys);
+  }
+  else
+  {
+    evaluator.rotate_rows_inplace(ctxt, steps, *this->galoisKeys);
+  }
+}
+
+void Aseal::rotate(ACiphertext &ctxt, int steps, ACiphertext &ctxt_res)
+{
+  // Rotate using casted types
+  rotate(_to_ciphertext(ctxt), steps, _to_ciphertext(ctxt_res));
+}
+
+void Aseal::rotate(AsealCiphertext &ctxt, int steps, AsealCiphertext &ctxt_res)
+{
+  if (this->galoisKeys == nullptr)
+  {
+    throw logic_error("GaloisKeys must be set to perform rotation");
+  }
+
+  double noise = noise_key_switch(noise_of(ctxt), ctxt.parms_id());
+  static_cast<Ciphertext &>(ctxt_res) = ctxt;
+  rotate_inplace(_this_evaluator(), ctxt_res, steps);
+  ctxt_res.noise_bits = noise;
+}
+
+void Aseal::rotate_batch(ACiphertext &ctxt, const int* steps, size_t count, ACiphertext** ctxts_res)
+{
+  if (this->galoisKeys == nullptr)
+  {
+    throw logic_error("GaloisKeys must be set to perform rotation");
+  }
+
+  Evaluator &evaluator = _this_evaluator();
+
+  // Results must not alias the input, which is read by every rotation
+  const Ciphertext &x = _to_ciphertext(ctxt);
+  for (size_t i = 0; i < count; i++)
+  {
+    if (ctxts_res[i] == &ctxt)
+    {
+      throw invalid_argument("rotate_batch results must not alias the input");
+    }
+  }
+
+  // Rotations of the same ciphertext are independent
+  const double noise = noise_of(_to_ciphertext(ctxt));
+  const double noise_rotated = noise_key_switch(noise, x.parms_id());
+  parallel_for(count, [&](size_t i) {
+    AsealCiphertext &res = _to_ciphertext(*ctxts_res[i]);
+    static_cast<Ciphertext &>(res) = x;
+    res.noise_bits = noise;
+    if (steps[i] != 0)
+    {
+      rotate_inplace(evaluator, res, steps[i]);
+      res.noise_bits = noise_rotated;
+    }
+  });
+}
+
+size_t Aseal::rotation_row_size()
+{
+  // BGV and BFV rotate each of the two rows of slots independently
+  if (get_scheme() == scheme::ckks)
+  {
+    return slot_count();
+  }
+  return slot_count() / 2;
+}
+
+template <typename T, typename Value, typename Encode>
+void Aseal::encode_diagonals(size_t rows, size_t cols, AsealPlainMatrix &mat, Value value, Encode encode)
+{
+  if (rows == 0 || cols == 0)
+  {
+    throw invalid_argument("Matrix must have at least one row and column");
+  }
+
+  // Pad to a square power of two, which divides the rotation row
+  size_t d = 1;
+  while (d < max(rows, cols))
+  {
+    d <<= 1;
+  }
+  size_t row_size = rotation_row_size();
+  if (d > row_size)
+  {
+    throw invalid_argument("Matrix dimension (" + to_string(d) +
+                           ") exceeds the number of slots in a row (" + to_string(row_size) + ")");
+  }
+
+  // Baby steps ~ sqrt(d), balances baby and giant step rotations
+  size_t g = 1;
+  while (g * g < d)
+  {
+    g <<= 1;
+  }
+
+  mat.n_rows = rows;
+  mat.n_cols = cols;
+  mat.d = d;
+  mat.baby_steps = g;
+  mat.diagonals.assign(d, Plaintext());
+  mat.nonzero.assign(d, false);
+
+  size_t slots = slot_count();
+  vector<T> period(d);
+  vector<T> slot_data(slots);
+  for (size_t k = 0; k < d; k++)
+  {
+    // Diagonal k, rotated right by its giant step: period[u] = M[u - shift][u - shift + k]
+    size_t shift = (k / g) * g;
+    bool nonzero = false;
+    for (size_t u = 0; u < d; u++)
+    {
+      size_t r = (u + d - shift) % d;
+      size_t c = (r + k) % d;
+      period[u] = (r < rows && c < cols) ? value(r, c) : T(0);
+      nonzero = nonzero || period[u] != T(0);
+    }
+    if (!nonzero)
+    {
+      continue;
+    }
+
+    // Replicate across every slot, matching the layout of the input vector
+    for (size_t t = 0; t < slots; t++)
+    {
+      slot_data[t] = period[t % d];
+    }
+    encode(slot_data, mat.diagonals[k]);
+    mat.nonzero[k] = true;
+  }
+}
+
+void Aseal::encode_matrix_int(const uint64_t* data, size_t rows, size_t cols, APlainMatrix &mat)
+{
+  if (get_scheme() == scheme::ckks)
+  {
+    throw invalid_argument("encode_matrix_int requires the BGV or BFV scheme");
+  }
+
+  // Gather current context, resolves object
+  auto &seal_context = *_this_context();
+
+  parms_id_type parms_id = seal_context.first_parms_id();
+  encode_diagonals<uint64_t>(rows, cols, _to_plain_matrix(mat),
+    [&](size_t r, size_t c) { return data[r * cols + c]; },
+    [&](vector<uint64_t> &slots, Plaintext &ptxt) {
+      this->bEncoder->encode(slots, ptxt);
+      // Transformed once here, instead of within every product
+      _this_evaluator().transform_to_ntt_inplace(ptxt, parms_id);
+    });
+}
+
+void Aseal::encode_matrix_double(const double* data, size_t rows, size_t cols, APlainMatrix &mat)
+{
+  if (get_scheme() != scheme::ckks)
+  {
+    throw invalid_argument("encode_matrix_double requires the CKKS scheme");
+  }
+
+  // Gather current context, resolves object
+  auto &seal_context = *_this_context();
+
+  parms_id_type parms_id = seal_context.first_parms_id();
+  encode_diagonals<double>(rows, cols, _to_plain_matrix(mat),
+    [&](size_t r, size_t c) { return data[r * cols + c]; },
+    [&](vector<double> &slots, Plaintext &ptxt) {
+      this->cEncoder->encode(slots, parms_id, this->cEncoderScale, ptxt);
+    });
+}
+
+void Aseal::matvec_plain(APlainMatrix &mat, ACiphertext &ctxt, ACiphertext &ctxt_res)
+{
+  if (this->galoisKeys == nullptr)
+  {
+    throw logic_error("GaloisKeys must be set to perform matvec_plain");
+  }
+
+  AsealPlainMatrix &m = _to_plain_matrix(mat);
+  if (m.d == 0)
+  {
+    throw invalid_argument("Matrix is not encoded");
+  }
+
+  const bool is_ckks = get_scheme() == scheme::ckks;
+  Evaluator &evaluator = _this_evaluator();
+
+  // The result may alias the input, which is only read up front
+  Ciphertext &x = _to_ciphertext(ctxt);
+  const parms_id_type parms_id = x.parms_id();
+
+  // BFV products are accumulated in NTT form, rotations need the coefficient form
+  const bool to_ntt = !x.is_ntt_form();
+
+  // Rotated, multiplied by d diagonals and summed, then rotated again
+  double noise = noise_key_switch(noise_of(_to_ciphertext(ctxt)), parms_id);
+  for (size_t k = 0; k < m.d; k++)
+  {
+    if (m.nonzero[k])
+    {
+      noise = noise_multiply_plain(noise, m.diagonals[k].scale()) + log2(static_cast<double>(m.d));
+      break;
+    }
+  }
+  noise = noise_key_switch(noise, parms_id);
+
+  // Baby steps: rotations of the input, shared by every giant step
+  const size_t g = m.baby_steps, giants = m.giant_steps();
+  vector<Ciphertext> baby(g);
+  parallel_for(min(g, m.d), [&](size_t j) {
+    bool used = false;
+    for (size_t i = 0; i < giants && !used; i++)
+    {
+      size_t k = i * g + j;
+      used = k < m.d && m.nonzero[k];
+    }
+    if (!used)
+    {
+      return;
+    }
+
+    baby[j] = x;
+    if (j > 0)
+    {
+      rotate_inplace(evaluator, baby[j], static_cast<int>(j));
+    }
+    if (to_ntt)
+    {
+      evaluator.transform_to_ntt_inplace(baby[j]);
+    }
+  });
+
+  // Diagonals are encoded at the first level, switched down to the input's level
+  Plaintext level_diag;
+  auto diagonal = [&](size_t k) -> const Plaintext & {
+    if (m.diagonals[k].parms_id() == parms_id)
+    {
+      return m.diagonals[k];
+    }
+    evaluator.mod_switch_to(m.diagonals[k], parms_id, level_diag);
+    return level_diag;
+  };
+
+  // Giant steps: one rotation per partial sum of diagonal products
+  Ciphertext &res = _to_ciphertext(ctxt_res);
+  Ciphertext inner, term;
+  bool has_res = false;
+  for (size_t i = 0; i < giants; i++)
+  {
+    bool has_inner = false;
+    for (size_t j = 0; j < g; j++)
+    {
+      size_t k = i * g + j;
+      if (k >= m.d || !m.nonzero[k])
+      {
+        continue;
+      }
+      if (!has_inner)
+      {
+        evaluator.multiply_plain(baby[j], diagonal(k), inner);
+        has_inner = true;
+      }
+      else
+      {
+        evaluator.multiply_plain(baby[j], diagonal(k), term);
+        evaluator.add_inplace(inner, term);
+      }
+    }
+    if (!has_inner)
+    {
+      continue;
+    }
+
+    if (to_ntt)
+    {
+      evaluator.transform_from_ntt_inplace(inner);
+    }
+    if (i > 0)
+    {
+      rotate_inplace(evaluator, inner, static_cast<int>(i * g));
+    }
+
+    if (!has_res)
+    {
+      res = inner;
+      has_res = true;
+    }
+    else
+    {
+      evaluator.add_inplace(res, inner);
+    }
+  }
+
+  if (!has_res)
+  {
+    throw invalid_argument("Matrix has no non-zero entries");
+  }
+
+  // Rescale the products of two scaled values
+  if (is_ckks)
+  {
+    double scale = res.scale();
+    evaluator.rescale_to_next_inplace(res);
+    noise = noise_rescale(noise, log2(scale / res.scale()));
+  }
+  _to_ciphertext(ctxt_res).noise_bits = noise;
+}
+
@@ -2,7 +2,7 @@
 
 // Important: Must copy string to char* to avoid memory leak
 // Optional ignores null-terminated strings
-const char* to_char(string str, bool ignore_null_terminated=false) {
+const char* to_char(const string &str, bool ignore_null_terminated=false) {
     int size = str.size();
     char *cpy = new char[size+1];
     // Convert string to char array
@@ -13,6 +13,34 @@ const char* to_char(string str, bool ignore_null_terminated=false) {
     return cpy;
 }
 
+// Serializes a ciphertext straight into the returned buffer, without an intermediate string
+const char* save_to_char(ACiphertext* ciphertext) {
+    int size = ciphertext->save_size();
+    char *out = new char[size+1];
+    try {
+        ciphertext->save_inplace(reinterpret_cast<byte*>(out), size);
+    }
+    catch (...) { delete[] out; throw; }
+    return out;
+}
+
+/**
+ * @brief Runs an operation on the concrete backend, after a single check of its tag.
+ *
+ * Backends are final, so the operation is bound at compile time instead of through
+ * the vtable, and its arguments are cast by tag instead of dynamic_cast.
+*/
+template <typename Op>
+inline void on_backend(Afhe* afhe, Op &&op) {
+    switch (afhe->backend_lib) {
+    case backend::seal_backend:
+        op(static_cast<Aseal&>(*afhe));
+        return;
+    default:
+        throw logic_error("No backend set");
+    }
+}
+
 const char* check_for_error() {
     ErrorTranslator& et = ErrorTranslator::getInstance();
     // cout << "check_for_error: " << et.get_error() << endl;
@@ -35,29 +63,46 @@ fhe_backend_t backend_t_from_string(const char* backend)
 {
     // Treat empty string as null
     if (strcmp(backend, "") == 0) { backend = "null"; }
-    try {
-        // cout << "backend_t_from_string: " << backend << endl;
-        return backend_t_map.at(backend);
+    fhe_backend_t type = fhe_backend_t::no_b;
+    if (!find_type(backend_t_names, backend, type)) {
+        set_error(invalid_argument("Unsupported Backend: "+string(backend)));
     }
-    catch (out_of_range &e) { set_error(invalid_argument("Unsupported Backend: "+string(backend))); }
-    return fhe_backend_t::no_b;
+    return type;
 }
 
 fhe_scheme_t scheme_t_from_string(const char* scheme)
 {
     // Treat empty string as null
     if (strcmp(scheme, "") == 0) { scheme = "null"; }
+    fhe_scheme_t type = fhe_scheme_t::no_s;
+    if (!find_type(scheme_t_names, scheme, type)) {
+        set_error(invalid_argument("Unsupported Scheme: "+string(scheme)));
+    }
+    return type;
+}
+
+fhe_prng_t prng_t_from_string(const char* prng)
+{
+    fhe_prng_t type = fhe_prng_t::default_p;
+    if (!find_type(prng_t_names, prng, type)) {
+        set_error(invalid_argument("Unsupported PRNG: "+string(prng)));
+    }
+    return type;
+}
+
+int set_prng(Afhe* afhe, fhe_prng_t prng_type)
+{
     try {
-        return scheme_t_map.at(scheme);
+        afhe->set_prng(to_prng(prng_type));
     }
-    catch (out_of_range &e) { set_error(invalid_argument("Unsupported Scheme: "+string(scheme))); }
-    return fhe_scheme_t::no_s;
+    catch (exception &e) { set_error(e); return -1; }
+    return 0;
 }
 
 const char* generate_context(Afhe* afhe, fhe_scheme_t scheme_type, uint64_t poly_mod_degree, uint64_t pt_mod_bit, uint64_t pt_mod, uint64_t sec_level, const uint64_t* qi_sizes, uint64_t qi_sizes_length)
 {
     try {
-        scheme a_scheme = scheme_t_map_scheme.at(scheme_type);
+        scheme a_scheme = to_scheme(scheme_type);
         vector<int> qi_sizes_vec(qi_sizes, qi_sizes + qi_sizes_length);
         string ctx = afhe->ContextGen(a_scheme, poly_mod_degree, pt_mod_bit, pt_mod, sec_level, qi_sizes_vec);
         return to_char(ctx);
@@ -68,9 +113,8 @@ const char* generate_context(Afhe* afhe, fhe_scheme_t scheme_type, uint64_t poly
 const char* generate_context_from_str(Afhe* afhe, const char* params, int size)
 {
     try {
-        // Convert params to string
-        string params_str(params, size);
-        string ctx = afhe->ContextGen(params_str);
+        // Read in place, without copying into a string
+        string ctx = afhe->ContextGen(reinterpret_cast<const byte*>(params), size);
         return to_char(ctx);
     }
     catch (exception &e) { return set_error(e); }
@@ -106,17 +150,17 @@ int get_slot_count(Afhe* afhe)
 
 fhe_key_t key_t_from_string(const char* key)
 {
-    try {
-        return key_t_map.at(key);
+    fhe_key_t type = fhe_key_t::no_k;
+    if (!find_type(key_t_names, key, type)) {
+        set_error(invalid_argument("Unsupported Key Type: "+string(key)));
     }
-    catch (out_of_range &e) { set_error(invalid_argument("Unsupported Key Type: "+string(key))); }
-    return fhe_key_t::no_k;
+    return type;
 }
 
 AKey* init_key(Afhe* afhe, fhe_key_t key_type)
 {
     if (afhe == nullptr) { set_error(invalid_argument("[init_key] Invalid Afhe")); return nullptr; }
-    fhe_backend_t lib = backend_map_backend_t[afhe->backend_lib];
+    fhe_backend_t lib = to_backend_t(afhe->backend_lib);
     switch (lib)
     {
     case fhe_backend_t::seal_b:
@@ -128,6 +172,8 @@ AKey* init_key(Afhe* afhe, fhe_key_t key_type)
             return new AsealSecretKey();
         case fhe_key_t::relin_k:
             return new AsealRelinKey();
+        case fhe_key_t::galois_k:
+            return new AsealGaloisKey();
         default:
             set_error(invalid_argument("[init_key] Unsupported Key Type"));
             return nullptr;
@@ -150,6 +196,12 @@ void generate_relin_keys(Afhe* afhe)
     catch (exception &e) { set_error(e); }
 }
 
+void generate_galois_keys(Afhe* afhe, const int* steps, int count)
+{
+    try { afhe->GaloisKeyGen(vector<int>(steps, steps + count)); }
+    catch (exception &e) { set_error(e); }
+}
+
 const char* save_key(AKey* key)
 {
     try {
@@ -171,14 +223,49 @@ int save_key_size(AKey* key)
 AKey* load_key(fhe_key_t key_type, Afhe* afhe, const char* data, int size)
 {
     AKey* key = init_key(afhe, key_type);
+    if (key == nullptr) { return nullptr; }
     try {
-        string data_str(data, size);
-        key->load(afhe, data_str);
+        key->load_inplace(afhe, reinterpret_cast<const byte*>(data), size);
     }
     catch (exception &e) { set_error(e); }
     return key;
 }
 
+AKey* load_key_trusted(fhe_key_t key_type, Afhe* afhe, const char* data, int size)
+{
+    AKey* key = init_key(afhe, key_type);
+    if (key == nullptr) { return nullptr; }
+    try {
+        key->load_inplace(afhe, reinterpret_cast<const byte*>(data), size, true);
+    }
+    catch (exception &e) { set_error(e); }
+    return key;
+}
+
+void set_key(fhe_key_t key_type, Afhe* afhe, AKey* key)
+{
+    try {
+        switch (key_type)
+        {
+        case fhe_key_t::public_k:
+            afhe->set_public_key(*key);
+            break;
+        case fhe_key_t::secret_k:
+            afhe->set_secret_key(*key);
+            break;
+        case fhe_key_t::relin_k:
+            afhe->set_relin_keys(*key);
+            break;
+        case fhe_key_t::galois_k:
+            afhe->set_galois_keys(*key);
+            break;
+        default:
+            throw invalid_argument("[set_key] Unsupported Key Type");
+        }
+    }
+    catch (exception &e) { set_error(e); }
+}
+
 uint64_t* get_key_data(AKey* key)
 {
     try {
@@ -198,12 +285,19 @@ uint64_t* get_key_data(AKey* key)
 int get_key_data_size(AKey* key)
 {
     try {
-        vector<uint64_t> key_data = key->data();
-        return key_data.size();
+        return static_cast<int>(key->data_size());
     }
     catch (exception &e) { set_error(e); return -1; }
 }
 
+uint64_t get_key_fingerprint(AKey* key)
+{
+    try {
+        return key->fingerprint();
+    }
+    catch (exception &e) { set_error(e); return 0; }
+}
+
 AKey* get_public_key(Afhe* afhe)
 {
     try {
@@ -228,6 +322,14 @@ AKey* get_relin_keys(Afhe* afhe)
     catch (exception &e) { set_error(e); return nullptr; }
 }
 
+AKey* get_galois_keys(Afhe* afhe)
+{
+    try {
+        return &afhe->get_galois_keys();
+    }
+    catch (exception &e) { set_error(e); return nullptr; }
+}
+
 Afhe* init_backend(fhe_backend_t backend) {
     switch (backend)
     {
@@ -277,49 +379,189 @@ ACiphertext* init_ciphertext(fhe_backend_t backend) {
     }
 }
 
+void delete_plaintext(Afhe* afhe, APlaintext* plaintext) {
+    if (plaintext == nullptr) { return; }
+    if (afhe == nullptr) { delete plaintext; return; }
+    try {
+        afhe->release(plaintext);
+    }
+    catch (exception &e) { set_error(e); }
+}
+
+void delete_ciphertext(Afhe* afhe, ACiphertext* ciphertext) {
+    if (ciphertext == nullptr) { return; }
+    if (afhe == nullptr) { delete ciphertext; return; }
+    try {
+        afhe->release(ciphertext);
+    }
+    catch (exception &e) { set_error(e); }
+}
+
+int set_pool_capacity(Afhe* afhe, int capacity) {
+    try {
+        if (capacity < 0) { throw invalid_argument("Pool capacity must not be negative"); }
+        afhe->set_pool_capacity(static_cast<size_t>(capacity));
+    }
+    catch (exception &e) { set_error(e); return -1; }
+    return 0;
+}
+
 int get_ciphertext_size(ACiphertext* ciphertext) {
     return ciphertext->size();
 }
 
+double get_ciphertext_scale(ACiphertext* ciphertext) {
+    return ciphertext->scale();
+}
+
+void set_ciphertext_scale(ACiphertext* ciphertext, double scale) {
+    ciphertext->set_scale(scale);
+}
+
 const char* save_ciphertext(ACiphertext* ciphertext) {
-    return to_char(ciphertext->save(), true);
+    try {
+        return save_to_char(ciphertext);
+    }
+    catch (exception &e) { set_error(e); }
+    return nullptr;
+}
+
+const char* save_ciphertext_compact(Afhe* afhe, ACiphertext* ciphertext, int min_budget) {
+    try {
+        afhe->compact_for_transfer(*ciphertext, min_budget);
+        return save_to_char(ciphertext);
+    }
+    catch (exception &e) { set_error(e); }
+    return nullptr;
 }
 
 int save_ciphertext_size(ACiphertext* ciphertext) {
     return ciphertext->save_size();
 }
 
+int save_ciphertext_inplace(ACiphertext* ciphertext, uint8_t* out, int size) {
+    int written = -1;
+    try {
+        written = ciphertext->save_inplace(reinterpret_cast<byte*>(out), size);
+    }
+    catch (exception &e) { set_error(e); }
+    return written;
+}
+
 ACiphertext* load_ciphertext(Afhe* fhe, const char* data, int size) {
-    fhe_backend_t lib = backend_map_backend_t[fhe->backend_lib];
-    ACiphertext* ctxt = init_ciphertext(lib);
+    ACiphertext* ctxt = fhe->acquire_ciphertext();
     try {
-        string data_str(data, size);
-        ctxt->load(fhe, data_str);
+        ctxt->load_inplace(fhe, reinterpret_cast<const byte*>(data), size);
     }
     catch (exception &e) { set_error(e); }
     return ctxt;
 }
 
 ACiphertext* encrypt(Afhe* afhe, APlaintext* ptxt) {
-    fhe_backend_t lib = backend_map_backend_t[afhe->backend_lib];
-    ACiphertext* ctxt = init_ciphertext(lib);
+    ACiphertext* ctxt = afhe->acquire_ciphertext();
     try {
-        afhe->encrypt(*ptxt, *ctxt);
+        on_backend(afhe, [&](auto &fhe) { fhe.encrypt(*ptxt, *ctxt); });
     }
     catch (exception &e) { set_error(e); }
     return ctxt;
 }
 
+// Returns acquired results to the pool, when a batch fails
+static void release_many(Afhe* afhe, ACiphertext** out, int count) {
+    for (int i = 0; i < count; i++) {
+        afhe->release(out[i]);
+        out[i] = nullptr;
+    }
+}
+
+int encrypt_many(Afhe* afhe, APlaintext** ptxts, int count, ACiphertext** out) {
+    for (int i = 0; i < count; i++) {
+        out[i] = afhe->acquire_ciphertext();
+    }
+    try {
+        on_backend(afhe, [&](auto &fhe) { fhe.encrypt_many(ptxts, count, out); });
+    }
+    catch (exception &e) { set_error(e); release_many(afhe, out, count); return -1; }
+    return 0;
+}
+
 APlaintext* decrypt(Afhe* afhe, ACiphertext* ctxt) {
-    fhe_backend_t lib = backend_map_backend_t[afhe->backend_lib];
-    APlaintext* ptxt = init_plaintext(lib);
+    APlaintext* ptxt = afhe->acquire_plaintext();
     try {
-        afhe->decrypt(*ctxt, *ptxt);
+        on_backend(afhe, [&](auto &fhe) { fhe.decrypt(*ctxt, *ptxt); });
     }
     catch (exception &e) { set_error(e); }
     return ptxt;
 }
 
+ACiphertext* encrypt_ints(Afhe* afhe, const uint64_t* data, int size) {
+    ACiphertext* ctxt = afhe->acquire_ciphertext();
+    try {
+        afhe->encrypt_int(data, size, *ctxt);
+    }
+    catch (exception &e) { set_error(e); }
+    return ctxt;
+}
+
+ACiphertext* encrypt_doubles(Afhe* afhe, const double* data, int size) {
+    ACiphertext* ctxt = afhe->acquire_ciphertext();
+    try {
+        afhe->encrypt_double(data, size, *ctxt);
+    }
+    catch (exception &e) { set_error(e); }
+    return ctxt;
+}
+
+int decrypt_ints_into(Afhe* afhe, ACiphertext* ctxt, uint64_t* out, size_t cap) {
+    try {
+        return afhe->decrypt_int(*ctxt, out, cap);
+    }
+    catch (exception &e) { set_error(e); return -1; }
+}
+
+int decrypt_doubles_into(Afhe* afhe, ACiphertext* ctxt, double* out, size_t cap) {
+    try {
+        return afhe->decrypt_double(*ctxt, out, cap);
+    }
+    catch (exception &e) { set_error(e); return -1; }
+}
+
+int encrypt_ints_batch(Afhe* afhe, const uint64_t* data, int size, int count, ACiphertext** out) {
+    for (int i = 0; i < count; i++) {
+        out[i] = afhe->acquire_ciphertext();
+    }
+    try {
+        afhe->encrypt_int_batch(data, size, count, out);
+    }
+    catch (exception &e) { set_error(e); release_many(afhe, out, count); return -1; }
+    return 0;
+}
+
+int encrypt_doubles_batch(Afhe* afhe, const double* data, int size, int count, ACiphertext** out) {
+    for (int i = 0; i < count; i++) {
+        out[i] = afhe->acquire_ciphertext();
+    }
+    try {
+        afhe->encrypt_double_batch(data, size, count, out);
+    }
+    catch (exception &e) { set_error(e); release_many(afhe, out, count); return -1; }
+    return 0;
+}
+
+int decrypt_ints_batch_into(Afhe* afhe, ACiphertext** ctxts, int count, uint64_t* out, size_t cap) {
+    try {
+        return afhe->decrypt_int_batch(ctxts, count, out, cap);
+    }
+    catch (exception &e) { set_error(e); return -1; }
+}
+
+int decrypt_doubles_batch_into(Afhe* afhe, ACiphertext** ctxts, int count, double* out, size_t cap) {
+    try {
+        return afhe->decrypt_double_batch(ctxts, count, out, cap);
+    }
+    catch (exception &e) { set_error(e); return -1; }
+}
+
 int invariant_noise_budget(Afhe* afhe, ACiphertext* ctxt) {
     int noise_budget = -1;
     try {
@@ -329,9 +571,18 @@ int invariant_noise_budget(Afhe* afhe, ACiphertext* ctxt) {
     return noise_budget;
 }
 
+int estimate_noise_budget(Afhe* afhe, ACiphertext* ctxt) {
+    int noise_budget = -1;
+    try {
+        noise_budget = afhe->estimate_noise_budget(*ctxt);
+    }
+    catch (exception &e) { set_error(e); }
+    return noise_budget;
+}
+
 ACiphertext* relinearize(Afhe* afhe, ACiphertext* ctxt) {
     try {
-        afhe->relinearize(*ctxt);
+        on_backend(afhe, [&](auto &fhe) { fhe.relinearize(*ctxt); });
     }
     catch (exception &e) { set_error(e); }
     return ctxt;
@@ -339,105 +590,208 @@ ACiphertext* relinearize(Afhe* afhe, ACiphertext* ctxt) {
 
 void mod_switch_to_next(Afhe* afhe, ACiphertext* ctxt) {
     try {
-        afhe->mod_switch_to_next(*ctxt);
+        on_backend(afhe, [&](auto &fhe) { fhe.mod_switch_to_next(*ctxt); });
     }
     catch (exception &e) { set_error(e); }
 }
 
+int compact_for_transfer(Afhe* afhe, ACiphertext* ctxt, int min_budget) {
+    int levels = -1;
+    try {
+        levels = afhe->compact_for_transfer(*ctxt, min_budget);
+    }
+    catch (exception &e) { set_error(e); }
+    return levels;
+}
+
+void rescale_to_next(Afhe* afhe, ACiphertext* ctxt) {
+    try {
+        on_backend(afhe, [&](auto &fhe) { fhe.rescale_to_next(*ctxt); });
+    }
+    catch (exception &e) { set_error(e); }
+}
+
+int get_chain_index(Afhe* afhe, ACiphertext* ctxt) {
+    try {
+        return afhe->chain_index(*ctxt);
+    }
+    catch (exception &e) { set_error(e); return -1; }
+}
+
+int get_ciphertext_level(Afhe* afhe, ACiphertext* ctxt) {
+    try {
+        return afhe->level(*ctxt);
+    }
+    catch (exception &e) { set_error(e); return -1; }
+}
+
+int get_coeff_modulus_count(Afhe* afhe, ACiphertext* ctxt) {
+    try {
+        return afhe->coeff_modulus_count(*ctxt);
+    }
+    catch (exception &e) { set_error(e); return -1; }
+}
+
+int mod_switch_to_level(Afhe* afhe, ACiphertext* ctxt, int level) {
+    try {
+        afhe->mod_switch_to_level(*ctxt, level);
+    }
+    catch (exception &e) { set_error(e); return -1; }
+    return 0;
+}
+
+int get_level_count(Afhe* afhe) {
+    try {
+        return afhe->level_costs().size();
+    }
+    catch (exception &e) { set_error(e); return -1; }
+}
+
+int get_level_costs(Afhe* afhe, double* out, size_t cap) {
+    try {
+        vector<level_cost> costs = afhe->level_costs();
+        size_t rows = min(costs.size(), cap / 4);
+        for (size_t i = 0; i < rows; i++) {
+            out[4 * i] = costs[i].primes;
+            out[4 * i + 1] = costs[i].log2_modulus;
+            out[4 * i + 2] = costs[i].multiply;
+            out[4 * i + 3] = costs[i].key_switch;
+        }
+        return rows;
+    }
+    catch (exception &e) { set_error(e); return -1; }
+}
+
 ACiphertext* add(Afhe* afhe, ACiphertext* ctxt1, ACiphertext* ctxt2) {
-    fhe_backend_t lib = backend_map_backend_t[afhe->backend_lib];
-    ACiphertext* ctxt = init_ciphertext(lib);
+    ACiphertext* ctxt = afhe->acquire_ciphertext();
     try {
-        afhe->add(*ctxt1, *ctxt2, *ctxt);
+        on_backend(afhe, [&](auto &fhe) { fhe.add(*ctxt1, *ctxt2, *ctxt); });
     }
     catch (exception &e) { set_error(e); }
     return ctxt;
 }
 
+ACiphertext* add_many(Afhe* afhe, ACiphertext** ctxts, int count) {
+    ACiphertext* ctxt_res = afhe->acquire_ciphertext();
+    try {
+        on_backend(afhe, [&](auto &fhe) { fhe.add_many(ctxts, count, *ctxt_res); });
+    }
+    catch (exception &e) { set_error(e); }
+    return ctxt_res;
+}
+
 ACiphertext* add_plain(Afhe* afhe, ACiphertext* ctxt, APlaintext* ptxt) {
-    fhe_backend_t lib = backend_map_backend_t[afhe->backend_lib];
-    ACiphertext* ctxt_res = init_ciphertext(lib);
+    ACiphertext* ctxt_res = afhe->acquire_ciphertext();
     try {
-        afhe->add(*ctxt, *ptxt, *ctxt_res);
+        on_backend(afhe, [&](auto &fhe) { fhe.add(*ctxt, *ptxt, *ctxt_res); });
     }
     catch (exception &e) { set_error(e); }
     return ctxt_res;
 }
 
 ACiphertext* subtract(Afhe* afhe, ACiphertext* ctxt1, ACiphertext* ctxt2) {
-    fhe_backend_t lib = backend_map_backend_t[afhe->backend_lib];
-    ACiphertext* ctxt = init_ciphertext(lib);
+    ACiphertext* ctxt = afhe->acquire_ciphertext();
     try {
-        afhe->subtract(*ctxt1, *ctxt2, *ctxt);
+        on_backend(afhe, [&](auto &fhe) { fhe.subtract(*ctxt1, *ctxt2, *ctxt); });
     }
     catch (exception &e) { set_error(e); }
     return ctxt;
 }
 
 ACiphertext* subtract_plain(Afhe* afhe, ACiphertext* ctxt, APlaintext* ptxt) {
-    fhe_backend_t lib = backend_map_backend_t[afhe->backend_lib];
-    ACiphertext* ctxt_res = init_ciphertext(lib);
+    ACiphertext* ctxt_res = afhe->acquire_ciphertext();
     try {
-        afhe->subtract(*ctxt, *ptxt, *ctxt_res);
+        on_backend(afhe, [&](auto &fhe) { fhe.subtract(*ctxt, *ptxt, *ctxt_res); });
     }
     catch (exception &e) { set_error(e); }
     return ctxt_res;
 }
 
 ACiphertext* multiply(Afhe* afhe, ACiphertext* ctxt1, ACiphertext* ctxt2) {
-    fhe_backend_t lib = backend_map_backend_t[afhe->backend_lib];
-    ACiphertext* ctxt = init_ciphertext(lib);
+    ACiphertext* ctxt = afhe->acquire_ciphertext();
     try {
-        afhe->multiply(*ctxt1, *ctxt2, *ctxt);
+        on_backend(afhe, [&](auto &fhe) { fhe.multiply(*ctxt1, *ctxt2, *ctxt); });
     }
     catch (exception &e) { set_error(e); }
     return ctxt;
 }
 
+ACiphertext* multiply_many(Afhe* afhe, ACiphertext** ctxts, int count) {
+    ACiphertext* ctxt_res = afhe->acquire_ciphertext();
+    try {
+        on_backend(afhe, [&](auto &fhe) { fhe.multiply_many(ctxts, count, *ctxt_res); });
+    }
+    catch (exception &e) { set_error(e); }
+    return ctxt_res;
+}
+
 ACiphertext* multiply_plain(Afhe* afhe, ACiphertext* ctxt, APlaintext* ptxt) {
-    fhe_backend_t lib = backend_map_backend_t[afhe->backend_lib];
-    ACiphertext* ctxt_res = init_ciphertext(lib);
+    ACiphertext* ctxt_res = afhe->acquire_ciphertext();
     try {
-        afhe->multiply(*ctxt, *ptxt, *ctxt_res);
+        on_backend(afhe, [&](auto &fhe) { fhe.multiply(*ctxt, *ptxt, *ctxt_res); });
     }
     catch (exception &e) { set_error(e); }
     return ctxt_res;
 }
 
 ACiphertext* square(Afhe* afhe, ACiphertext* ctxt) {
-    fhe_backend_t lib = backend_map_backend_t[afhe->backend_lib];
-    ACiphertext* ctxt_res = init_ciphertext(lib);
+    ACiphertext* ctxt_res = afhe->acquire_ciphertext();
     try {
-        afhe->square(*ctxt, *ctxt_res);
+        on_backend(afhe, [&](auto &fhe) { fhe.square(*ctxt, *ctxt_res); });
     }
     catch (exception &e) { set_error(e); }
     return ctxt_res;
 }
 
 ACiphertext* power(Afhe* afhe, ACiphertext* ctxt, int power) {
-    fhe_backend_t lib = backend_map_backend_t[afhe->backend_lib];
-    ACiphertext* ctxt_res = init_ciphertext(lib);
+    ACiphertext* ctxt_res = afhe->acquire_ciphertext();
+    try {
+        on_backend(afhe, [&](auto &fhe) { fhe.power(*ctxt, power, *ctxt_res); });
+    }
+    catch (exception &e) { set_error(e); }
+    return ctxt_res;
+}
+
+ACiphertext* eval_polynomial(Afhe* afhe, ACiphertext* ctxt, const double* coeffs, int count) {
+    ACiphertext* ctxt_res = afhe->acquire_ciphertext();
+    try {
+        afhe->eval_polynomial(*ctxt, coeffs, count, *ctxt_res);
+    }
+    catch (exception &e) { set_error(e); }
+    return ctxt_res;
+}
+
+ACiphertext* rotate(Afhe* afhe, ACiphertext* ctxt, int steps) {
+    ACiphertext* ctxt_res = afhe->acquire_ciphertext();
     try {
-        afhe->power(*ctxt, power, *ctxt_res);
+        on_backend(afhe, [&](auto &fhe) { fhe.rotate(*ctxt, steps, *ctxt_res); });
     }
     catch (exception &e) { set_error(e); }
     return ctxt_res;
 }
 
+int rotate_batch(Afhe* afhe, ACiphertext* ctxt, const int* steps, int count, ACiphertext** out) {
+    for (int i = 0; i < count; i++) {
+        out[i] = afhe->acquire_ciphertext();
+    }
+    try {
+        on_backend(afhe, [&](auto &fhe) { fhe.rotate_batch(*ctxt, steps, count, out); });
+    }
+    catch (exception &e) { set_error(e); release_many(afhe, out, count); return -1; }
+    return 0;
+}
+
 APlaintext* encode_int(Afhe* afhe, uint64_t* data, int size) {
-    fhe_backend_t lib = backend_map_backend_t[afhe->backend_lib];
-    APlaintext* ptxt = init_plaintext(lib);
+    APlaintext* ptxt = afhe->acquire_plaintext();
     try {
-        // Convert array to vector
-        vector<uint64_t> data_vec(data, data + size);
-        afhe->encode_int(data_vec, *ptxt);
+        // Encode directly from the caller's array
+        afhe->encode_int(data, size, *ptxt);
     }
     catch (exception &e) { set_error(e); }
     return ptxt;
 }
 
 uint64_t* decode_int(Afhe* afhe, APlaintext* ptxt) {
-    fhe_backend_t lib = backend_map_backend_t[afhe->backend_lib];
     vector<uint64_t> data;
     try {
         afhe->decode_int(*ptxt, data);
@@ -449,21 +803,25 @@ uint64_t* decode_int(Afhe* afhe, APlaintext* ptxt) {
     return result;
 }
 
+int decode_int_into(Afhe* afhe, APlaintext* ptxt, uint64_t* out, size_t cap) {
+    try {
+        return afhe->decode_int(*ptxt, out, cap);
+    }
+    catch (exception &e) { set_error(e); return -1; }
+}
+
 APlaintext* encode_double(Afhe* afhe, double* data, int size) {
-    fhe_backend_t lib = backend_map_backend_t[afhe->backend_lib];
-    APlaintext* ptxt = init_plaintext(lib);
+    APlaintext* ptxt = afhe->acquire_plaintext();
     try {
-        // Convert array to vector
-        vector<double> data_vec(data, data + size);
-        afhe->encode_double(data_vec, *ptxt);
+        // Encode directly from the caller's array
+        afhe->encode_double(data, size, *ptxt);
     }
     catch (exception &e) { set_error(e); }
     return ptxt;
 }
 
 APlaintext* encode_double_value(Afhe* afhe, double data) {
-    fhe_backend_t lib = backend_map_backend_t[afhe->backend_lib];
-    APlaintext* ptxt = init_plaintext(lib);
+    APlaintext* ptxt = afhe->acquire_plaintext();
     try {
         afhe->encode_double(data, *ptxt);
     }
@@ -472,7 +830,6 @@ APlaintext* encode_double_value(Afhe* afhe, double data) {
 }
 
 double* decode_double(Afhe* afhe, APlaintext* ptxt) {
-    fhe_backend_t lib = backend_map_backend_t[afhe->backend_lib];
     vector<double> data;
     try {
         afhe->decode_double(*ptxt, data);
@@ -483,3 +840,230 @@ double* decode_double(Afhe* afhe, APlaintext* ptxt) {
     copy(data.begin(), data.end(), result);
     return result;
 }
+
+int decode_double_into(Afhe* afhe, APlaintext* ptxt, double* out, size_t cap) {
+    try {
+        return afhe->decode_double(*ptxt, out, cap);
+    }
+    catch (exception &e) { set_error(e); return -1; }
+}
+
+APlaintext* encode_complex(Afhe* afhe, const double* data, int size) {
+    APlaintext* ptxt = afhe->acquire_plaintext();
+    try {
+        // Interleaved doubles share the layout of complex<double>
+        afhe->encode_complex(reinterpret_cast<const complex<double>*>(data), size, *ptxt);
+    }
+    catch (exception &e) { set_error(e); }
+    return ptxt;
+}
+
+int decode_complex_into(Afhe* afhe, APlaintext* ptxt, double* out, size_t cap) {
+    try {
+        return afhe->decode_complex(*ptxt, reinterpret_cast<complex<double>*>(out), cap);
+    }
+    catch (exception &e) { set_error(e); return -1; }
+}
+
+Packing* init_packing(Afhe* afhe, int record_size) {
+    try {
+        if (record_size <= 0) {
+            throw invalid_argument("record_size must be positive");
+        }
+        return new Packing(afhe, record_size);
+    }
+    catch (exception &e) { set_error(e); return nullptr; }
+}
+
+void delete_packing(Packing* packing) {
+    delete packing;
+}
+
+int get_packing_capacity(Packing* packing) {
+    return packing->capacity();
+}
+
+APlaintext* pack_int(Afhe* afhe, Packing* packing, uint64_t* records, int count) {
+    APlaintext* ptxt = afhe->acquire_plaintext();
+    try {
+        packing->encode_int(records, count, *ptxt);
+    }
+    catch (exception &e) { set_error(e); }
+    return ptxt;
+}
+
+int unpack_int(Afhe* afhe, Packing* packing, APlaintext* ptxt, uint64_t* records, int count) {
+    try {
+        packing->decode_int(*ptxt, records, count);
+        return count;
+    }
+    catch (exception &e) { set_error(e); return -1; }
+}
+
+APlaintext* pack_replicated_int(Afhe* afhe, Packing* packing, uint64_t* record) {
+    APlaintext* ptxt = afhe->acquire_plaintext();
+    try {
+        packing->encode_replicated_int(record, *ptxt);
+    }
+    catch (exception &e) { set_error(e); }
+    return ptxt;
+}
+
+APlaintext* pack_double(Afhe* afhe, Packing* packing, double* records, int count) {
+    APlaintext* ptxt = afhe->acquire_plaintext();
+    try {
+        packing->encode_double(records, count, *ptxt);
+    }
+    catch (exception &e) { set_error(e); }
+    return ptxt;
+}
+
+int unpack_double(Afhe* afhe, Packing* packing, APlaintext* ptxt, double* records, int count) {
+    try {
+        packing->decode_double(*ptxt, records, count);
+        return count;
+    }
+    catch (exception &e) { set_error(e); return -1; }
+}
+
+APlaintext* pack_replicated_double(Afhe* afhe, Packing* packing, double* record) {
+    APlaintext* ptxt = afhe->acquire_plaintext();
+    try {
+        packing->encode_replicated_double(record, *ptxt);
+    }
+    catch (exception &e) { set_error(e); }
+    return ptxt;
+}
+
+ACiphertext* select_record(Afhe* afhe, Packing* packing, ACiphertext* ctxt, int record) {
+    ACiphertext* ctxt_res = afhe->acquire_ciphertext();
+    APlaintext* mask = afhe->acquire_plaintext();
+    try {
+        packing->encode_mask(record, *mask);
+        if (afhe->get_scheme() == scheme::ckks) {
+            // Mask is encoded at the first level, and squares the scale
+            afhe->mod_switch_to(*mask, *ctxt);
+            afhe->multiply(*ctxt, *mask, *ctxt_res);
+            afhe->rescale_to_next(*ctxt_res);
+        }
+        else {
+            afhe->multiply(*ctxt, *mask, *ctxt_res);
+        }
+    }
+    catch (exception &e) { set_error(e); }
+    afhe->release(mask);
+    return ctxt_res;
+}
+
+APlainMatrix* init_plain_matrix(fhe_backend_t backend) {
+    switch (backend)
+    {
+    case fhe_backend_t::seal_b:
+        return new AsealPlainMatrix();
+    default:
+        set_error(logic_error("[init_plain_matrix] No backend set"));
+        return nullptr;
+    }
+}
+
+APlainMatrix* encode_matrix_int(Afhe* afhe, const uint64_t* data, int rows, int cols) {
+    fhe_backend_t lib = to_backend_t(afhe->backend_lib);
+    APlainMatrix* mat = init_plain_matrix(lib);
+    if (mat == nullptr) { return nullptr; }
+    try {
+        afhe->encode_matrix_int(data, rows, cols, *mat);
+    }
+    catch (exception &e) { set_error(e); delete mat; return nullptr; }
+    return mat;
+}
+
+APlainMatrix* encode_matrix_double(Afhe* afhe, const double* data, int rows, int cols) {
+    fhe_backend_t lib = to_backend_t(afhe->backend_lib);
+    APlainMatrix* mat = init_plain_matrix(lib);
+    if (mat == nullptr) { return nullptr; }
+    try {
+        afhe->encode_matrix_double(data, rows, cols, *mat);
+    }
+    catch (exception &e) { set_error(e); delete mat; return nullptr; }
+    return mat;
+}
+
+void delete_plain_matrix(APlainMatrix* mat) {
+    delete mat;
+}
+
+int get_matrix_dim(APlainMatrix* mat) {
+    return mat->dim();
+}
+
+int get_matrix_rotation_steps(APlainMatrix* mat, int* out, int cap) {
+    try {
+        vector<int> steps = mat->rotation_steps();
+        copy_n(steps.begin(), min<size_t>(steps.size(), cap), out);
+        return steps.size();
+    }
+    catch (exception &e) { set_error(e); return -1; }
+}
+
+ACiphertext* matvec_plain(Afhe* afhe, APlainMatrix* mat, ACiphertext* ctxt) {
+    ACiphertext* ctxt_res = afhe->acquire_ciphertext();
+    try {
+        afhe->matvec_plain(*mat, *ctxt, *ctxt_res);
+    }
+    catch (exception &e) { set_error(e); }
+    return ctxt_res;
+}
+
+KeyCache* init_key_cache(uint64_t budget_bytes, const char* spill_dir)
+{
+    try {
+        return new KeyCache(budget_bytes, spill_dir == nullptr ? "" : spill_dir);
+    }
+    catch (exception &e) { set_error(e); return nullptr; }
+}
+
+void delete_key_cache(KeyCache* cache)
+{
+    delete cache;
+}
+
+// Creates empty keys for the backend of afhe
+static KeyFactory key_factory(Afhe* afhe)
+{
+    return [afhe](key type) { return init_key(afhe, static_cast<fhe_key_t>(type)); };
+}
+
+uint64_t key_cache_load(KeyCache* cache, fhe_key_t key_type, Afhe* afhe, const char* data, int size, int trusted)
+{
+    try {
+        uint64_t cache_id = 0;
+        key type = to_key(key_type);
+        shared_ptr<AKey> k = cache->load(afhe, type, reinterpret_cast<const byte*>(data), size,
+                                         trusted != 0, key_factory(afhe), cache_id);
+        afhe->share_key(type, k);
+        return cache_id;
+    }
+    catch (exception &e) { set_error(e); return 0; }
+}
+
+int key_cache_attach(KeyCache* cache, Afhe* afhe, uint64_t cache_id)
+{
+    try {
+        key type = key::no_key;
+        shared_ptr<AKey> k = cache->find(afhe, cache_id, key_factory(afhe), type);
+        if (k == nullptr) { return 0; }
+        afhe->share_key(type, k);
+        return 1;
+    }
+    catch (exception &e) { set_error(e); return -1; }
+}
+
+uint64_t key_cache_memory_size(KeyCache* cache)
+{
+    return cache->memory_size();
+}
+
+int key_cache_count(KeyCache* cache)
+{
+    return static_cast<int>(cache->count());
+}
@@ -0,0 +1,366 @@
+/**
+ * @file key_cache.cpp
+ * ------------------------------------------------------------------
+ * @brief Implementation of the key cache, with memory-mapped spill.
+ * ------------------------------------------------------------------
+ * @author Jeffrey Murray Jr (jeffmur)
+*/
+
+#include <cstdio>      /* remove, snprintf */
+#include <random>      /* random_device */
+#include <stdexcept>   /* invalid_argument, runtime_error */
+#include "key_cache.h"
+#include "fingerprint.h"
+
+#ifndef _WIN32
+#include <fcntl.h>     /* open, O_EXCL */
+#include <sys/mman.h>  /* mmap, munmap */
+#include <sys/stat.h>  /* fstat, S_IRUSR */
+#include <unistd.h>    /* close, write */
+#endif
+
+using namespace std;
+
+// Draws a secret 64-bit seed from the system entropy source
+static uint64_t random_seed()
+{
+  random_device rd;
+  return (static_cast<uint64_t>(rd()) << 32) ^ rd();
+}
+
+KeyCache::KeyCache(size_t budget_bytes, string spill_dir)
+    : id_seed(random_seed()), check_seed(random_seed()), budget(budget_bytes), spill_dir(spill_dir)
+{
+#ifdef _WIN32
+  if (!spill_dir.empty())
+  {
+    throw invalid_argument("Spilling keys to disk is not supported on this platform");
+  }
+#endif
+}
+
+KeyCache::~KeyCache()
+{
+  for (auto &it : entries)
+  {
+    if (!it.second.spill_path.empty())
+    {
+      remove(it.second.spill_path.c_str());
+    }
+  }
+}
+
+void KeyCache::touch(Entry &entry, uint64_t id)
+{
+  lru.erase(entry.lru);
+  lru.push_front(id);
+  entry.lru = lru.begin();
+}
+
+void KeyCache::insert(uint64_t id, key type, size_t bytes, uint64_t check, shared_ptr<AKey> value)
+{
+  Entry &entry = entries[id];
+  entry.type = type;
+  entry.bytes = bytes;
+  entry.check = check;
+  entry.value = value;
+  lru.push_front(id);
+  entry.lru = lru.begin();
+  used += bytes;
+}
+
+void KeyCache::verify(const Entry &entry, key type, size_t bytes, uint64_t check)
+{
+  if (entry.type != type || entry.bytes != bytes || entry.check != check)
+  {
+    throw invalid_argument("Key collides with a different cached key");
+  }
+}
+
+void KeyCache::restore(Entry &entry, uint64_t id, shared_ptr<AKey> value)
+{
+  // Back in memory, the spilled file is kept for the next eviction
+  entry.value = value;
+  lru.push_front(id);
+  entry.lru = lru.begin();
+  used += entry.bytes;
+}
+
+vector<KeyCache::Victim> KeyCache::spill_candidates()
+{
+  vector<Victim> victims;
+  if (spill_dir.empty())
+  {
+    return victims;
+  }
+
+  // Same keys as drop_past_budget(), unless used again meanwhile
+  size_t remaining = used, kept = lru.size();
+  for (auto it = lru.rbegin(); remaining > budget && kept > 1; ++it, --kept)
+  {
+    Entry &entry = entries.at(*it);
+    remaining -= entry.bytes;
+    if (entry.spill_path.empty() && !entry.spilling)
+    {
+      victims.push_back({*it, entry.value, ""});
+      entry.spilling = true;
+    }
+  }
+  return victims;
+}
+
+void KeyCache::drop_past_budget()
+{
+  while (used > budget && lru.size() > 1)
+  {
+    uint64_t id = lru.back();
+    lru.pop_back();
+    auto it = entries.find(id);
+    used -= it->second.bytes;
+
+    if (it->second.spill_path.empty())
+    {
+      // Not on disk, loaded again from the tenant
+      entries.erase(it);
+      continue;
+    }
+    it->second.value = nullptr;
+  }
+}
+
+string KeyCache::write_spill(uint64_t id, AKey &value)
+{
+#ifdef _WIN32
+  return "";
+#else
+  char name[32];
+  snprintf(name, sizeof(name), "/%016llx.key", static_cast<unsigned long long>(id));
+  string path = spill_dir + name;
+  try
+  {
+    string data = value.save();
+
+    // Replaces a stale file, created anew with owner-only permissions
+    remove(path.c_str());
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+    if (fd < 0)
+    {
+      return "";
+    }
+    size_t written = 0;
+    while (written < data.size())
+    {
+      ssize_t n = write(fd, data.data() + written, data.size() - written);
+      if (n <= 0)
+      {
+        break;
+      }
+      written += static_cast<size_t>(n);
+    }
+    if (close(fd) != 0 || written != data.size())
+    {
+      remove(path.c_str());
+      return "";
+    }
+    return path;
+  }
+  catch (exception &)
+  {
+    remove(path.c_str());
+    return "";
+  }
+#endif
+}
+
+void KeyCache::evict()
+{
+  vector<Victim> victims;
+  {
+    lock_guard<mutex> guard(lock);
+    if (used <= budget)
+    {
+      return;
+    }
+    victims = spill_candidates();
+  }
+
+  // Serialized and written without the lock, other tenants are served meanwhile
+  for (Victim &victim : victims)
+  {
+    victim.path = write_spill(victim.id, *victim.value);
+  }
+
+  lock_guard<mutex> guard(lock);
+  for (Victim &victim : victims)
+  {
+    auto it = entries.find(victim.id);
+    if (it == entries.end())
+    {
+      // Dropped meanwhile, the file is no longer needed
+      if (!victim.path.empty())
+      {
+        remove(victim.path.c_str());
+      }
+      continue;
+    }
+    it->second.spilling = false;
+    if (!victim.path.empty())
+    {
+      it->second.spill_path = victim.path;
+    }
+  }
+  drop_past_budget();
+}
+
+shared_ptr<AKey> KeyCache::deserialize(Afhe* fhe, key type, const byte* data, size_t size,
+                                       bool trusted, const KeyFactory &make_key)
+{
+  shared_ptr<AKey> value(make_key(type));
+  if (value == nullptr)
+  {
+    throw invalid_argument("Unsupported Key Type");
+  }
+  value->load_inplace(fhe, data, static_cast<int>(size), trusted);
+  return value;
+}
+
+shared_ptr<AKey> KeyCache::load(Afhe* fhe, key type, const byte* data, size_t size, bool trusted,
+                                const KeyFactory &make_key, uint64_t &id)
+{
+  // Spilled to disk in the clear, only evaluation and public keys are cached
+  if (type != key::public_key && type != key::relin_keys && type != key::galois_keys)
+  {
+    throw invalid_argument("Only public, relinearization and galois keys are cached");
+  }
+
+  // Seeded by the cache, the hashes of a serialization are not known in advance
+  id = fingerprint(data, size, id_seed);
+  const uint64_t check = fingerprint(data, size, check_seed);
+  {
+    lock_guard<mutex> guard(lock);
+    auto it = entries.find(id);
+    if (it != entries.end())
+    {
+      verify(it->second, type, size, check);
+    }
+    if (it != entries.end() && it->second.value != nullptr)
+    {
+      touch(it->second, id);
+      return it->second.value;
+    }
+  }
+
+  // Deserialized without the lock, other tenants are served meanwhile
+  shared_ptr<AKey> value = deserialize(fhe, type, data, size, trusted, make_key);
+
+  {
+    lock_guard<mutex> guard(lock);
+    auto it = entries.find(id);
+    if (it != entries.end())
+    {
+      verify(it->second, type, size, check);
+    }
+    if (it != entries.end() && it->second.value != nullptr)
+    {
+      // Loaded concurrently by another request
+      touch(it->second, id);
+      return it->second.value;
+    }
+    if (it != entries.end())
+    {
+      restore(it->second, id, value);
+    }
+    else
+    {
+      insert(id, type, size, check, value);
+    }
+  }
+  evict();
+  return value;
+}
+
+shared_ptr<AKey> KeyCache::find(Afhe* fhe, uint64_t id, const KeyFactory &make_key, key &type)
+{
+  string path;
+  {
+    lock_guard<mutex> guard(lock);
+    auto it = entries.find(id);
+    if (it == entries.end())
+    {
+      return nullptr;
+    }
+    type = it->second.type;
+    if (it->second.value != nullptr)
+    {
+      touch(it->second, id);
+      return it->second.value;
+    }
+    path = it->second.spill_path;
+  }
+
+#ifdef _WIN32
+  return nullptr;
+#else
+  // Map the spilled key, deserialized straight from the page cache
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    throw runtime_error("Cannot open spilled key: " + path);
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0)
+  {
+    close(fd);
+    throw runtime_error("Cannot read spilled key: " + path);
+  }
+  size_t size = static_cast<size_t>(st.st_size);
+  void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapped == MAP_FAILED)
+  {
+    throw runtime_error("Cannot map spilled key: " + path);
+  }
+
+  shared_ptr<AKey> value;
+  try
+  {
+    // Written by this cache, validated when first loaded
+    value = deserialize(fhe, type, static_cast<const byte*>(mapped), size, true, make_key);
+  }
+  catch (...)
+  {
+    munmap(mapped, size);
+    throw;
+  }
+  munmap(mapped, size);
+
+  {
+    lock_guard<mutex> guard(lock);
+    auto it = entries.find(id);
+    if (it == entries.end())
+    {
+      return value;
+    }
+    if (it->second.value != nullptr)
+    {
+      touch(it->second, id);
+      return it->second.value;
+    }
+    restore(it->second, id, value);
+  }
+  evict();
+  return value;
+#endif
+}
+
+size_t KeyCache::memory_size()
+{
+  lock_guard<mutex> guard(lock);
+  return used;
+}
+
+size_t KeyCache::count()
+{
+  lock_guard<mutex> guard(lock);
+  return entries.size();
+}
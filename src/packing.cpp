@@ -0,0 +1,139 @@
+/**
+ * @file packing.cpp
+ * ------------------------------------------------------------------
+ * @brief Implementation of the batch packing layer.
+ * ------------------------------------------------------------------
+ * @author Jeffrey Murray Jr (jeffmur)
+*/
+
+#include <stdexcept> /* invalid_argument */
+#include <algorithm> /* copy_n */
+#include "packing.h"
+
+using namespace std;
+
+Packing::Packing(Afhe* fhe, size_t record_size) : fhe(fhe), rsize(record_size)
+{
+  if (fhe == nullptr)
+  {
+    throw invalid_argument("Packing requires an initialized backend");
+  }
+  if (record_size == 0)
+  {
+    throw invalid_argument("record_size must be positive");
+  }
+
+  // Throws when the encoders are not initialized
+  this->slots = fhe->slot_count();
+
+  // Bounds the rounding below, the number of slots is a power of two
+  if (record_size > this->slots)
+  {
+    throw invalid_argument("record_size exceeds the number of slots");
+  }
+
+  // Round up to a power of two, aligned with rotation boundaries
+  this->rstride = 1;
+  while (this->rstride < record_size)
+  {
+    this->rstride <<= 1;
+  }
+}
+
+void Packing::check_count(size_t count)
+{
+  if (count > capacity())
+  {
+    throw invalid_argument("Number of records (" + to_string(count) +
+                           ") exceeds the packing capacity (" + to_string(capacity()) + ")");
+  }
+}
+
+template <typename T>
+vector<T> Packing::scatter(const T* records, size_t count)
+{
+  check_count(count);
+  vector<T> slot_data(this->slots, T(0));
+  for (size_t r = 0; r < count; r++)
+  {
+    copy_n(records + r * this->rsize, this->rsize, slot_data.begin() + offset(r));
+  }
+  return slot_data;
+}
+
+template <typename T>
+void Packing::gather(const vector<T> &slot_data, T* records, size_t count)
+{
+  check_count(count);
+  for (size_t r = 0; r < count; r++)
+  {
+    copy_n(slot_data.begin() + offset(r), this->rsize, records + r * this->rsize);
+  }
+}
+
+void Packing::encode_int(const uint64_t* records, size_t count, APlaintext &ptxt)
+{
+  vector<uint64_t> slot_data = scatter(records, count);
+  this->fhe->encode_int(slot_data, ptxt);
+}
+
+void Packing::decode_int(APlaintext &ptxt, uint64_t* records, size_t count)
+{
+  vector<uint64_t> slot_data;
+  this->fhe->decode_int(ptxt, slot_data);
+  gather(slot_data, records, count);
+}
+
+void Packing::encode_double(const double* records, size_t count, APlaintext &ptxt)
+{
+  vector<double> slot_data = scatter(records, count);
+  this->fhe->encode_double(slot_data, ptxt);
+}
+
+void Packing::decode_double(APlaintext &ptxt, double* records, size_t count)
+{
+  vector<double> slot_data;
+  this->fhe->decode_double(ptxt, slot_data);
+  gather(slot_data, records, count);
+}
+
+void Packing::encode_replicated_int(const uint64_t* record, APlaintext &ptxt)
+{
+  vector<uint64_t> slot_data(this->slots, 0ULL);
+  for (size_t r = 0; r < capacity(); r++)
+  {
+    copy_n(record, this->rsize, slot_data.begin() + offset(r));
+  }
+  this->fhe->encode_int(slot_data, ptxt);
+}
+
+void Packing::encode_replicated_double(const double* record, APlaintext &ptxt)
+{
+  vector<double> slot_data(this->slots, 0.0);
+  for (size_t r = 0; r < capacity(); r++)
+  {
+    copy_n(record, this->rsize, slot_data.begin() + offset(r));
+  }
+  this->fhe->encode_double(slot_data, ptxt);
+}
+
+void Packing::encode_mask(size_t record, APlaintext &ptxt)
+{
+  if (record >= capacity())
+  {
+    throw invalid_argument("Record index is out of range");
+  }
+
+  if (this->fhe->get_scheme() == scheme::ckks)
+  {
+    vector<double> mask(this->slots, 0.0);
+    fill_n(mask.begin() + offset(record), this->rsize, 1.0);
+    this->fhe->encode_double(mask, ptxt);
+  }
+  else
+  {
+    vector<uint64_t> mask(this->slots, 0ULL);
+    fill_n(mask.begin() + offset(record), this->rsize, 1ULL);
+    this->fhe->encode_int(mask, ptxt);
+  }
+}
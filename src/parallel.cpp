@@ -0,0 +1,105 @@
+/**
+ * @file parallel.cpp
+ * ------------------------------------------------------------------
+ * @brief Implementation of the persistent thread pool.
+ * ------------------------------------------------------------------
+ * @author Jeffrey Murray Jr (jeffmur)
+*/
+
+#include <algorithm> /* find, max */
+#include "parallel.h"
+
+using namespace std;
+
+void ThreadPool::Job::work()
+{
+  for (size_t i = next++; i < count; i = next++)
+  {
+    try
+    {
+      (*body)(i);
+    }
+    catch (...)
+    {
+      lock_guard<mutex> guard(lock);
+      if (!error)
+      {
+        error = current_exception();
+      }
+    }
+
+    if (++done == count)
+    {
+      lock_guard<mutex> guard(lock);
+      finished.notify_all();
+    }
+  }
+}
+
+ThreadPool::ThreadPool(size_t size)
+{
+  for (size_t w = 0; w < size; w++)
+  {
+    workers.emplace_back(&ThreadPool::worker, this);
+  }
+}
+
+ThreadPool& ThreadPool::instance()
+{
+  // Never destroyed, workers may still wait for jobs while the process exits
+  static ThreadPool* pool = new ThreadPool(max(1u, thread::hardware_concurrency()) - 1);
+  return *pool;
+}
+
+void ThreadPool::worker()
+{
+  for (;;)
+  {
+    shared_ptr<Job> job;
+    {
+      unique_lock<mutex> guard(lock);
+      wake.wait(guard, [this] { return !jobs.empty(); });
+      job = jobs.front();
+      if (job->next >= job->count)
+      {
+        // Every task is claimed, the remaining ones finish on other threads
+        jobs.pop_front();
+        continue;
+      }
+    }
+    job->work();
+  }
+}
+
+void ThreadPool::run(size_t count, const function<void(size_t)> &body)
+{
+  auto job = make_shared<Job>();
+  job->body = &body;
+  job->count = count;
+  {
+    lock_guard<mutex> guard(lock);
+    jobs.push_back(job);
+  }
+  wake.notify_all();
+
+  job->work();
+
+  // Tasks claimed by workers may still be running
+  {
+    unique_lock<mutex> guard(job->lock);
+    job->finished.wait(guard, [&] { return job->done == job->count; });
+  }
+  {
+    lock_guard<mutex> guard(lock);
+    auto it = find(jobs.begin(), jobs.end(), job);
+    if (it != jobs.end())
+    {
+      jobs.erase(it);
+    }
+  }
+
+  if (job->error)
+  {
+    rethrow_exception(job->error);
+  }
+}
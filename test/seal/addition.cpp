@@ -1,5 +1,6 @@
 #include <gtest/gtest.h> // NOLINT
 #include <aseal.h>       /* Microsoft SEAL */
+#include <parallel.h>    /* parallel_for */
 #include <map>
 #include <cstdint>
 
@@ -244,3 +245,113 @@ TEST(Add, VectorDouble) {
     EXPECT_NEAR(expect, decode_res_no_relin[i], 0.0000001);
   }
 }
+
+TEST(Add, VectorComplex) {
+
+  Aseal* fhe = new Aseal();
+
+  string ctx = fhe->ContextGen(scheme::ckks, 8192, pow(2.0, 40), -1, -1, {60, 40, 40, 60});
+  EXPECT_STREQ(ctx.c_str(), "success: valid");
+
+  fhe->KeyGen();
+
+  /**
+   * Two real vectors share one ciphertext, as real and imaginary parts.
+  */
+  const size_t n = 16;
+  vector<double> interleaved(2 * n);
+  for (size_t i = 0; i < n; i++)
+  {
+    interleaved[2 * i] = 0.5 * i;       // first vector
+    interleaved[2 * i + 1] = -0.25 * i; // second vector
+  }
+
+  AsealPlaintext pt_x, pt_add, pt_res;
+  fhe->encode_complex(reinterpret_cast<const complex<double>*>(interleaved.data()), n, pt_x);
+
+  vector<complex<double>> add(n, complex<double>(1.0, 2.0));
+  fhe->encode_complex(add, pt_add);
+
+  AsealCiphertext ct_x, ct_res;
+  fhe->encrypt(pt_x, ct_x);
+  fhe->add(ct_x, pt_add, ct_res);
+  fhe->decrypt(ct_res, pt_res);
+
+  // Decode into the same interleaved layout
+  vector<double> result(2 * fhe->slot_count());
+  size_t written = fhe->decode_complex(pt_res, reinterpret_cast<complex<double>*>(result.data()), fhe->slot_count());
+  EXPECT_EQ(written, fhe->slot_count());
+
+  for (size_t i = 0; i < n; i++)
+  {
+    EXPECT_NEAR(result[2 * i], 0.5 * i + 1.0, 1e-5);
+    EXPECT_NEAR(result[2 * i + 1], -0.25 * i + 2.0, 1e-5);
+  }
+
+  vector<complex<double>> decoded;
+  fhe->decode_complex(pt_res, decoded);
+  EXPECT_NEAR(decoded[1].real(), 1.5, 1e-5);
+  EXPECT_NEAR(decoded[1].imag(), 1.75, 1e-5);
+}
+
+TEST(Add, Many) {
+  Aseal* fhe = new Aseal();
+  string ctx = fhe->ContextGen(scheme::bfv, 8192, 20, -1, 128);
+  EXPECT_STREQ(ctx.c_str(), "success: valid");
+  fhe->KeyGen();
+
+  // x_i = [ i, 2i, 3i, 4i, 0, ... ]
+  const size_t count = 10;
+  vector<AsealCiphertext> cts(count);
+  vector<ACiphertext*> ptrs;
+  for (size_t i = 0; i < count; i++) {
+    vector<uint64_t> x = {i, 2 * i, 3 * i, 4 * i};
+    AsealPlaintext pt;
+    fhe->encode_int(x, pt);
+    fhe->encrypt(pt, cts[i]);
+    ptrs.push_back(&cts[i]);
+  }
+
+  // The sum may be stored in one of the inputs
+  fhe->add_many(ptrs.data(), count, cts[3]);
+
+  AsealPlaintext pt_res;
+  fhe->decrypt(cts[3], pt_res);
+  vector<uint64_t> result;
+  fhe->decode_int(pt_res, result);
+  for (uint64_t j = 0; j < 4; j++) {
+    EXPECT_EQ(result[j], 45 * (j + 1));
+  }
+
+  ASSERT_THROW(fhe->add_many(ptrs.data(), 0, cts[0]), invalid_argument);
+}
+
+TEST(Add, Concurrent) {
+  Aseal* fhe = new Aseal();
+  string ctx = fhe->ContextGen(scheme::bfv, 8192, 20, -1, 128);
+  EXPECT_STREQ(ctx.c_str(), "success: valid");
+  fhe->KeyGen();
+
+  const size_t count = 16;
+  vector<AsealCiphertext> cts(count), res(count);
+  for (size_t i = 0; i < count; i++) {
+    vector<uint64_t> x = {i, 1};
+    AsealPlaintext pt;
+    fhe->encode_int(x, pt);
+    fhe->encrypt(pt, cts[i]);
+  }
+
+  // The evaluator is shared, operations on one backend may run from many threads
+  parallel_for(count, [&](size_t i) {
+    fhe->add(cts[i], cts[count - 1 - i], res[i]);
+  });
+
+  for (size_t i = 0; i < count; i++) {
+    AsealPlaintext pt_res;
+    fhe->decrypt(res[i], pt_res);
+    vector<uint64_t> result;
+    fhe->decode_int(pt_res, result);
+    EXPECT_EQ(result[0], count - 1);
+    EXPECT_EQ(result[1], 2ULL);
+  }
+}
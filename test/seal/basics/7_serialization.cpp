@@ -173,10 +173,10 @@ TEST(Basics, Serialization)
              << server->save_parameters_size(/* defaults to 'none' */) << endl;
         cout << "             "
              << "EncryptionParameters: data size upper bound (compr_mod_type::zlib): "
-             << server->save_parameters_size("zlib") << endl;
+             << server->save_parameters_size(compr_mode::zlib) << endl;
         cout << "             "
              << "EncryptionParameters: data size upper bound (compr_mod_type::zstd): "
-             << server->save_parameters_size("zstd") << endl;
+             << server->save_parameters_size(compr_mode::zstd) << endl;
 
         /*
         As an example, we now serialize the encryption parameters to a fixed size
@@ -0,0 +1,56 @@
+#include <gtest/gtest.h> // NOLINT
+#include <aseal.h>       /* Microsoft SEAL */
+#include <chrono>        /* high_resolution_clock */
+#include <iomanip>       /* setw */
+#include <map>           /* map */
+
+using namespace std;
+
+/**
+ * @brief Average wall-clock time of an operation, in microseconds.
+ *
+ * @param op The operation to be measured.
+ * @param iterations The number of times to repeat the operation.
+ *
+ * The operation is run once before measuring, to warm up memory pools.
+*/
+template <typename F>
+inline double time_per_op_us(F &&op, int iterations = 10)
+{
+    op();
+    auto start = chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+        op();
+    }
+    auto end = chrono::high_resolution_clock::now();
+    return chrono::duration<double, micro>(end - start).count() / iterations;
+}
+
+/**
+ * @brief Print a single benchmark result
+*/
+inline void print_benchmark(const string &name, double us_per_op)
+{
+    ios old_fmt(nullptr);
+    old_fmt.copyfmt(cout);
+
+    cout << "| " << setw(48) << left << name << " | "
+         << setw(12) << right << fixed << setprecision(1) << us_per_op << " us/op |" << endl;
+
+    cout.copyfmt(old_fmt);
+}
+
+/**
+ * @brief Print the speedup of a candidate over a baseline
+*/
+inline void print_speedup(const string &name, double baseline_us, double candidate_us)
+{
+    ios old_fmt(nullptr);
+    old_fmt.copyfmt(cout);
+
+    cout << "| " << setw(48) << left << name << " | "
+         << setw(12) << right << fixed << setprecision(2) << baseline_us / candidate_us << " x     |" << endl;
+
+    cout.copyfmt(old_fmt);
+}
@@ -0,0 +1,63 @@
+#include "benchmark.h"
+
+/**
+ * @brief Compare per-operation cost of the default BFV/BGV coefficient modulus
+ *        against a tight chain, sized for a single multiplication.
+*/
+TEST(Benchmark, CoeffModulus)
+{
+    const uint64_t poly_modulus_degree = 8192;
+    const uint64_t plain_modulus_bit_size = 20;
+
+    map<string, vector<int>> chains = {
+        {"default (BFVDefault, 218 bits)", {}},
+        {"tight (50 + 50 + 50 bits)", {50, 50, 50}},
+    };
+
+    for (const auto& scheme : {scheme::bfv, scheme::bgv}) {
+        map<string, double> multiply_us;
+
+        for (const auto& chain : chains) {
+            Aseal* fhe = new Aseal();
+            string ctx = fhe->ContextGen(scheme, poly_modulus_degree, plain_modulus_bit_size, 0, 128, chain.second);
+            ASSERT_STREQ(ctx.c_str(), "success: valid");
+            fhe->KeyGen();
+            fhe->RelinKeyGen();
+
+            vector<uint64_t> x(fhe->slot_count(), 3ULL);
+            AsealPlaintext pt_x;
+            fhe->encode_int(x, pt_x);
+
+            AsealCiphertext ct_x, ct_y, ct_res;
+            fhe->encrypt(pt_x, ct_x);
+            fhe->encrypt(pt_x, ct_y);
+
+            cout << "/ " << (scheme == scheme::bfv ? "BFV" : "BGV") << ", " << chain.first << endl;
+
+            print_benchmark("encrypt", time_per_op_us([&]() {
+                fhe->encrypt(pt_x, ct_res);
+            }));
+            print_benchmark("add", time_per_op_us([&]() {
+                fhe->add(ct_x, ct_y, ct_res);
+            }));
+            double mul = time_per_op_us([&]() {
+                fhe->multiply(ct_x, ct_y, ct_res);
+                fhe->relinearize(ct_res);
+            });
+            print_benchmark("multiply + relinearize", mul);
+            multiply_us[chain.first] = mul;
+
+            // A tight chain must still decrypt a single multiplication correctly
+            EXPECT_GT(fhe->invariant_noise_budget(ct_res), 0);
+            AsealPlaintext pt_res;
+            vector<uint64_t> res;
+            fhe->decrypt(ct_res, pt_res);
+            fhe->decode_int(pt_res, res);
+            EXPECT_EQ(res[0], 9ULL);
+
+            delete fhe;
+        }
+        print_speedup("multiply + relinearize speedup (tight)",
+            multiply_us["default (BFVDefault, 218 bits)"], multiply_us["tight (50 + 50 + 50 bits)"]);
+    }
+}
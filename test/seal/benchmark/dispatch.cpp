@@ -0,0 +1,68 @@
+#include "benchmark.h"
+#include <fhe_typed.h> /* Typed interface */
+
+/**
+ * @brief Compare converting an abstract ciphertext with dynamic_cast
+ *        against the tagged cast used by the backend.
+*/
+TEST(Benchmark, TaggedCast)
+{
+    const int casts = 1000000;
+    AsealCiphertext ct;
+    ACiphertext* abstract = &ct;
+    volatile size_t sink = 0;
+
+    double dynamic_us = time_per_op_us([&]() {
+        for (int i = 0; i < casts; i++) {
+            sink = sink + reinterpret_cast<size_t>(&dynamic_cast<AsealCiphertext&>(*abstract));
+        }
+    });
+    double tagged_us = time_per_op_us([&]() {
+        for (int i = 0; i < casts; i++) {
+            sink = sink + reinterpret_cast<size_t>(&_to_ciphertext(*abstract));
+        }
+    });
+
+    string label = to_string(casts) + " casts";
+    print_benchmark(label + ", dynamic_cast", dynamic_us);
+    print_benchmark(label + ", tagged", tagged_us);
+    print_speedup(label + ", speedup", dynamic_us, tagged_us);
+}
+
+/**
+ * @brief Compare small additions through the Afhe interface
+ *        against the typed overloads, without the backend checks.
+*/
+TEST(Benchmark, TypedDispatch)
+{
+    const int ops = 10000;
+    Fhe<SealBackend> typed;
+    Aseal &backend = typed.backend();
+    string ctx = backend.ContextGen(scheme::bfv, 1024, 0, 256, 128);
+    ASSERT_STREQ(ctx.c_str(), "success: valid");
+    backend.KeyGen();
+
+    AsealPlaintext pt_x("1");
+    AsealCiphertext ct_x, ct_res;
+    backend.encrypt(pt_x, ct_x);
+    backend.add(ct_x, ct_x, ct_res);
+
+    cout << "/ BFV, n = 1024" << endl;
+
+    Afhe* fhe = &backend;
+    double virtual_us = time_per_op_us([&]() {
+        for (int i = 0; i < ops; i++) {
+            fhe->add(ct_x, ct_x, ct_res);
+        }
+    }, 3);
+    double typed_us = time_per_op_us([&]() {
+        for (int i = 0; i < ops; i++) {
+            typed.add(ct_x, ct_x, ct_res);
+        }
+    }, 3);
+
+    string label = to_string(ops) + " additions";
+    print_benchmark(label + ", Afhe", virtual_us);
+    print_benchmark(label + ", Fhe<SealBackend>", typed_us);
+    print_speedup(label + ", speedup", virtual_us, typed_us);
+}
@@ -0,0 +1,102 @@
+#include "benchmark.h"
+
+/**
+ * @brief Compare encrypting many plaintexts, one call per plaintext,
+ *        against a single encrypt_many call.
+*/
+TEST(Benchmark, EncryptMany)
+{
+    const vector<size_t> counts = {4, 16, 64};
+
+    for (const auto& scheme : {scheme::bfv, scheme::ckks}) {
+        Aseal* fhe = new Aseal();
+        string ctx = scheme == scheme::ckks
+            ? fhe->ContextGen(scheme, 8192, pow(2.0, 40), 0, 128, {60, 40, 40, 60})
+            : fhe->ContextGen(scheme, 8192, 20, 0, 128);
+        ASSERT_STREQ(ctx.c_str(), "success: valid");
+        fhe->KeyGen();
+
+        AsealPlaintext pt_x;
+        if (scheme == scheme::ckks) {
+            vector<double> x(fhe->slot_count(), 0.5);
+            fhe->encode_double(x.data(), x.size(), pt_x);
+        } else {
+            vector<uint64_t> x(fhe->slot_count(), 3ULL);
+            fhe->encode_int(x.data(), x.size(), pt_x);
+        }
+
+        cout << "/ " << (scheme == scheme::bfv ? "BFV" : "CKKS") << ", n = 8192" << endl;
+
+        for (size_t count : counts) {
+            vector<APlaintext*> pt_ptrs(count, &pt_x);
+            vector<AsealCiphertext> res(count);
+            vector<ACiphertext*> res_ptrs(count);
+            for (size_t i = 0; i < count; i++) {
+                res_ptrs[i] = &res[i];
+            }
+
+            double naive_us = time_per_op_us([&]() {
+                for (size_t i = 0; i < count; i++) {
+                    fhe->encrypt(pt_x, res[i]);
+                }
+            }, 3);
+            double many_us = time_per_op_us([&]() {
+                fhe->encrypt_many(pt_ptrs.data(), count, res_ptrs.data());
+            }, 3);
+
+            string label = to_string(count) + " encryptions";
+            print_benchmark(label + ", naive loop", naive_us);
+            print_benchmark(label + ", encrypt_many", many_us);
+            print_speedup(label + ", speedup", naive_us, many_us);
+        }
+        delete fhe;
+    }
+}
+
+/**
+ * @brief Compare encryption throughput with each PRNG,
+ *        one call per plaintext and with encrypt_many.
+*/
+TEST(Benchmark, EncryptPrng)
+{
+    const size_t count = 64;
+    const map<prng, string> names = {
+        {prng::default_prng, "default"},
+        {prng::blake2xb, "blake2xb"},
+        {prng::shake256, "shake256"},
+    };
+
+    cout << "/ BFV, n = 8192, " << count << " encryptions" << endl;
+
+    for (const auto& it : names) {
+        Aseal* fhe = new Aseal();
+        fhe->set_prng(it.first);
+        string ctx = fhe->ContextGen(scheme::bfv, 8192, 20, 0, 128);
+        ASSERT_STREQ(ctx.c_str(), "success: valid");
+        fhe->KeyGen();
+
+        AsealPlaintext pt_x;
+        vector<uint64_t> x(fhe->slot_count(), 3ULL);
+        fhe->encode_int(x.data(), x.size(), pt_x);
+
+        vector<APlaintext*> pt_ptrs(count, &pt_x);
+        vector<AsealCiphertext> res(count);
+        vector<ACiphertext*> res_ptrs(count);
+        for (size_t i = 0; i < count; i++) {
+            res_ptrs[i] = &res[i];
+        }
+
+        double naive_us = time_per_op_us([&]() {
+            for (size_t i = 0; i < count; i++) {
+                fhe->encrypt(pt_x, res[i]);
+            }
+        }, 3);
+        double many_us = time_per_op_us([&]() {
+            fhe->encrypt_many(pt_ptrs.data(), count, res_ptrs.data());
+        }, 3);
+
+        print_benchmark(it.second + ", naive loop", naive_us);
+        print_benchmark(it.second + ", encrypt_many", many_us);
+        delete fhe;
+    }
+}
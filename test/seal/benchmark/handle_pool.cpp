@@ -0,0 +1,39 @@
+#include "benchmark.h"
+#include <fhe.h> /* C API */
+
+/**
+ * @brief Compare small additions through the C API, each result released,
+ *        with and without recycling the ciphertexts.
+*/
+TEST(Benchmark, HandlePool)
+{
+    const int ops = 10000;
+    Afhe* fhe = init_backend(fhe_backend_t::seal_b);
+    string ctx = fhe->ContextGen(scheme::bfv, 1024, 0, 256, 128);
+    ASSERT_STREQ(ctx.c_str(), "success: valid");
+    fhe->KeyGen();
+
+    uint64_t x[1] = {1ULL};
+    ACiphertext* ct_x = encrypt_ints(fhe, x, 1);
+
+    cout << "/ BFV, n = 1024" << endl;
+
+    auto add_and_release = [&]() {
+        for (int i = 0; i < ops; i++) {
+            delete_ciphertext(fhe, add(fhe, ct_x, ct_x));
+        }
+    };
+
+    set_pool_capacity(fhe, 0);
+    double new_us = time_per_op_us(add_and_release, 3);
+    set_pool_capacity(fhe, 64);
+    double pool_us = time_per_op_us(add_and_release, 3);
+
+    string label = to_string(ops) + " additions";
+    print_benchmark(label + ", new and delete", new_us);
+    print_benchmark(label + ", pooled", pool_us);
+    print_speedup(label + ", speedup", new_us, pool_us);
+
+    delete_ciphertext(fhe, ct_x);
+    delete fhe;
+}
@@ -0,0 +1,59 @@
+#include "benchmark.h"
+
+/**
+ * @brief Compare rotating one ciphertext by many steps, one call per step,
+ *        against a single rotate_batch call, the same rotations run in parallel.
+*/
+TEST(Benchmark, RotateBatch)
+{
+    const vector<size_t> counts = {4, 16, 32};
+
+    for (const auto& scheme : {scheme::bfv, scheme::ckks}) {
+        Aseal* fhe = new Aseal();
+        string ctx = scheme == scheme::ckks
+            ? fhe->ContextGen(scheme, 8192, pow(2.0, 40), 0, 128, {60, 40, 40, 60})
+            : fhe->ContextGen(scheme, 8192, 20, 0, 128);
+        ASSERT_STREQ(ctx.c_str(), "success: valid");
+        fhe->KeyGen();
+
+        vector<int> all_steps;
+        for (int i = 1; i <= 32; i++) {
+            all_steps.push_back(i);
+        }
+        fhe->GaloisKeyGen(all_steps);
+
+        AsealCiphertext ct_x;
+        if (scheme == scheme::ckks) {
+            vector<double> x(fhe->slot_count(), 0.5);
+            fhe->encrypt_double(x.data(), x.size(), ct_x);
+        } else {
+            vector<uint64_t> x(fhe->slot_count(), 3ULL);
+            fhe->encrypt_int(x.data(), x.size(), ct_x);
+        }
+
+        cout << "/ " << (scheme == scheme::bfv ? "BFV" : "CKKS") << ", n = 8192" << endl;
+
+        for (size_t count : counts) {
+            vector<int> steps(all_steps.begin(), all_steps.begin() + count);
+            vector<AsealCiphertext> res(count);
+            vector<ACiphertext*> res_ptrs(count);
+            for (size_t i = 0; i < count; i++) {
+                res_ptrs[i] = &res[i];
+            }
+
+            double naive_us = time_per_op_us([&]() {
+                for (size_t i = 0; i < count; i++) {
+                    fhe->rotate(ct_x, steps[i], res[i]);
+                }
+            }, 3);
+            double batch_us = time_per_op_us([&]() {
+                fhe->rotate_batch(ct_x, steps.data(), count, res_ptrs.data());
+            }, 3);
+
+            string label = to_string(count) + " rotations";
+            print_benchmark(label + ", naive loop", naive_us);
+            print_benchmark(label + ", rotate_batch", batch_us);
+            print_speedup(label + ", speedup", naive_us, batch_us);
+        }
+    }
+}
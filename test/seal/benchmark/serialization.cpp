@@ -0,0 +1,73 @@
+#include "benchmark.h"
+#include <cstring> /* memcpy */
+#include <sstream> /* stringstream */
+
+/**
+ * @brief Compare saving and loading a ciphertext through a stream, as
+ *        before, against the string and in-place interfaces.
+ *
+ * A copy of the serialized buffer is measured as a reference; the string
+ * interfaces should stay within a copy of the in-place ones.
+*/
+TEST(Benchmark, Serialization)
+{
+    Aseal* fhe = new Aseal();
+    string ctx = fhe->ContextGen(scheme::bfv, 16384, 20, 0, 128);
+    ASSERT_STREQ(ctx.c_str(), "success: valid");
+    fhe->KeyGen();
+
+    vector<uint64_t> x(fhe->slot_count(), 3ULL);
+    AsealPlaintext pt_x;
+    fhe->encode_int(x.data(), x.size(), pt_x);
+    AsealCiphertext ct;
+    fhe->encrypt(pt_x, ct);
+
+    const seal::Ciphertext &seal_ct = ct;
+    int size = ct.save_size();
+    vector<byte> buffer(size);
+    string data = ct.save();
+    EXPECT_EQ(data.size(), static_cast<size_t>(size));
+    AsealCiphertext loaded;
+
+    cout << "/ BFV, n = 16384, " << size / 1024 << " KiB" << endl;
+
+    vector<byte> copy(size);
+    double copy_us = time_per_op_us([&]() {
+        memcpy(copy.data(), buffer.data(), size);
+    });
+
+    double stream_save_us = time_per_op_us([&]() {
+        ostringstream stream;
+        seal_ct.save(stream, seal::compr_mode_type::none);
+        data = stream.str();
+    });
+    double save_us = time_per_op_us([&]() {
+        data = ct.save();
+    });
+    double inplace_save_us = time_per_op_us([&]() {
+        ct.save_inplace(buffer.data(), size);
+    });
+
+    double stream_load_us = time_per_op_us([&]() {
+        istringstream stream(data);
+        static_cast<seal::Ciphertext&>(loaded).load(_to_context(fhe->get_context()), stream);
+    });
+    double load_us = time_per_op_us([&]() {
+        loaded.load(fhe, data);
+    });
+    double inplace_load_us = time_per_op_us([&]() {
+        loaded.load_inplace(fhe, buffer.data(), size);
+    });
+    EXPECT_EQ(loaded.size(), ct.size());
+
+    print_benchmark("buffer copy", copy_us);
+    print_benchmark("save, stream", stream_save_us);
+    print_benchmark("save, string", save_us);
+    print_benchmark("save, in place", inplace_save_us);
+    print_speedup("save, string over stream", stream_save_us, save_us);
+    print_benchmark("load, stream", stream_load_us);
+    print_benchmark("load, string", load_us);
+    print_benchmark("load, in place", inplace_load_us);
+    print_speedup("load, string over stream", stream_load_us, load_us);
+    delete fhe;
+}
@@ -37,6 +37,57 @@ TEST(BGV_BFV, InvalidPolyModulusDegree) {
   }
 }
 
+TEST(BGV_BFV, CustomCoeffModulus) {
+  Aseal* fhe = new Aseal();
+
+  for (const auto& scheme : {scheme::bgv, scheme::bfv}) {
+
+    // Tight chain for shallow circuits, instead of BFVDefault(8192)
+    string ctx = fhe->ContextGen(scheme, 8192, 20, 0, 128, {50, 50, 50});
+
+    EXPECT_STREQ(ctx.c_str(), "success: valid");
+  }
+}
+
+TEST(BGV_BFV, InsecureCoeffModulus) {
+  Aseal* fhe = new Aseal();
+
+  for (const auto& scheme : {scheme::bgv, scheme::bfv}) {
+
+    // poly_modulus_degree = 4096, => max coeff_modulus bit-length = 109
+    string ctx = fhe->ContextGen(scheme, 4096, 20, 0, 128, {60, 60});
+
+    EXPECT_STREQ(ctx.c_str(), "invalid_argument: coeff_modulus bit count (120) exceeds the maximum (109) for the security level");
+  }
+}
+
+TEST(BGV_BFV, PrngSelection) {
+  for (const auto& type : {prng::default_prng, prng::blake2xb, prng::shake256}) {
+    Aseal* fhe = new Aseal();
+
+    // Selected before the context, used by key generation and encryption
+    fhe->set_prng(type);
+    EXPECT_EQ(fhe->get_prng(), type);
+    string ctx = fhe->ContextGen(scheme::bfv, 8192, 20, 0, 128);
+    EXPECT_STREQ(ctx.c_str(), "success: valid");
+    fhe->KeyGen();
+
+    uint64_t x[3] = {1ULL, 2ULL, 3ULL};
+    AsealCiphertext ct_x;
+    fhe->encrypt_int(x, 3, ct_x);
+
+    uint64_t decode_x[3] = {0ULL};
+    EXPECT_EQ(fhe->decrypt_int(ct_x, decode_x, 3), 3);
+    for (int i = 0; i < 3; i++) {
+      EXPECT_EQ(x[i], decode_x[i]);
+    }
+    delete fhe;
+  }
+
+  Aseal* fhe = new Aseal();
+  EXPECT_THROW(fhe->set_prng(static_cast<prng>(7)), invalid_argument);
+}
+
 // TEST(BFV, InvalidSecurityLevel) {
 //   Aseal* fhe = new Aseal();
 
@@ -159,4 +159,206 @@ TEST(Encrypt, EncryptVectorInteger) {
       }
     }
   }
-}
\ No newline at end of file
+}
+TEST(Encrypt, DecodeIntoArray) {
+  Aseal* fhe = new Aseal();
+
+  // Integer slots, encoded from and decoded into raw arrays
+  string ctx = fhe->ContextGen(scheme::bfv, 8192, 20, -1, 128);
+  EXPECT_STREQ(ctx.c_str(), "success: valid");
+  fhe->KeyGen();
+
+  uint64_t x[4] = {1ULL, 2ULL, 3ULL, 4ULL};
+  AsealPlaintext pt_x;
+  fhe->encode_int(x, 4, pt_x);
+
+  AsealCiphertext ct_x;
+  AsealPlaintext decrypt_x;
+  fhe->encrypt(pt_x, ct_x);
+  fhe->decrypt(ct_x, decrypt_x);
+
+  // Destination shorter than the slot count is truncated
+  uint64_t decode_x[4] = {0ULL};
+  EXPECT_EQ(fhe->decode_int(decrypt_x, decode_x, 4), 4);
+  for (int i = 0; i < 4; i++) {
+    EXPECT_EQ(x[i], decode_x[i]);
+  }
+
+  // Destination holding every slot is written in place
+  vector<uint64_t> all_slots(fhe->slot_count(), 7ULL);
+  EXPECT_EQ(fhe->decode_int(decrypt_x, all_slots.data(), all_slots.size()), all_slots.size());
+  EXPECT_EQ(all_slots[3], 4ULL);
+  EXPECT_EQ(all_slots[4], 0ULL);
+
+  // Floating point slots
+  ctx = fhe->ContextGen(scheme::ckks, 8192, pow(2.0, 40), 0, 128, {60, 40, 40, 60});
+  EXPECT_STREQ(ctx.c_str(), "success: valid");
+  fhe->KeyGen();
+
+  double y[3] = {0.5, 1.25, -2.0};
+  AsealPlaintext pt_y, decrypt_y;
+  AsealCiphertext ct_y;
+  fhe->encode_double(y, 3, pt_y);
+  fhe->encrypt(pt_y, ct_y);
+  fhe->decrypt(ct_y, decrypt_y);
+
+  double decode_y[3] = {0.0};
+  EXPECT_EQ(fhe->decode_double(decrypt_y, decode_y, 3), 3);
+  for (int i = 0; i < 3; i++) {
+    EXPECT_NEAR(y[i], decode_y[i], 1e-5);
+  }
+}
+
+TEST(Encrypt, FusedEncryptDecrypt) {
+  Aseal* fhe = new Aseal();
+
+  string ctx = fhe->ContextGen(scheme::bfv, 8192, 20, -1, 128);
+  EXPECT_STREQ(ctx.c_str(), "success: valid");
+  fhe->KeyGen();
+
+  // Single ciphertext, no plaintext exposed to the caller
+  uint64_t x[4] = {1ULL, 2ULL, 3ULL, 4ULL};
+  AsealCiphertext ct_x;
+  fhe->encrypt_int(x, 4, ct_x);
+
+  uint64_t decode_x[4] = {0ULL};
+  EXPECT_EQ(fhe->decrypt_int(ct_x, decode_x, 4), 4);
+  for (int i = 0; i < 4; i++) {
+    EXPECT_EQ(x[i], decode_x[i]);
+  }
+
+  // Batch of rows, one ciphertext each
+  const size_t rows = 3, len = 4;
+  vector<uint64_t> data(rows * len);
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = i;
+  }
+  AsealCiphertext cts[rows];
+  ACiphertext* ct_ptrs[rows] = {&cts[0], &cts[1], &cts[2]};
+  fhe->encrypt_int_batch(data.data(), len, rows, ct_ptrs);
+
+  vector<uint64_t> result(rows * len, 0ULL);
+  EXPECT_EQ(fhe->decrypt_int_batch(ct_ptrs, rows, result.data(), len), len);
+  for (size_t i = 0; i < data.size(); i++) {
+    EXPECT_EQ(data[i], result[i]);
+  }
+
+  // Scratch plaintext is reused across schemes on the same thread
+  ctx = fhe->ContextGen(scheme::ckks, 8192, pow(2.0, 40), 0, 128, {60, 40, 40, 60});
+  EXPECT_STREQ(ctx.c_str(), "success: valid");
+  fhe->KeyGen();
+
+  double y[3] = {0.5, 1.25, -2.0};
+  AsealCiphertext ct_y;
+  fhe->encrypt_double(y, 3, ct_y);
+
+  double decode_y[3] = {0.0};
+  EXPECT_EQ(fhe->decrypt_double(ct_y, decode_y, 3), 3);
+  for (int i = 0; i < 3; i++) {
+    EXPECT_NEAR(y[i], decode_y[i], 1e-5);
+  }
+}
+
+TEST(Encrypt, EncryptMany) {
+  Aseal* fhe = new Aseal();
+
+  string ctx = fhe->ContextGen(scheme::bgv, 8192, 20, -1, 128);
+  EXPECT_STREQ(ctx.c_str(), "success: valid");
+
+  // The encryptor is built with the public key
+  AsealPlaintext pt_x;
+  AsealCiphertext ct_x;
+  EXPECT_THROW(fhe->encrypt(pt_x, ct_x), logic_error);
+
+  fhe->KeyGen();
+
+  const size_t count = 16;
+  vector<AsealPlaintext> pts(count);
+  vector<AsealCiphertext> cts(count);
+  vector<APlaintext*> pt_ptrs(count);
+  vector<ACiphertext*> ct_ptrs(count);
+  for (size_t i = 0; i < count; i++) {
+    uint64_t x[2] = {i, 2 * i};
+    fhe->encode_int(x, 2, pts[i]);
+    pt_ptrs[i] = &pts[i];
+    ct_ptrs[i] = &cts[i];
+  }
+  fhe->encrypt_many(pt_ptrs.data(), count, ct_ptrs.data());
+
+  for (size_t i = 0; i < count; i++) {
+    uint64_t decode_x[2] = {0ULL};
+    EXPECT_EQ(fhe->decrypt_int(cts[i], decode_x, 2), 2);
+    EXPECT_EQ(decode_x[0], i);
+    EXPECT_EQ(decode_x[1], 2 * i);
+  }
+
+  // Fresh randomness for each encryption of the same plaintext
+  vector<APlaintext*> same(2, &pts[1]);
+  fhe->encrypt_many(same.data(), 2, ct_ptrs.data());
+  EXPECT_NE(cts[0][0], cts[1][0]);
+}
+
+TEST(Encrypt, EstimateNoiseBudget) {
+  for (const auto& scheme : {scheme::bgv, scheme::bfv}) {
+    Aseal* fhe = new Aseal();
+    string ctx = fhe->ContextGen(scheme, 8192, 20, -1, 128);
+    EXPECT_STREQ(ctx.c_str(), "success: valid");
+    fhe->KeyGen();
+    fhe->RelinKeyGen();
+
+    vector<uint64_t> x = {1, 2, 3, 4};
+    AsealPlaintext pt;
+    fhe->encode_int(x, pt);
+    AsealCiphertext ct, ct_res;
+    fhe->encrypt(pt, ct);
+
+    // The estimate never exceeds the budget measured with the secret key
+    int fresh = fhe->estimate_noise_budget(ct);
+    EXPECT_GT(fresh, 0);
+    EXPECT_LE(fresh, fhe->invariant_noise_budget(ct));
+
+    fhe->multiply(ct, ct, ct_res);
+    fhe->relinearize(ct_res);
+    int product = fhe->estimate_noise_budget(ct_res);
+    EXPECT_GT(product, 0);
+    EXPECT_LT(product, fresh);
+    EXPECT_LE(product, fhe->invariant_noise_budget(ct_res));
+
+    fhe->add(ct_res, ct, ct_res);
+    fhe->mod_switch_to_next(ct_res);
+    EXPECT_LE(fhe->estimate_noise_budget(ct_res), fhe->invariant_noise_budget(ct_res));
+
+    // Encrypting again resets the tracked noise
+    fhe->encrypt(pt, ct_res);
+    EXPECT_EQ(fhe->estimate_noise_budget(ct_res), fresh);
+
+    // A loaded ciphertext has no history, nor do results computed from it
+    AsealCiphertext loaded;
+    loaded.load(fhe, ct_res.save());
+    EXPECT_EQ(fhe->estimate_noise_budget(loaded), -1);
+    fhe->add(loaded, ct, ct_res);
+    EXPECT_EQ(fhe->estimate_noise_budget(ct_res), -1);
+  }
+
+  // CKKS estimates the bits of precision left
+  Aseal* fhe = new Aseal();
+  string ctx = fhe->ContextGen(scheme::ckks, 8192, pow(2.0, 40), -1, -1, {60, 40, 40, 60});
+  EXPECT_STREQ(ctx.c_str(), "success: valid");
+  fhe->KeyGen();
+  fhe->RelinKeyGen();
+
+  vector<double> x = {0.5, -0.25};
+  AsealPlaintext pt;
+  fhe->encode_double(x, pt);
+  AsealCiphertext ct, ct_res;
+  fhe->encrypt(pt, ct);
+  int fresh = fhe->estimate_noise_budget(ct);
+  EXPECT_GT(fresh, 20);
+
+  fhe->multiply(ct, ct, ct_res);
+  fhe->relinearize(ct_res);
+  fhe->rescale_to_next(ct_res);
+  int product = fhe->estimate_noise_budget(ct_res);
+  EXPECT_GT(product, 16);
+  EXPECT_LE(product, fresh);
+}
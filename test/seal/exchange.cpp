@@ -53,7 +53,7 @@ TEST(Exchange, Ciphertext)
     host->encrypt(four, ctxt_four);
 
     // Save the ciphertext
-    string cipher_out = ctxt_four.save("none");
+    string cipher_out = ctxt_four.save(compr_mode::no_compression);
 
     // Initialize the guest
     // Note: the parameters are not passed to the guest
@@ -73,3 +73,162 @@ TEST(Exchange, Ciphertext)
     guest->decrypt(ctxt_four_guest, four_guest);
     EXPECT_EQ(four_guest.to_string(), "4");
 }
+
+TEST(Exchange, CompactCiphertext)
+{
+    for (const auto& scheme : {scheme::bgv, scheme::bfv}) {
+        Aseal* fhe = new Aseal();
+        string ctx = fhe->ContextGen(scheme, 8192, 20, -1, 128);
+        EXPECT_STREQ(ctx.c_str(), "success: valid");
+        fhe->KeyGen();
+
+        vector<uint64_t> x = {1, 2, 3, 4};
+        AsealPlaintext pt;
+        fhe->encode_int(x, pt);
+        AsealCiphertext ct;
+        fhe->encrypt(pt, ct);
+        int full_size = ct.save_size(compr_mode::no_compression);
+
+        // A fresh ciphertext only needs the last prime
+        EXPECT_GT(fhe->compact_for_transfer(ct), 0);
+        EXPECT_LT(ct.save_size(compr_mode::no_compression), full_size);
+        EXPECT_GE(fhe->estimate_noise_budget(ct), 1);
+        EXPECT_GT(fhe->invariant_noise_budget(ct), 0);
+
+        // Nothing left to drop
+        EXPECT_EQ(fhe->compact_for_transfer(ct), 0);
+
+        AsealPlaintext pt_res;
+        fhe->decrypt(ct, pt_res);
+        vector<uint64_t> result;
+        fhe->decode_int(pt_res, result);
+        for (size_t i = 0; i < x.size(); i++) {
+            EXPECT_EQ(result[i], x[i]);
+        }
+
+        // An evaluated ciphertext loses its noise estimate when saved, and is left as is
+        AsealCiphertext product, loaded;
+        fhe->encrypt(pt, ct);
+        fhe->multiply(ct, ct, product);
+        loaded.load(fhe, product.save());
+        int levels = fhe->level(loaded);
+        EXPECT_THROW(fhe->compact_for_transfer(loaded), invalid_argument);
+        EXPECT_EQ(fhe->level(loaded), levels);
+
+        fhe->decrypt(loaded, pt_res);
+        fhe->decode_int(pt_res, result);
+        for (size_t i = 0; i < x.size(); i++) {
+            EXPECT_EQ(result[i], x[i] * x[i]);
+        }
+    }
+
+    // CKKS keeps room above the scale
+    Aseal* fhe = new Aseal();
+    string ctx = fhe->ContextGen(scheme::ckks, 8192, pow(2.0, 40), -1, -1, {60, 40, 40, 60});
+    EXPECT_STREQ(ctx.c_str(), "success: valid");
+    fhe->KeyGen();
+
+    vector<double> x = {1.5, -2.25};
+    AsealPlaintext pt;
+    fhe->encode_double(x, pt);
+    AsealCiphertext ct;
+    fhe->encrypt(pt, ct);
+    int full_size = ct.save_size(compr_mode::no_compression);
+
+    EXPECT_EQ(fhe->compact_for_transfer(ct, 10), 2);
+    EXPECT_LT(ct.save_size(compr_mode::no_compression), full_size);
+
+    AsealPlaintext pt_res;
+    fhe->decrypt(ct, pt_res);
+    vector<double> result;
+    fhe->decode_double(pt_res, result);
+    EXPECT_NEAR(result[0], 1.5, 1e-5);
+    EXPECT_NEAR(result[1], -2.25, 1e-5);
+}
+
+TEST(Exchange, SetKeys)
+{
+    Aseal* host = new Aseal();
+    string h_ctx = host->ContextGen(scheme::bfv, 8192, 20, 0, 128);
+    EXPECT_STREQ(h_ctx.c_str(), "success: valid");
+    host->KeyGen();
+    host->RelinKeyGen();
+
+    string h_params = host->save_parameters();
+    string h_pub_key = host->get_public_key().save();
+    string h_relin_keys = host->get_relin_keys().save();
+
+    // Guest installs stored keys, without KeyGen()
+    Aseal* guest = new Aseal();
+    string g_ctx = guest->ContextGen(h_params);
+    EXPECT_STREQ(g_ctx.c_str(), "success: valid");
+
+    AsealPublicKey pk;
+    pk.load_inplace(guest, reinterpret_cast<const byte*>(h_pub_key.data()), h_pub_key.size());
+    guest->set_public_key(pk);
+
+    // Trusted keys skip validation
+    AsealRelinKey rk;
+    rk.load_inplace(guest, reinterpret_cast<const byte*>(h_relin_keys.data()), h_relin_keys.size(), true);
+    guest->set_relin_keys(rk);
+
+    // Keys of another type are rejected, not installed
+    AsealRelinKey wrong;
+    wrong.load_inplace(guest, reinterpret_cast<const byte*>(h_relin_keys.data()), h_relin_keys.size());
+    ASSERT_THROW(guest->set_public_key(wrong), bad_cast);
+    ASSERT_THROW(guest->set_secret_key(wrong), bad_cast);
+
+    // Guest encrypts and evaluates, host decrypts
+    vector<uint64_t> x = {1, 2, 3, 4};
+    AsealPlaintext pt;
+    guest->encode_int(x, pt);
+    AsealCiphertext ct, ct_sq;
+    guest->encrypt(pt, ct);
+    guest->multiply(ct, ct, ct_sq);
+    guest->relinearize(ct_sq);
+    EXPECT_EQ(ct_sq.size(), 2);
+
+    AsealPlaintext pt_res;
+    host->decrypt(ct_sq, pt_res);
+    vector<uint64_t> result;
+    host->decode_int(pt_res, result);
+    for (uint64_t i = 0; i < 4; i++) {
+        EXPECT_EQ(result[i], (i + 1) * (i + 1));
+    }
+}
+
+TEST(Exchange, CompressionModes)
+{
+    Aseal* host = new Aseal();
+    string h_ctx = host->ContextGen(scheme::bfv, 4096, 20, -1, 128);
+    EXPECT_STREQ(h_ctx.c_str(), "success: valid");
+    host->KeyGen();
+
+    AsealPlaintext pt("1x^1 + 2");
+    AsealCiphertext ct;
+    host->encrypt(pt, ct);
+
+    for (auto mode : {compr_mode::no_compression, compr_mode::zlib, compr_mode::zstd}) {
+        // Modes not enabled in SEAL are rejected
+        try {
+            string data = ct.save(mode);
+            EXPECT_LE(data.size(), static_cast<size_t>(ct.save_size(mode)));
+            EXPECT_GT(host->save_parameters_size(mode), 0);
+
+            Aseal* guest = new Aseal();
+            string g_ctx = guest->ContextGen(host->save_parameters(mode));
+            EXPECT_STREQ(g_ctx.c_str(), "success: valid");
+            AsealCiphertext loaded;
+            loaded.load(guest, data);
+            EXPECT_EQ(loaded.size(), ct.size());
+            delete guest;
+        }
+        catch (invalid_argument &e) {
+            EXPECT_NE(mode, compr_mode::no_compression);
+            EXPECT_STREQ(e.what(), "Unsupported Compression Mode");
+        }
+    }
+
+    EXPECT_THROW(ct.save_size(static_cast<compr_mode>(7)), invalid_argument);
+    delete host;
+}
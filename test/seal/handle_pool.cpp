@@ -0,0 +1,74 @@
+#include <gtest/gtest.h> // NOLINT
+#include <fhe.h>         /* C API */
+
+TEST(HandlePool, Recycle) {
+  HandlePool<AsealCiphertext> pool(2);
+  AsealCiphertext* a = pool.acquire();
+  AsealCiphertext* b = pool.acquire();
+  AsealCiphertext* c = pool.acquire();
+  EXPECT_EQ(pool.size(), 0);
+
+  // The third is deleted, past the capacity
+  pool.release(a);
+  pool.release(b);
+  pool.release(c);
+  EXPECT_EQ(pool.size(), 2);
+
+  // Most recently released first
+  EXPECT_EQ(pool.acquire(), b);
+  EXPECT_EQ(pool.size(), 1);
+  pool.release(b);
+
+  pool.set_capacity(0);
+  EXPECT_EQ(pool.size(), 0);
+  AsealCiphertext* d = pool.acquire();
+  pool.release(d);
+  EXPECT_EQ(pool.size(), 0);
+}
+
+TEST(HandlePool, CApi) {
+  clear_error();
+  Afhe* fhe = init_backend(fhe_backend_t::seal_b);
+  string ctx = fhe->ContextGen(scheme::bfv, 4096, 20, -1, 128);
+  EXPECT_STREQ(ctx.c_str(), "success: valid");
+  fhe->KeyGen();
+
+  uint64_t x[2] = {3ULL, 5ULL};
+  ACiphertext* ct_x = encrypt_ints(fhe, x, 2);
+  ACiphertext* ct_sum = add(fhe, ct_x, ct_x);
+  ASSERT_EQ(check_for_error(), nullptr);
+
+  // A released result is recycled, with its data buffer, by the next one
+  delete_ciphertext(fhe, ct_sum);
+  ACiphertext* ct_again = add(fhe, ct_x, ct_x);
+  EXPECT_EQ(ct_again, ct_sum);
+
+  APlaintext* pt = decrypt(fhe, ct_again);
+  uint64_t result[2] = {0ULL};
+  EXPECT_EQ(fhe->decode_int(*pt, result, 2), 2);
+  EXPECT_EQ(result[0], 6);
+  EXPECT_EQ(result[1], 10);
+
+  // Released plaintexts are cleared, they may hold decrypted values
+  delete_plaintext(fhe, pt);
+  EXPECT_TRUE(static_cast<AsealPlaintext*>(pt)->is_zero());
+  EXPECT_EQ(fhe->acquire_plaintext(), pt);
+  delete pt;
+
+  // Disabled, released objects are deleted
+  EXPECT_EQ(set_pool_capacity(fhe, 0), 0);
+  EXPECT_EQ(set_pool_capacity(fhe, -1), -1);
+  EXPECT_STREQ(check_for_error(), "Pool capacity must not be negative");
+  clear_error();
+
+  // Objects of another backend are rejected
+  ct_x->backend_lib = backend::no_backend;
+  delete_ciphertext(fhe, ct_x);
+  EXPECT_STREQ(check_for_error(), "Ciphertext does not belong to the SEAL backend");
+  clear_error();
+
+  ct_x->backend_lib = backend::seal_backend;
+  delete_ciphertext(fhe, ct_x);
+  delete_ciphertext(fhe, ct_again);
+  delete fhe;
+}
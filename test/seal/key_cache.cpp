@@ -0,0 +1,156 @@
+#include <gtest/gtest.h> // NOLINT
+#include <aseal.h>       /* Microsoft SEAL */
+#include <key_cache.h>   /* Key Cache */
+#include <fingerprint.h> /* XXH64 */
+#include <cstdlib>       /* mkdtemp */
+#include <unistd.h>      /* rmdir */
+#include <sys/stat.h>    /* stat */
+#include <cstdio>        /* snprintf */
+
+static AKey* make_seal_key(key type)
+{
+  switch (type)
+  {
+  case key::public_key: return new AsealPublicKey();
+  case key::secret_key: return new AsealSecretKey();
+  case key::relin_keys: return new AsealRelinKey();
+  case key::galois_keys: return new AsealGaloisKey();
+  default: return nullptr;
+  }
+}
+
+static const byte* bytes(const string &s)
+{
+  return reinterpret_cast<const byte*>(s.data());
+}
+
+TEST(KeyCache, Fingerprint) {
+  // Reference values of XXH64, seed 0
+  EXPECT_EQ(fingerprint("", 0), 0xEF46DB3751D8E999ULL);
+  EXPECT_EQ(fingerprint("abc", 3), 0x44BC2CF5AD770999ULL);
+  string s = "Nobody inspects the spammish repetition";
+  EXPECT_EQ(fingerprint(s.data(), s.size()), 0xFBCEA83C8A378BF1ULL);
+}
+
+TEST(KeyCache, LoadAndAttach) {
+  Aseal* host = new Aseal();
+  string ctx = host->ContextGen(scheme::bfv, 8192, 20, 0, 128);
+  EXPECT_STREQ(ctx.c_str(), "success: valid");
+  host->KeyGen();
+  host->RelinKeyGen();
+  string params = host->save_parameters();
+  string relin_keys = host->get_relin_keys().save();
+
+  KeyCache cache(64 << 20);
+  uint64_t id = 0, id_again = 0;
+
+  // Two backends of the same tenant share a single deserialized key
+  Aseal* first = new Aseal();
+  first->ContextGen(params);
+  shared_ptr<AKey> rk = cache.load(first, key::relin_keys, bytes(relin_keys), relin_keys.size(),
+                                   false, make_seal_key, id);
+  first->share_key(key::relin_keys, rk);
+
+  Aseal* second = new Aseal();
+  second->ContextGen(params);
+  shared_ptr<AKey> rk_again = cache.load(second, key::relin_keys, bytes(relin_keys), relin_keys.size(),
+                                         false, make_seal_key, id_again);
+  EXPECT_EQ(id, id_again);
+  EXPECT_EQ(rk.get(), rk_again.get());
+  EXPECT_EQ(cache.count(), 1);
+  EXPECT_EQ(cache.memory_size(), relin_keys.size());
+
+  key type = key::no_key;
+  EXPECT_EQ(cache.find(second, id, make_seal_key, type).get(), rk.get());
+  EXPECT_EQ(type, key::relin_keys);
+  EXPECT_EQ(cache.find(second, id + 1, make_seal_key, type), nullptr);
+
+  // Secret keys are never cached
+  string secret_key = host->get_secret_key().save();
+  ASSERT_THROW(cache.load(first, key::secret_key, bytes(secret_key), secret_key.size(),
+                          false, make_seal_key, id_again), invalid_argument);
+  EXPECT_EQ(cache.count(), 1);
+
+  // A hit is verified, not only matched by cache id
+  ASSERT_THROW(cache.load(first, key::galois_keys, bytes(relin_keys), relin_keys.size(),
+                          false, make_seal_key, id_again), invalid_argument);
+  EXPECT_EQ(cache.count(), 1);
+
+  // Key type must match
+  ASSERT_THROW(second->share_key(key::galois_keys, rk), invalid_argument);
+
+  // Attached key is used to relinearize
+  second->share_key(key::relin_keys, rk);
+  vector<uint64_t> x = {1, 2, 3};
+  AsealPlaintext pt;
+  host->encode_int(x, pt);
+  AsealCiphertext ct, ct_sq;
+  host->encrypt(pt, ct);
+  second->multiply(ct, ct, ct_sq);
+  second->relinearize(ct_sq);
+  EXPECT_EQ(ct_sq.size(), 2);
+
+  AsealPlaintext pt_res;
+  host->decrypt(ct_sq, pt_res);
+  vector<uint64_t> result;
+  host->decode_int(pt_res, result);
+  EXPECT_EQ(result[2], 9);
+}
+
+TEST(KeyCache, EvictAndSpill) {
+  Aseal* fhe = new Aseal();
+  string ctx = fhe->ContextGen(scheme::bfv, 4096, 20, 0, 128);
+  EXPECT_STREQ(ctx.c_str(), "success: valid");
+
+  // Keys of three tenants
+  vector<string> keys;
+  for (int i = 0; i < 3; i++) {
+    fhe->KeyGen();
+    fhe->RelinKeyGen();
+    keys.push_back(fhe->get_relin_keys().save());
+  }
+
+  size_t budget = 2 * max(keys[0].size(), max(keys[1].size(), keys[2].size()));
+
+  // Budget holds two keys, without spill the oldest is dropped
+  {
+    KeyCache cache(budget);
+    vector<uint64_t> ids(3);
+    for (int i = 0; i < 3; i++) {
+      cache.load(fhe, key::relin_keys, bytes(keys[i]), keys[i].size(), false, make_seal_key, ids[i]);
+    }
+    EXPECT_EQ(cache.count(), 2);
+    key type;
+    EXPECT_EQ(cache.find(fhe, ids[0], make_seal_key, type), nullptr);
+    EXPECT_NE(cache.find(fhe, ids[2], make_seal_key, type), nullptr);
+  }
+
+  // With spill, the oldest is mapped back from disk
+  char dir[] = "/tmp/fhel_keysXXXXXX";
+  ASSERT_NE(mkdtemp(dir), nullptr);
+  {
+    KeyCache cache(budget, dir);
+    vector<uint64_t> ids(3);
+    vector<shared_ptr<AKey>> loaded(3);
+    for (int i = 0; i < 3; i++) {
+      loaded[i] = cache.load(fhe, key::relin_keys, bytes(keys[i]), keys[i].size(), false, make_seal_key, ids[i]);
+    }
+    EXPECT_EQ(cache.count(), 3);
+    EXPECT_LE(cache.memory_size(), budget);
+
+    // Spilled keys are only readable by the owner
+    char path[64];
+    snprintf(path, sizeof(path), "%s/%016llx.key", dir, static_cast<unsigned long long>(ids[0]));
+    struct stat st;
+    ASSERT_EQ(stat(path, &st), 0);
+    EXPECT_EQ(st.st_mode & 0777, 0600);
+
+    key type = key::no_key;
+    shared_ptr<AKey> spilled = cache.find(fhe, ids[0], make_seal_key, type);
+    ASSERT_NE(spilled, nullptr);
+    EXPECT_EQ(type, key::relin_keys);
+    EXPECT_NE(spilled.get(), loaded[0].get());
+    EXPECT_EQ(spilled->data(), loaded[0]->data());
+  }
+  rmdir(dir);
+}
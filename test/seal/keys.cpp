@@ -2,6 +2,7 @@
 #include <aseal.h>       /* Microsoft SEAL */
 #include <map>
 #include <cstdint>
+#include <thread>
 
 TEST(Keys, Data)
 {
@@ -44,4 +45,50 @@ TEST(Keys, Data)
         cout << dec << "relin_key_data[" << i << "] = " << hex << relin_key_data[i] << endl;
     }
 
+    // Sizes are known without extracting the data
+    EXPECT_EQ(pk.data_size(), pk_data.size());
+    EXPECT_EQ(sk.data_size(), sk_data.size());
+    EXPECT_EQ(relin_key.data_size(), relin_key_data.size());
+}
+
+TEST(Keys, Fingerprint)
+{
+    Aseal* fhe = new Aseal();
+    EXPECT_EQ(fhe->ContextGen(scheme::bfv, 8192, 20, 0, 128), "success: valid");
+    fhe->KeyGen();
+    fhe->RelinKeyGen();
+
+    AsealPublicKey pk = _to_public_key(fhe->get_public_key());
+    AsealSecretKey sk = _to_secret_key(fhe->get_secret_key());
+    AsealRelinKey rk = _to_relin_keys(fhe->get_relin_keys());
+    EXPECT_NE(pk.fingerprint(), sk.fingerprint());
+    EXPECT_NE(pk.fingerprint(), rk.fingerprint());
+
+    // Independent of the serialization, e.g. compression
+    string rk_saved = rk.save();
+    AsealRelinKey rk_loaded;
+    rk_loaded.load(fhe, rk_saved);
+    EXPECT_EQ(rk_loaded.fingerprint(), rk.fingerprint());
+
+    // A new key pair has a new fingerprint
+    fhe->KeyGen();
+    AsealPublicKey pk_new = _to_public_key(fhe->get_public_key());
+    EXPECT_NE(pk_new.fingerprint(), pk.fingerprint());
+
+    // Concurrent first calls agree
+    AsealRelinKey rk_shared(rk);
+    vector<uint64_t> fps(4);
+    vector<thread> threads;
+    for (size_t i = 0; i < fps.size(); i++)
+    {
+        threads.emplace_back([&, i] { fps[i] = rk_shared.fingerprint(); });
+    }
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+    for (uint64_t fp : fps)
+    {
+        EXPECT_EQ(fp, rk.fingerprint());
+    }
 }
@@ -324,3 +324,198 @@ TEST(Multiply, PiXSquared) {
     EXPECT_NEAR(expect, decode_res[i], 0.0000001);
   }
 }
+
+TEST(Multiply, EvalPolynomial) {
+  Aseal* fhe = new Aseal();
+  string ctx = fhe->ContextGen(scheme::ckks, 16384, pow(2.0, 40), -1, -1, {60, 40, 40, 40, 40, 40, 60});
+  EXPECT_STREQ(ctx.c_str(), "success: valid");
+
+  fhe->KeyGen();
+  fhe->RelinKeyGen();
+
+  vector<double> x;
+  for (int i = 0; i < 64; i++) {
+    x.push_back(-1.0 + i / 32.0);
+  }
+  AsealPlaintext pt_x;
+  fhe->encode_double(x, pt_x);
+  AsealCiphertext ct_x;
+  fhe->encrypt(pt_x, ct_x);
+
+  // Degree 7 and 15, with zero and constant-only blocks
+  vector<vector<double>> polynomials = {
+    {0.5, 0.197, 0.0, -0.004, 0.0, 0.0, 0.0, 0.25},
+    {1.0, -0.5, 0.25, 0.0, 0.0, 0.0, 0.0, 0.0, 0.75, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, -0.125},
+  };
+  for (const auto& coeffs : polynomials) {
+    AsealCiphertext ct_res;
+    fhe->eval_polynomial(ct_x, coeffs.data(), coeffs.size(), ct_res);
+
+    AsealPlaintext pt_res;
+    fhe->decrypt(ct_res, pt_res);
+    vector<double> result;
+    fhe->decode_double(pt_res, result);
+
+    for (size_t i = 0; i < x.size(); i++) {
+      double expect = 0.0;
+      for (size_t j = coeffs.size(); j-- > 0;) {
+        expect = expect * x[i] + coeffs[j];
+      }
+      EXPECT_NEAR(result[i], expect, 1e-3);
+    }
+  }
+
+  // Only evaluated with CKKS, and needs a non-constant polynomial
+  vector<double> constant = {1.0, 0.0};
+  AsealCiphertext ct_res;
+  ASSERT_THROW(fhe->eval_polynomial(ct_x, constant.data(), constant.size(), ct_res), invalid_argument);
+}
+
+TEST(Multiply, EvalPolynomialSmallCoefficients) {
+  Aseal* fhe = new Aseal();
+  string ctx = fhe->ContextGen(scheme::ckks, 16384, pow(2.0, 40), -1, -1, {60, 40, 40, 40, 40, 40, 40, 40, 60});
+  EXPECT_STREQ(ctx.c_str(), "success: valid");
+
+  fhe->KeyGen();
+  fhe->RelinKeyGen();
+
+  vector<double> x;
+  for (int i = 0; i < 64; i++) {
+    x.push_back(-1.0 + i / 32.0);
+  }
+  AsealPlaintext pt_x;
+  fhe->encode_double(x, pt_x);
+  AsealCiphertext ct_x;
+  fhe->encrypt(pt_x, ct_x);
+
+  // Taylor series of exp to degree 31, from 1/16! the terms round to zero at 40 bits
+  vector<double> coeffs(32);
+  coeffs[0] = 1.0;
+  for (size_t i = 1; i < coeffs.size(); i++) {
+    coeffs[i] = coeffs[i - 1] / i;
+  }
+  AsealCiphertext ct_res;
+  fhe->eval_polynomial(ct_x, coeffs.data(), coeffs.size(), ct_res);
+
+  AsealPlaintext pt_res;
+  fhe->decrypt(ct_res, pt_res);
+  vector<double> result;
+  fhe->decode_double(pt_res, result);
+  for (size_t i = 0; i < x.size(); i++) {
+    EXPECT_NEAR(result[i], exp(x[i]), 1e-3);
+  }
+}
+
+TEST(Multiply, Many) {
+  // Five BGV ciphertexts: three levels of products instead of four
+  Aseal* fhe = new Aseal();
+  string ctx = fhe->ContextGen(scheme::bgv, 8192, 20, -1, 128);
+  EXPECT_STREQ(ctx.c_str(), "success: valid");
+  fhe->KeyGen();
+  fhe->RelinKeyGen();
+
+  vector<AsealCiphertext> cts(5);
+  vector<ACiphertext*> ptrs;
+  for (uint64_t i = 0; i < cts.size(); i++) {
+    vector<uint64_t> x = {i + 1, 2};
+    AsealPlaintext pt;
+    fhe->encode_int(x, pt);
+    fhe->encrypt(pt, cts[i]);
+    ptrs.push_back(&cts[i]);
+  }
+
+  AsealCiphertext ct_res;
+  fhe->multiply_many(ptrs.data(), ptrs.size(), ct_res);
+  EXPECT_EQ(ct_res.size(), 2);
+  EXPECT_GT(fhe->invariant_noise_budget(ct_res), 0);
+
+  AsealPlaintext pt_res;
+  fhe->decrypt(ct_res, pt_res);
+  vector<uint64_t> result;
+  fhe->decode_int(pt_res, result);
+  EXPECT_EQ(result[0], 120);
+  EXPECT_EQ(result[1], 32);
+
+  // Four CKKS ciphertexts fit in two levels
+  ctx = fhe->ContextGen(scheme::ckks, 8192, pow(2.0, 40), -1, -1, {60, 40, 40, 60});
+  EXPECT_STREQ(ctx.c_str(), "success: valid");
+  fhe->KeyGen();
+  fhe->RelinKeyGen();
+
+  vector<double> values = {1.1, 2.2, 0.5, 3.0};
+  vector<AsealCiphertext> cts_double(values.size());
+  ptrs.clear();
+  for (size_t i = 0; i < values.size(); i++) {
+    vector<double> x = {values[i], -values[i]};
+    AsealPlaintext pt;
+    fhe->encode_double(x, pt);
+    fhe->encrypt(pt, cts_double[i]);
+    ptrs.push_back(&cts_double[i]);
+  }
+
+  // The product may be stored in one of the inputs
+  fhe->multiply_many(ptrs.data(), ptrs.size(), cts_double[0]);
+
+  AsealPlaintext pt_double;
+  fhe->decrypt(cts_double[0], pt_double);
+  vector<double> result_double;
+  fhe->decode_double(pt_double, result_double);
+  EXPECT_NEAR(result_double[0], 3.63, 1e-4);
+  EXPECT_NEAR(result_double[1], 3.63, 1e-4);
+}
+
+TEST(Multiply, Levels) {
+  // Three primes of data: levels 0, 1 and 2
+  Aseal* fhe = new Aseal();
+  string ctx = fhe->ContextGen(scheme::ckks, 8192, pow(2.0, 40), -1, -1, {60, 40, 40, 60});
+  EXPECT_STREQ(ctx.c_str(), "success: valid");
+  fhe->KeyGen();
+  fhe->RelinKeyGen();
+
+  vector<level_cost> costs = fhe->level_costs();
+  ASSERT_EQ(costs.size(), 3);
+  for (size_t i = 0; i < costs.size(); i++) {
+    EXPECT_EQ(costs[i].primes, 3 - i);
+  }
+  EXPECT_DOUBLE_EQ(costs[0].multiply, 1.0);
+  EXPECT_DOUBLE_EQ(costs[0].key_switch, 1.0);
+  EXPECT_NEAR(costs[2].log2_modulus, 60.0, 0.1);
+  EXPECT_LT(costs[2].key_switch, costs[2].multiply);
+
+  vector<double> x = {1.5, -2.0};
+  AsealPlaintext pt_x;
+  fhe->encode_double(x, pt_x);
+  AsealCiphertext ct_x;
+  fhe->encrypt(pt_x, ct_x);
+  EXPECT_EQ(fhe->level(ct_x), 0);
+  EXPECT_EQ(fhe->chain_index(ct_x), 2);
+  EXPECT_EQ(fhe->coeff_modulus_count(ct_x), 3);
+
+  // Rescaling drops a level and divides the scale
+  AsealCiphertext ct_sq;
+  fhe->square(ct_x, ct_sq);
+  fhe->relinearize(ct_sq);
+  double scale = ct_sq.scale();
+  fhe->rescale_to_next(ct_sq);
+  EXPECT_EQ(fhe->level(ct_sq), 1);
+  EXPECT_LT(ct_sq.scale(), scale);
+
+  // Mod switching keeps the scale
+  scale = ct_x.scale();
+  fhe->mod_switch_to_level(ct_x, 2);
+  EXPECT_EQ(fhe->level(ct_x), 2);
+  EXPECT_EQ(fhe->chain_index(ct_x), 0);
+  EXPECT_EQ(fhe->coeff_modulus_count(ct_x), 1);
+  EXPECT_DOUBLE_EQ(ct_x.scale(), scale);
+
+  AsealPlaintext pt_res;
+  fhe->decrypt(ct_x, pt_res);
+  vector<double> result;
+  fhe->decode_double(pt_res, result);
+  EXPECT_NEAR(result[0], 1.5, 1e-4);
+  EXPECT_NEAR(result[1], -2.0, 1e-4);
+
+  // Levels cannot be added back, nor go past the chain
+  EXPECT_THROW(fhe->mod_switch_to_level(ct_x, 1), invalid_argument);
+  EXPECT_THROW(fhe->mod_switch_to_level(ct_sq, 3), invalid_argument);
+}
@@ -0,0 +1,127 @@
+#include <gtest/gtest.h> // NOLINT
+#include <aseal.h>       /* Microsoft SEAL */
+#include <packing.h>     /* Batch Packing */
+
+TEST(Packing, Layout) {
+  Aseal* fhe = new Aseal();
+  string ctx = fhe->ContextGen(scheme::bfv, 8192, 20, 0, 128);
+  EXPECT_STREQ(ctx.c_str(), "success: valid");
+
+  // Records are aligned to a power of two
+  Packing packing(fhe, 12);
+  EXPECT_EQ(packing.record_size(), 12);
+  EXPECT_EQ(packing.stride(), 16);
+  EXPECT_EQ(packing.capacity(), 8192 / 16);
+  EXPECT_EQ(packing.offset(3), 48);
+
+  // Records cannot exceed the number of slots
+  ASSERT_THROW(Packing(fhe, 8193), invalid_argument);
+
+  // Number of records cannot exceed the capacity
+  vector<uint64_t> records((packing.capacity() + 1) * 12, 1ULL);
+  AsealPlaintext pt;
+  ASSERT_THROW(packing.encode_int(records.data(), packing.capacity() + 1, pt), invalid_argument);
+}
+
+TEST(Packing, IntegerRecords) {
+  for (const auto& scheme : {scheme::bgv, scheme::bfv}) {
+    Aseal* fhe = new Aseal();
+    string ctx = fhe->ContextGen(scheme, 8192, 20, 0, 128);
+    EXPECT_STREQ(ctx.c_str(), "success: valid");
+    fhe->KeyGen();
+
+    const size_t record_size = 12, count = 100;
+    Packing packing(fhe, record_size);
+
+    vector<uint64_t> records(count * record_size);
+    for (size_t i = 0; i < records.size(); i++) {
+      records[i] = i % 1000;
+    }
+
+    AsealPlaintext pt;
+    packing.encode_int(records.data(), count, pt);
+    AsealCiphertext ct;
+    fhe->encrypt(pt, ct);
+
+    // Same operand is applied to every record, with a single ciphertext operation
+    vector<uint64_t> operand(record_size);
+    for (size_t i = 0; i < record_size; i++) {
+      operand[i] = i;
+    }
+    AsealPlaintext pt_op;
+    packing.encode_replicated_int(operand.data(), pt_op);
+    AsealCiphertext ct_res;
+    fhe->add(ct, pt_op, ct_res);
+
+    AsealPlaintext pt_res;
+    fhe->decrypt(ct_res, pt_res);
+    vector<uint64_t> result(count * record_size);
+    packing.decode_int(pt_res, result.data(), count);
+
+    for (size_t i = 0; i < records.size(); i++) {
+      EXPECT_EQ(result[i], records[i] + operand[i % record_size]);
+    }
+  }
+}
+
+TEST(Packing, SelectRecord) {
+  Aseal* fhe = new Aseal();
+  string ctx = fhe->ContextGen(scheme::bfv, 8192, 20, 0, 128);
+  EXPECT_STREQ(ctx.c_str(), "success: valid");
+  fhe->KeyGen();
+
+  const size_t record_size = 8, count = 4;
+  Packing packing(fhe, record_size);
+
+  vector<uint64_t> records(count * record_size, 5ULL);
+  AsealPlaintext pt, mask;
+  packing.encode_int(records.data(), count, pt);
+  packing.encode_mask(2, mask);
+
+  AsealCiphertext ct, ct_res;
+  fhe->encrypt(pt, ct);
+  fhe->multiply(ct, mask, ct_res);
+
+  AsealPlaintext pt_res;
+  fhe->decrypt(ct_res, pt_res);
+  vector<uint64_t> result(count * record_size);
+  packing.decode_int(pt_res, result.data(), count);
+
+  for (size_t i = 0; i < result.size(); i++) {
+    EXPECT_EQ(result[i], i / record_size == 2 ? 5ULL : 0ULL);
+  }
+}
+
+TEST(Packing, DoubleRecords) {
+  Aseal* fhe = new Aseal();
+  string ctx = fhe->ContextGen(scheme::ckks, 8192, pow(2.0, 40), 0, 128, {60, 40, 40, 60});
+  EXPECT_STREQ(ctx.c_str(), "success: valid");
+  fhe->KeyGen();
+
+  const size_t record_size = 8, count = 50;
+  Packing packing(fhe, record_size);
+  EXPECT_EQ(packing.capacity(), 4096 / 8);
+
+  vector<double> records(count * record_size);
+  for (size_t i = 0; i < records.size(); i++) {
+    records[i] = i * 0.25;
+  }
+
+  AsealPlaintext pt, pt_op;
+  packing.encode_double(records.data(), count, pt);
+  vector<double> operand(record_size, 1.5);
+  packing.encode_replicated_double(operand.data(), pt_op);
+
+  AsealCiphertext ct, ct_res;
+  fhe->encrypt(pt, ct);
+  fhe->add(ct, pt_op, ct_res);
+
+  AsealPlaintext pt_res;
+  fhe->decrypt(ct_res, pt_res);
+  vector<double> result(count * record_size);
+  packing.decode_double(pt_res, result.data(), count);
+
+  for (size_t i = 0; i < records.size(); i++) {
+    EXPECT_NEAR(result[i], records[i] + 1.5, 1e-5);
+  }
+}
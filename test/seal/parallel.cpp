@@ -0,0 +1,46 @@
+#include <gtest/gtest.h> // NOLINT
+#include <parallel.h>    /* parallel_for */
+#include <stdexcept>
+
+TEST(Parallel, ThreadPool) {
+  // Shared by every loop, started once per process
+  ThreadPool &pool = ThreadPool::instance();
+  EXPECT_EQ(&pool, &ThreadPool::instance());
+  EXPECT_LT(pool.size(), max(1u, thread::hardware_concurrency()));
+
+  vector<size_t> values(1000, 0);
+  parallel_for(values.size(), [&](size_t i) { values[i] = i; });
+  for (size_t i = 0; i < values.size(); i++) {
+    EXPECT_EQ(values[i], i);
+  }
+}
+
+TEST(Parallel, NestedLoops) {
+  // Concurrent callers and nested loops share the pool, without deadlock
+  atomic<size_t> total(0);
+  vector<thread> callers;
+  for (int c = 0; c < 4; c++) {
+    callers.emplace_back([&] {
+      for (int r = 0; r < 10; r++) {
+        parallel_for(8, [&](size_t) {
+          parallel_for(16, [&](size_t) { total++; });
+        });
+      }
+    });
+  }
+  for (auto &t : callers) {
+    t.join();
+  }
+  EXPECT_EQ(total, 4 * 10 * 8 * 16);
+}
+
+TEST(Parallel, Exception) {
+  ASSERT_THROW(parallel_for(100, [&](size_t i) {
+    if (i == 50) { throw invalid_argument("task failed"); }
+  }), invalid_argument);
+
+  // The pool is still usable after a failed loop
+  atomic<size_t> ran(0);
+  parallel_for(100, [&](size_t) { ran++; });
+  EXPECT_EQ(ran, 100);
+}
@@ -0,0 +1,185 @@
+#include <gtest/gtest.h> // NOLINT
+#include <aseal.h>       /* Microsoft SEAL */
+#include <packing.h>     /* Batch Packing */
+
+TEST(Rotate, Rows) {
+  Aseal* fhe = new Aseal();
+  string ctx = fhe->ContextGen(scheme::bfv, 8192, 20, 0, 128);
+  EXPECT_STREQ(ctx.c_str(), "success: valid");
+  fhe->KeyGen();
+
+  // Rotation requires Galois keys
+  AsealCiphertext ct_x, ct_res;
+  ASSERT_THROW(fhe->rotate(ct_x, 1, ct_res), logic_error);
+  fhe->GaloisKeyGen({1, -2});
+
+  vector<uint64_t> x(fhe->slot_count(), 0ULL);
+  for (uint64_t i = 0; i < 8; i++) {
+    x[i] = i + 1;
+  }
+  fhe->encrypt_int(x.data(), x.size(), ct_x);
+
+  // Left by one slot
+  fhe->rotate(ct_x, 1, ct_res);
+  vector<uint64_t> result(fhe->slot_count());
+  fhe->decrypt_int(ct_res, result.data(), result.size());
+  EXPECT_EQ(result[0], 2ULL);
+  EXPECT_EQ(result[6], 8ULL);
+  EXPECT_EQ(result[7], 0ULL);
+
+  // Right by two slots, each row of slot_count() / 2 rotates independently
+  fhe->rotate(ct_x, -2, ct_res);
+  fhe->decrypt_int(ct_res, result.data(), result.size());
+  EXPECT_EQ(result[0], 0ULL);
+  EXPECT_EQ(result[2], 1ULL);
+  EXPECT_EQ(result[fhe->slot_count() / 2], 0ULL);
+}
+
+TEST(Rotate, Vector) {
+  Aseal* fhe = new Aseal();
+  string ctx = fhe->ContextGen(scheme::ckks, 8192, pow(2.0, 40), 0, 128, {60, 40, 40, 60});
+  EXPECT_STREQ(ctx.c_str(), "success: valid");
+  fhe->KeyGen();
+
+  // Default keys compose any rotation from powers of two
+  fhe->GaloisKeyGen();
+
+  vector<double> x(fhe->slot_count(), 0.0);
+  x[0] = 1.5;
+  x[3] = -2.5;
+  AsealCiphertext ct_x, ct_res;
+  fhe->encrypt_double(x.data(), x.size(), ct_x);
+
+  fhe->rotate(ct_x, 3, ct_res);
+  vector<double> result(fhe->slot_count());
+  fhe->decrypt_double(ct_res, result.data(), result.size());
+  EXPECT_NEAR(result[0], -2.5, 1e-5);
+  EXPECT_NEAR(result[fhe->slot_count() - 3], 1.5, 1e-5);
+}
+
+TEST(Matvec, IntegerMatrix) {
+  for (const auto& scheme : {scheme::bgv, scheme::bfv}) {
+    Aseal* fhe = new Aseal();
+    string ctx = fhe->ContextGen(scheme, 8192, 20, 0, 128);
+    EXPECT_STREQ(ctx.c_str(), "success: valid");
+    fhe->KeyGen();
+
+    // Non-square matrices are padded to a power of two
+    const size_t rows = 3, cols = 5;
+    vector<uint64_t> m(rows * cols);
+    for (size_t i = 0; i < m.size(); i++) {
+      m[i] = i + 1;
+    }
+    AsealPlainMatrix mat;
+    fhe->encode_matrix_int(m.data(), rows, cols, mat);
+    EXPECT_EQ(mat.dim(), 8);
+
+    // Only the rotations used by the product are needed
+    fhe->GaloisKeyGen(mat.rotation_steps());
+
+    // Vector is replicated with period dim()
+    vector<uint64_t> v = {1, 2, 3, 4, 5, 0, 0, 0};
+    Packing packing(fhe, mat.dim());
+    AsealPlaintext pt_v;
+    packing.encode_replicated_int(v.data(), pt_v);
+    AsealCiphertext ct_v, ct_res;
+    fhe->encrypt(pt_v, ct_v);
+
+    fhe->matvec_plain(mat, ct_v, ct_res);
+
+    vector<uint64_t> result(fhe->slot_count());
+    fhe->decrypt_int(ct_res, result.data(), result.size());
+    for (size_t r = 0; r < rows; r++) {
+      uint64_t expected = 0;
+      for (size_t c = 0; c < cols; c++) {
+        expected += m[r * cols + c] * v[c];
+      }
+      EXPECT_EQ(result[r], expected);
+      // Product keeps the replicated layout
+      EXPECT_EQ(result[r + 4 * mat.dim()], expected);
+    }
+    for (size_t r = rows; r < mat.dim(); r++) {
+      EXPECT_EQ(result[r], 0ULL);
+    }
+  }
+}
+
+TEST(Matvec, DoubleMatrix) {
+  Aseal* fhe = new Aseal();
+  string ctx = fhe->ContextGen(scheme::ckks, 8192, pow(2.0, 40), 0, 128, {60, 40, 40, 60});
+  EXPECT_STREQ(ctx.c_str(), "success: valid");
+  fhe->KeyGen();
+
+  const size_t d = 16;
+  vector<double> m(d * d);
+  for (size_t r = 0; r < d; r++) {
+    for (size_t c = 0; c < d; c++) {
+      m[r * d + c] = (r == c) ? 2.0 : 0.01 * (r + c);
+    }
+  }
+  AsealPlainMatrix mat;
+  fhe->encode_matrix_double(m.data(), d, d, mat);
+  EXPECT_EQ(mat.dim(), d);
+  fhe->GaloisKeyGen(mat.rotation_steps());
+
+  vector<double> v(d);
+  for (size_t i = 0; i < d; i++) {
+    v[i] = 0.5 - 0.1 * i;
+  }
+  Packing packing(fhe, d);
+  AsealPlaintext pt_v;
+  packing.encode_replicated_double(v.data(), pt_v);
+  AsealCiphertext ct_v;
+  fhe->encrypt(pt_v, ct_v);
+
+  // Result may overwrite the input
+  fhe->matvec_plain(mat, ct_v, ct_v);
+
+  vector<double> result(fhe->slot_count());
+  fhe->decrypt_double(ct_v, result.data(), result.size());
+  for (size_t r = 0; r < d; r++) {
+    double expected = 0;
+    for (size_t c = 0; c < d; c++) {
+      expected += m[r * d + c] * v[c];
+    }
+    EXPECT_NEAR(result[r], expected, 1e-4);
+  }
+}
+
+TEST(Rotate, Batch) {
+  Aseal* fhe = new Aseal();
+  string ctx = fhe->ContextGen(scheme::bfv, 8192, 20, 0, 128);
+  EXPECT_STREQ(ctx.c_str(), "success: valid");
+  fhe->KeyGen();
+  fhe->GaloisKeyGen();
+
+  vector<uint64_t> x(fhe->slot_count(), 0ULL);
+  for (uint64_t i = 0; i < 32; i++) {
+    x[i] = i;
+  }
+  AsealCiphertext ct_x;
+  fhe->encrypt_int(x.data(), x.size(), ct_x);
+
+  // Every rotation matches a single rotate() call
+  vector<int> steps = {0, 1, 3, 7, 16, -5};
+  vector<AsealCiphertext> res(steps.size());
+  vector<ACiphertext*> res_ptrs;
+  for (auto &ct : res) {
+    res_ptrs.push_back(&ct);
+  }
+  fhe->rotate_batch(ct_x, steps.data(), steps.size(), res_ptrs.data());
+
+  size_t row = fhe->slot_count() / 2;
+  vector<uint64_t> result(fhe->slot_count());
+  for (size_t i = 0; i < steps.size(); i++) {
+    fhe->decrypt_int(res[i], result.data(), result.size());
+    for (size_t t = 0; t < 32; t++) {
+      size_t src = (t + row + steps[i]) % row;
+      EXPECT_EQ(result[t], x[src]);
+    }
+  }
+
+  // Results cannot overwrite the input
+  ACiphertext* aliased[] = {&ct_x};
+  ASSERT_THROW(fhe->rotate_batch(ct_x, steps.data(), 1, aliased), invalid_argument);
+}
@@ -0,0 +1,51 @@
+#include <gtest/gtest.h> // NOLINT
+#include <fhe_typed.h>   /* Typed interface */
+
+TEST(Typed, SealBackend) {
+  Fhe<SealBackend> fhe;
+  string ctx = fhe.backend().ContextGen(scheme::bfv, 4096, 20, -1, 128);
+  EXPECT_STREQ(ctx.c_str(), "success: valid");
+  fhe.backend().KeyGen();
+
+  uint64_t x[2] = {3ULL, 5ULL};
+  Fhe<SealBackend>::Plaintext pt_x;
+  fhe.encode_int(x, 2, pt_x);
+  Fhe<SealBackend>::Ciphertext ct_x, ct_res;
+  fhe.encrypt(pt_x, ct_x);
+
+  // (x + x) - x + x
+  fhe.add(ct_x, ct_x, ct_res);
+  fhe.subtract(ct_res, pt_x, ct_res);
+  fhe.add(ct_res, ct_x, ct_res);
+
+  Fhe<SealBackend>::Plaintext pt_res;
+  fhe.decrypt(ct_res, pt_res);
+  uint64_t result[2] = {0ULL};
+  EXPECT_EQ(fhe.decode_int(pt_res, result, 2), 2);
+  EXPECT_EQ(result[0], 6);
+  EXPECT_EQ(result[1], 10);
+}
+
+TEST(Typed, BackendTag) {
+  // Every constructor tags the backend
+  EXPECT_EQ(AsealCiphertext().backend_lib, backend::seal_backend);
+  EXPECT_EQ(AsealCiphertext(seal::Ciphertext()).backend_lib, backend::seal_backend);
+  EXPECT_EQ(AsealPlaintext().backend_lib, backend::seal_backend);
+  EXPECT_EQ(AsealPlaintext("1x^1 + 2").backend_lib, backend::seal_backend);
+
+  Aseal* fhe = new Aseal();
+  string ctx = fhe->ContextGen(scheme::bfv, 4096, 20, -1, 128);
+  EXPECT_STREQ(ctx.c_str(), "success: valid");
+  fhe->KeyGen();
+
+  AsealPlaintext pt_x("2");
+  AsealCiphertext ct_x, ct_res;
+  fhe->encrypt(pt_x, ct_x);
+
+  // Objects of another backend are rejected before casting
+  ct_x.backend_lib = backend::no_backend;
+  EXPECT_THROW(fhe->add(ct_x, ct_x, ct_res), invalid_argument);
+  pt_x.backend_lib = backend::no_backend;
+  EXPECT_THROW(fhe->encrypt(pt_x, ct_res), invalid_argument);
+  delete fhe;
+}